@@ -17,13 +17,16 @@
 
 #ifdef __cplusplus
 
+#include <boost/multiprecision/cpp_int.hpp>
 #include <boost/optional.hpp>
 #include "core/Solver.h"  // Solver, lbool, vec
 
 #include <functional>  // function
 #include <initializer_list>
+#include <atomic>
 #include <iterator>
 #include <memory>  // enable_shared_from_this, shared_ptr, unique_ptr
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <unordered_map>
@@ -81,6 +84,12 @@ class Operator;
 class LatticeOperator;
 class Array;
 class sat_iter;
+class SatLimiter;
+class Simulator;
+class TruthTable;
+class BddManager;
+class BddPool;
+class ZddManager;
 
 using id_t = uint32_t;
 
@@ -100,9 +109,19 @@ using lop_t = std::shared_ptr<LatticeOperator const>;
 using var2bx_t = std::unordered_map<var_t, bx_t>;
 using var2op_t = std::unordered_map<var_t, op_t>;
 using point_t = std::unordered_map<var_t, const_t>;
+using var2words_t = std::unordered_map<var_t, std::vector<uint64_t>>;
 
 using soln_t = std::pair<bool, boost::optional<point_t>>;
 
+/// Satisfiability of a solve that may stop at a limit
+enum class SatStatus : uint8_t {
+    UNSAT,
+    SAT,
+    UNKNOWN,
+};
+
+using limited_soln_t = std::pair<SatStatus, boost::optional<point_t>>;
+
 using array_t = std::unique_ptr<Array>;
 
 class Context {
@@ -114,17 +133,97 @@ public:
 
     var_t get_var(std::string name);
 
+    /// Return a new variable that is not registered by name.
+    ///
+    /// Anonymous variables only allocate an id.
+    /// They print as "<prefix>_<n>", where <n> counts per prefix.
+    var_t get_anon_var(std::string const &prefix = "a");
+
+    bool is_anon(id_t id) const;
+
+    /// Begin a scope for scratch variables.
+    void push_scope();
+
+    /// End the innermost scope, and reclaim the variables created in it.
+    ///
+    /// If there is no open scope, or any of those variables is still
+    /// referenced, nothing changes and the result is false.
+    /// In the second case, the caller may drop the references and retry.
+    bool pop_scope();
+
+    /// Return the number of open scopes.
+    size_t num_scopes() const;
+
 private:
+    // A run of anonymous variables with consecutive ids and the same prefix
+    struct AnonBlock {
+        id_t first;
+        uint32_t index;
+        std::string const *prefix;
+    };
+
     id_t id;
 
     std::unordered_map<std::string, var_t> vars;
-    std::unordered_map<id_t, std::string> id2name;
-    std::unordered_map<id_t, lit_t> id2lit;
+    std::vector<std::string const *> id2name;
+    std::vector<lit_t> id2lit;
+
+    std::unordered_map<std::string, uint32_t> anon_counts;
+    std::vector<AnonBlock> anon_blocks;
+
+    // First id of each open scope
+    std::vector<id_t> scopes;
 
     std::string get_name(id_t id) const;
     lit_t get_lit(id_t id) const;
 };
 
+/// Handle to stop solvers from another thread
+class SatInterrupt {
+    friend class SatLimiter;
+
+public:
+    SatInterrupt();
+
+    /// Stop every solve that uses this handle, until reset.
+    void interrupt();
+
+    void reset();
+
+    bool interrupted() const;
+
+private:
+    mutable std::mutex mutex;
+    bool flag;
+    std::vector<Glucose::Solver *> solvers;
+};
+
+/// Solver settings
+struct SatOptions {
+    /// Number of portfolio solvers, each on its own thread.
+    /// One means a single solver on the calling thread.
+    uint32_t nthreads;
+
+    /// If nonzero, use cube-and-conquer instead of a portfolio:
+    /// split into at most 2^cube_depth cubes, and solve them on
+    /// nthreads workers.
+    uint32_t cube_depth;
+
+    /// Conflicts allowed to each solver, or negative for no limit
+    int64_t conflict_limit;
+
+    /// Propagations allowed to each solver, or negative for no limit
+    int64_t propagation_limit;
+
+    /// Wall-clock seconds allowed, or zero for no limit
+    double time_limit;
+
+    /// Optional handle to stop the solve from another thread
+    std::shared_ptr<SatInterrupt> interrupt;
+
+    SatOptions();
+};
+
 class BoolExpr : public std::enable_shared_from_this<BoolExpr> {
     friend class Operator;
     friend class sat_iter;
@@ -180,9 +279,47 @@ public:
 
     soln_t sat() const;
 
+    /// Return a satisfying point, ignoring any limits in the options.
+    soln_t sat(SatOptions const &) const;
+
+    /// Return a satisfying point, or UNKNOWN if a limit stops the solve.
+    limited_soln_t sat_limited(SatOptions const &) const;
+
+    /// Return a satisfying point under a partial assignment.
+    ///
+    /// Known values are passed to the solver as assumptions,
+    /// and the returned point omits the assigned variables.
+    /// To sweep over many cofactors, use one AssumptionCache.
+    soln_t sat(point_t const &) const;
+
     bx_t to_nnf() const;
 
     bool equiv(bx_t const &) const;
+
+    /// Return true if two expressions are equivalent under a partial point.
+    bool equiv(bx_t const &, point_t const &) const;
+
+    /// Return whether two expressions are equivalent,
+    /// or none if a limit stops the solve.
+    boost::optional<bool> equiv_limited(bx_t const &,
+                                        SatOptions const &) const;
+
+    /// Return the number of satisfying points over the support.
+    ///
+    /// Counts exactly, with a DPLL counter over the Tseytin encoding.
+    /// Anonymous variables, like the auxiliaries of cardinality
+    /// encodings, are projected away.
+    boost::multiprecision::cpp_int count_sat() const;
+
+    /// Return an estimate of the number of satisfying points.
+    ///
+    /// With probability at least 1 - delta, the estimate is within a
+    /// factor of 1 + epsilon of the exact count.
+    /// Random XOR constraints split the space into cells,
+    /// and only a bounded number of solutions per cell are enumerated.
+    boost::multiprecision::cpp_int approx_count_sat(double epsilon = 0.8,
+                                                    double delta = 0.2,
+                                                    uint32_t seed = 1) const;
     std::unordered_set<var_t> support() const;
     uint32_t degree() const;
 
@@ -192,6 +329,13 @@ public:
     bx_t consensus(std::vector<var_t> const &) const;
     bx_t derivative(std::vector<var_t> const &) const;
 
+    /// Return the NPN canonical truth table of the function.
+    ///
+    /// The table is over the inputs the function depends on.
+    /// Return none if the expression contains more than 16 variables,
+    /// or an unknown constant.
+    boost::optional<TruthTable> npn_class() const;
+
 protected:
     virtual bx_t invert() const = 0;
     virtual std::ostream &op_lsh(std::ostream &) const = 0;
@@ -199,7 +343,7 @@ protected:
     virtual void dot_edge(std::ostream &) const = 0;
     virtual soln_t _sat() const = 0;
     virtual void insert_support_var(std::unordered_set<var_t> &) const = 0;
-    virtual bx_t find_subop(bool &, Context &, std::string const &, uint32_t &,
+    virtual bx_t find_subop(bool &, Context &, std::string const &,
                             var2op_t &) const = 0;
     virtual void sat_iter_init(sat_iter *const) const = 0;
 };
@@ -223,7 +367,7 @@ public:
 protected:
     void dot_edge(std::ostream &) const;
     void insert_support_var(std::unordered_set<var_t> &) const;
-    bx_t find_subop(bool &, Context &, std::string const &, uint32_t &,
+    bx_t find_subop(bool &, Context &, std::string const &,
                     var2op_t &) const;
 };
 
@@ -376,7 +520,7 @@ protected:
     void dot_edge(std::ostream &) const;
     soln_t _sat() const;
     void insert_support_var(std::unordered_set<var_t> &) const;
-    bx_t find_subop(bool &, Context &, std::string const &, uint32_t &,
+    bx_t find_subop(bool &, Context &, std::string const &,
                     var2op_t &) const;
     void sat_iter_init(sat_iter *const) const;
 
@@ -389,8 +533,8 @@ protected:
     op_t transform(std::function<bx_t(bx_t const &)>) const;
 
 private:
-    var_t to_con1(Context &, std::string const &, uint32_t &, var2op_t &) const;
-    op_t to_con2(Context &, std::string const &, uint32_t &, var2op_t &) const;
+    var_t to_con1(Context &, std::string const &, var2op_t &) const;
+    op_t to_con2(Context &, std::string const &, var2op_t &) const;
 };
 
 class NegativeOperator : public Operator {
@@ -693,6 +837,837 @@ private:
     std::vector<bx_t> items;
 };
 
+/// Flat clause database.
+///
+/// Literals are DIMACS-style nonzero integers: +v or -v for variable v,
+/// where variables are numbered from 1 to nvars.
+/// Clause i is lits[offsets[i]] up to (but not including) lits[offsets[i+1]].
+class Cnf {
+public:
+    uint32_t nvars;
+    std::vector<int32_t> lits;
+    std::vector<uint32_t> offsets;
+
+    Cnf();
+
+    int32_t new_var();
+    void add_clause(std::initializer_list<int32_t> const);
+    void add_clause(int32_t const *, int32_t const *);
+
+    size_t nclauses() const;
+
+    /// Add clauses [first, nclauses()) to a solver.
+    void load(Glucose::Solver &, size_t first = 0) const;
+};
+
+/// Tseytin encoder that writes directly into a Cnf.
+///
+/// Shared subexpressions are encoded once.
+class CnfEncoder {
+public:
+    Cnf cnf;
+
+    /// Variable for each CNF variable, or null for auxiliaries.
+    /// Index zero is unused.
+    std::vector<var_t> idx2var;
+
+    CnfEncoder();
+
+    /// Return a CNF literal that is equivalent to an expression.
+    int32_t encode(bx_t const &);
+
+    /// Add clauses that constrain an expression to be true.
+    void add(bx_t const &);
+
+    /// Return the solver's model of the visible variables.
+    point_t model(Glucose::Solver const &) const;
+
+    /// Return the model, limited to the first n CNF variables.
+    point_t model(Glucose::Solver const &, uint32_t n) const;
+
+    /// Return the model of the visible variables from a list of literals.
+    point_t model(std::vector<int32_t> const &lits) const;
+
+    /// Return a new CNF variable, optionally bound to a Variable.
+    int32_t new_var(var_t const & = nullptr);
+
+private:
+    std::unordered_map<BoolExpr const *, int32_t> memo;
+    std::vector<bx_t> memo_nodes;
+
+    // Dense map from variable id to CNF variable index, per context
+    std::vector<std::pair<Context const *, std::vector<int32_t>>> ctx2idx;
+    size_t last_ctx;
+
+    int32_t true_lit;
+
+    int32_t encode_lit(bx_t const &);
+    int32_t encode_op(Operator const *);
+    int32_t encode_or(std::vector<int32_t> const &);
+    int32_t encode_and(std::vector<int32_t> const &);
+    int32_t encode_xor(int32_t, int32_t);
+    int32_t encode_ite(int32_t, int32_t, int32_t);
+};
+
+/// Parallel portfolio of diversified solvers over the same clauses.
+///
+/// The solvers differ in random seed, initial activity, default phase,
+/// and how eagerly they restart.
+/// They run in rounds with growing conflict budgets,
+/// and exchange the units they learn between rounds.
+/// Longer learned clauses are not shared,
+/// because Glucose has no public way to read them.
+/// The first solver to finish wins, and interrupts the others.
+class Portfolio {
+public:
+    explicit Portfolio(uint32_t nthreads);
+
+    /// Give clauses, starting from the first, to every solver.
+    void load(Cnf const &, size_t first = 0);
+
+    bool solve();
+    bool solve(Glucose::vec<Glucose::Lit> const &);
+
+    /// Solve within the limits of some options,
+    /// and return l_Undef if they stop every solver.
+    Glucose::lbool solve_limited(Glucose::vec<Glucose::Lit> const &,
+                                 SatOptions const &);
+
+    /// Return the solver that produced the last answer.
+    Glucose::Solver const &winner() const;
+
+private:
+    std::vector<std::unique_ptr<Glucose::Solver>> solvers;
+    size_t win;
+
+    Glucose::lbool race(Glucose::vec<Glucose::Lit> const &, SatLimiter &);
+};
+
+/// Result of one cube in cube-and-conquer
+struct CubeStat {
+    enum Status {
+        UNSAT,
+        SAT,
+        /// Not solved, because another cube was SAT first,
+        /// or a limit stopped the solve
+        SKIPPED,
+    };
+
+    point_t cube;
+    Status status;
+    uint32_t worker;
+    uint64_t conflicts;
+    double seconds;
+};
+
+/// Solve with cube-and-conquer.
+///
+/// A lookahead splitter partitions the support into cubes,
+/// and a work-stealing pool solves them as assumptions on
+/// incremental solvers. The first SAT cube stops the others.
+/// Cubes that lookahead refutes are not listed in the stats.
+limited_soln_t cube_and_conquer(bx_t const &, SatOptions const &,
+                                std::vector<CubeStat> *stats = nullptr);
+
+/// Serve one remote cube-and-conquer coordinator on a connected socket.
+///
+/// Receive a CNF once, then solve cubes one at a time until told to stop.
+/// Return false if the connection sends a malformed message.
+bool serve_cubes(int fd);
+
+/// Listen on an address, and serve one coordinator.
+///
+/// An address with a '/' is a Unix socket path,
+/// and anything else is host:port for TCP.
+bool serve_cubes(std::string const &address);
+
+/// Solve with cube-and-conquer on worker processes.
+///
+/// The CNF goes to each worker once, in the binary CNF format,
+/// and then each worker gets one cube at a time.
+/// The cube of a lost worker goes to another one.
+/// If every worker is lost, the coordinator solves the remaining cubes,
+/// and its stats have a worker index equal to the number of workers.
+/// Only the cube depth of the options is used:
+/// the solver limits are not enforced, so callers must not set them.
+soln_t remote_sat(bx_t const &, std::vector<int> const &fds,
+                  SatOptions const &, std::vector<CubeStat> *stats = nullptr);
+
+/// Connect to workers by address, and solve with cube-and-conquer.
+soln_t remote_sat(bx_t const &, std::vector<std::string> const &addresses,
+                  SatOptions const &, std::vector<CubeStat> *stats = nullptr);
+
+/// Return whether each pair of expressions is equivalent.
+///
+/// All pairs share one encoding and one incremental solver,
+/// so logic common to several pairs is encoded once.
+/// Each miter is checked under an assumption,
+/// and each proven equivalence is kept to help later pairs.
+std::vector<bool> equiv_many(std::vector<std::pair<bx_t, bx_t>> const &);
+
+/// Simulate an expression on many input points at once.
+///
+/// Bit j of word i of a variable's pattern is its value in point 64 * i + j,
+/// and the same bit of the result is the expression's value in that point.
+/// Return none if a variable in the support has no pattern,
+/// if those patterns differ in length,
+/// or if the expression contains an unknown constant.
+boost::optional<std::vector<uint64_t>> simulate(bx_t const &,
+                                                var2words_t const &);
+
+/// Expression compiled for repeated evaluation.
+///
+/// The nodes are a flat, topologically sorted program,
+/// and the variables have dense indices in inputs() order.
+/// A point is a bit vector: bit i % 64 of word i / 64 is input i.
+/// Evaluation does not allocate, so one object is not safe to share
+/// between threads.
+class CompiledExpr {
+public:
+    explicit CompiledExpr(bx_t const &);
+    CompiledExpr(CompiledExpr &&);
+    ~CompiledExpr();
+
+    /// Return false if the expression contains an unknown constant.
+    /// Such an expression cannot be evaluated, and every value is zero.
+    bool okay() const;
+
+    std::vector<var_t> const &inputs() const;
+
+    /// Number of words in one point
+    size_t stride() const { return (inputs().size() + 63) / 64; }
+
+    /// Return the value at one point.
+    bool eval(uint64_t const *point);
+
+    /// Evaluate n points, stored stride() words apart,
+    /// and set bit j % 64 of results[j / 64] to the value at point j.
+    ///
+    /// Points are evaluated 256 at a time, with word-wide operations.
+    void eval(uint64_t const *points, size_t n, uint64_t *results);
+
+private:
+    std::unique_ptr<Simulator> sim;
+    std::vector<uint8_t> vals;
+};
+
+/// Compile an expression, and check okay() before using the result.
+CompiledExpr compile(bx_t const &);
+
+/// Truth table of a function of at most 16 variables.
+///
+/// Bit m % 64 of word m / 64 is the value at minterm m,
+/// where bit i of m is the value of variable i.
+/// A table of fewer than six variables repeats itself across one word.
+/// The word loops have no dependencies between words,
+/// so the compiler vectorizes them for the target's SIMD width.
+class TruthTable {
+public:
+    static uint32_t const MAX_VARS = 16;
+
+    /// Constant function
+    explicit TruthTable(uint32_t nvars, bool val = false);
+
+    /// Function of an expression, where variable i is vars[i].
+    ///
+    /// The support must be a subset of vars,
+    /// and the expression must not contain an unknown constant.
+    TruthTable(bx_t const &, std::vector<var_t> const &vars);
+
+    /// Projection function of variable i
+    static TruthTable var(uint32_t nvars, uint32_t i);
+
+    uint32_t nvars() const { return n; }
+    std::vector<uint64_t> const &words() const { return w; }
+
+    bool get(uint64_t minterm) const;
+    void set(uint64_t minterm, bool val);
+
+    bool is_zero() const;
+    bool is_one() const;
+
+    /// Number of minterms where the function is one
+    uint64_t count() const;
+
+    TruthTable operator~() const;
+    TruthTable operator&(TruthTable const &) const;
+    TruthTable operator|(TruthTable const &) const;
+    TruthTable operator^(TruthTable const &) const;
+    TruthTable &operator&=(TruthTable const &);
+    TruthTable &operator|=(TruthTable const &);
+    TruthTable &operator^=(TruthTable const &);
+
+    bool operator==(TruthTable const &) const;
+    bool operator!=(TruthTable const &) const;
+    bool operator<(TruthTable const &) const;
+
+    /// Cofactor by variable i, which the result no longer depends on
+    TruthTable cofactor(uint32_t i, bool val) const;
+
+    TruthTable exists(uint32_t i) const;
+    TruthTable forall(uint32_t i) const;
+    TruthTable difference(uint32_t i) const;
+
+    bool depends_on(uint32_t i) const;
+    std::vector<uint32_t> support() const;
+
+    /// Negate input i
+    TruthTable flip(uint32_t i) const;
+
+    /// Exchange inputs i and j
+    TruthTable swap(uint32_t i, uint32_t j) const;
+
+    /// Return a sum of products over vars, from an irredundant cover.
+    bx_t to_bx(std::vector<var_t> const &vars) const;
+
+private:
+    uint32_t n;
+    std::vector<uint64_t> w;
+};
+
+/// Input negation, input permutation, and output negation.
+///
+/// Applied to f, it gives g(x) = out ^ f(y),
+/// where input k of f is y[k] = x[perm[k]] ^ (bit k of negs).
+struct NpnTransform {
+    std::vector<uint32_t> perm;
+    uint32_t negs;
+    bool out;
+};
+
+/// Return the NPN transform of a truth table.
+TruthTable npn_apply(TruthTable const &, NpnTransform const &);
+
+/// Return the NPN canonical form of a truth table,
+/// and the transform that maps the table onto it.
+///
+/// Up to six inputs, the form is exact: the least table over every
+/// transform, so two tables are NPN equivalent iff their forms are equal.
+/// Beyond six, the form is heuristic: output and input polarities and the
+/// input order are fixed by cofactor counts, and then improved greedily.
+/// Equivalent tables usually, but not always, get the same form.
+std::pair<TruthTable, NpnTransform> npn_canon(TruthTable const &);
+
+/// BDD variable reordering methods.
+///
+/// SIFT moves each variable, or group of variables, to the level
+/// where the BDDs have the fewest nodes.
+/// GROUP_SIFT also groups adjacent symmetric variables,
+/// and sifts again while the number of nodes goes down.
+enum class BddReorder { NONE, SIFT, GROUP_SIFT };
+
+/// Handle to a function in a BddManager.
+///
+/// A handle holds a reference to its root node,
+/// so the node and everything below it survive garbage collection.
+/// The manager must outlive its handles.
+class Bdd {
+    friend class BddManager;
+    friend class ZddManager;
+    friend class bdd_sat_iter;
+
+public:
+    Bdd();
+    Bdd(Bdd const &);
+    Bdd(Bdd &&);
+    ~Bdd();
+
+    Bdd &operator=(Bdd const &);
+    Bdd &operator=(Bdd &&);
+
+    BddManager *manager() const { return mgr; }
+
+    bool is_zero() const;
+    bool is_one() const;
+
+    Bdd operator~() const;
+    Bdd operator&(Bdd const &) const;
+    Bdd operator|(Bdd const &) const;
+    Bdd operator^(Bdd const &) const;
+
+    /// Functions are canonical, so equal functions have equal handles.
+    bool operator==(Bdd const &) const;
+    bool operator!=(Bdd const &) const;
+
+private:
+    BddManager *mgr;
+
+    // Node index << 1 | complement bit
+    uint32_t e;
+
+    Bdd(BddManager *mgr, uint32_t e);
+};
+
+/// Reduced ordered binary decision diagrams over the variables of a Context.
+///
+/// Edges have a complement bit, and the high edge of a node is never
+/// complemented, so each function has exactly one node and polarity.
+/// The nodes of each variable have their own unique table,
+/// and results of recursive operations go in a lossy computed table.
+/// Garbage collection runs when the number of nodes passes a limit,
+/// and frees the nodes that no handle reaches.
+///
+/// Variable i of the order is the variable with id 2 * i + 1 in its Context.
+/// Variables join the bottom of the order when they first appear,
+/// and to_bdd adds the support of an expression in id order.
+///
+/// With more than one thread, the operators, ite, and quantification
+/// split their recursion into tasks that idle threads steal.
+/// New nodes join the unique tables without locks,
+/// and the threads share a second lossy computed table.
+/// The manager itself is still used from one thread at a time.
+class BddManager {
+    friend class Bdd;
+    friend class BddPool;
+    friend class ZddManager;
+    friend class bdd_sat_iter;
+
+public:
+    explicit BddManager(Context &, uint32_t nthreads = 1);
+    ~BddManager();
+    BddManager(BddManager const &) = delete;
+    BddManager &operator=(BddManager const &) = delete;
+
+    Bdd zero();
+    Bdd one();
+    Bdd var(var_t const &);
+
+    Bdd ite(Bdd const &f, Bdd const &g, Bdd const &h);
+
+    /// Return the cofactor by a point.
+    Bdd restrict_(Bdd const &, point_t const &);
+
+    Bdd exists(Bdd const &, std::vector<var_t> const &);
+    Bdd forall(Bdd const &, std::vector<var_t> const &);
+
+    /// Return the number of satisfying points over the support.
+    boost::multiprecision::cpp_int sat_count(Bdd const &);
+
+    /// Return the support, in order from the top.
+    std::vector<var_t> support(Bdd const &);
+
+    /// Return the BDD of an expression with no unknown constants.
+    Bdd to_bdd(bx_t const &);
+
+    /// Return an expression with one ITE per node.
+    ///
+    /// Nodes with constant children become literals or simpler operators.
+    bx_t from_bdd(Bdd const &);
+
+    /// Return the variables, in order from the top.
+    std::vector<var_t> order() const;
+
+    /// Return the number of nodes of a function, including the terminal.
+    size_t size(Bdd const &) const;
+
+    /// Return the number of nodes in the unique tables.
+    size_t nodes() const { return nlive; }
+
+    /// Free every node that no handle reaches.
+    void gc();
+
+    /// Reorder the variables now.
+    void reorder(BddReorder);
+
+    /// Reorder at the start of an operation when the number of nodes
+    /// reaches a limit, which is then set to twice the reordered size.
+    void set_auto_reorder(BddReorder);
+
+    /// Keep variables next to each other, in their relative order,
+    /// when reordering. They move up to the level of the top one.
+    void group(std::vector<var_t> const &);
+
+    /// Move variables to the top of the order, in the given order.
+    ///
+    /// The other variables keep their relative order below them,
+    /// and groups are dissolved.
+    void set_order(std::vector<var_t> const &);
+
+private:
+    struct Node {
+        uint32_t var;
+        uint32_t lo;
+        uint32_t hi;
+        uint32_t next;
+        uint32_t refs;
+    };
+
+    // Workers of a pool insert into the chains with compare-and-swap
+    struct Subtable {
+        std::vector<std::atomic<uint32_t>> buckets;
+        size_t keys;
+    };
+
+    struct CacheEntry {
+        uint32_t op;
+        uint32_t f;
+        uint32_t g;
+        uint32_t h;
+        uint32_t r;
+    };
+
+    Context &ctx;
+
+    // Node 0 is the terminal, and freed nodes form a list through next.
+    std::vector<Node> table;
+    uint32_t free_list;
+    size_t nlive;
+    size_t gc_limit;
+
+    // By variable index
+    std::vector<Subtable> subtables;
+    std::vector<var_t> index2var;
+    std::vector<uint32_t> var2level;
+
+    // By level
+    std::vector<uint32_t> level2var;
+
+    std::vector<CacheEntry> cache;
+
+    BddReorder auto_reorder;
+    size_t reorder_limit;
+
+    // By variable index
+    std::vector<uint32_t> var2group;
+    uint32_t ngroups;
+
+    std::unique_ptr<BddPool> pool;
+
+    void ref(uint32_t e);
+    void deref(uint32_t e);
+    void maybe_gc();
+
+    uint32_t index(var_t const &);
+    uint32_t level(uint32_t e) const;
+    uint32_t cofactor(uint32_t e, uint32_t v, bool val) const;
+
+    uint32_t mk(uint32_t v, uint32_t lo, uint32_t hi);
+    void resize(Subtable &);
+    void link(uint32_t i);
+    void unlink(uint32_t i);
+
+    // Drop a reference, and free the nodes that no longer have any
+    void release(uint32_t e);
+
+    bool lookup(uint32_t op, uint32_t f, uint32_t g, uint32_t h, uint32_t &r);
+    void insert(uint32_t op, uint32_t f, uint32_t g, uint32_t h, uint32_t r);
+    void clear_cache();
+
+    // Run an operation of the computed table, on the pool if there is one
+    uint32_t apply(uint32_t op, uint32_t f, uint32_t g, uint32_t h);
+
+    uint32_t apply_and(uint32_t f, uint32_t g);
+    uint32_t apply_xor(uint32_t f, uint32_t g);
+    uint32_t apply_ite(uint32_t f, uint32_t g, uint32_t h);
+    uint32_t exists_cube(uint32_t f, uint32_t cube);
+    uint32_t restrict_cube(uint32_t f, uint32_t cube);
+
+    uint32_t cube(std::vector<var_t> const &);
+    uint32_t cube(point_t const &);
+
+    // Nodes below an edge, children first
+    std::vector<uint32_t> postorder(uint32_t e) const;
+
+    void swap_levels(uint32_t l);
+    void move_var(uint32_t from, uint32_t to);
+    bool symmetric(uint32_t l) const;
+
+    // Sizes of runs of levels that move together, from the top
+    std::vector<uint32_t> blocks(bool merge_symmetric) const;
+    void swap_blocks(std::vector<uint32_t> &, size_t j);
+    void sift(std::vector<uint32_t> &);
+};
+
+/// Return the variables of some expressions, in depth-first order.
+///
+/// Variables that meet in a small subexpression end up close together,
+/// which is a good BDD order for many circuits.
+std::vector<var_t> dfs_order(std::vector<bx_t> const &);
+
+/// Return the variables of some expressions, in an order placed by FORCE.
+///
+/// Each operator and its arguments form a hyperedge.
+/// Each round moves every node to the mean center of its hyperedges,
+/// and the order with the least total hyperedge span wins.
+std::vector<var_t> force_order(std::vector<bx_t> const &,
+                               uint32_t rounds = 20);
+
+/// A set of cubes in a ZddManager.
+///
+/// A cube is a set of literals, so a set of cubes is either
+/// a cover in disjunctive normal form, or the clauses of a CNF.
+class Zdd {
+    friend class ZddManager;
+
+public:
+    Zdd();
+    Zdd(Zdd const &);
+    Zdd(Zdd &&);
+    ~Zdd();
+
+    Zdd &operator=(Zdd const &);
+    Zdd &operator=(Zdd &&);
+
+    ZddManager *manager() const { return mgr; }
+
+    /// Return true if there are no cubes.
+    bool is_empty() const;
+
+    /// Return true if the only cube is the empty cube.
+    bool is_base() const;
+
+    /// Union
+    Zdd operator|(Zdd const &) const;
+
+    /// Intersection
+    Zdd operator&(Zdd const &) const;
+
+    /// Difference
+    Zdd operator-(Zdd const &) const;
+
+    /// Return the union of every pair of cubes,
+    /// except those with both x and ~x.
+    Zdd operator*(Zdd const &) const;
+
+    /// Sets are canonical, so equal sets have equal handles.
+    bool operator==(Zdd const &) const;
+    bool operator!=(Zdd const &) const;
+
+private:
+    ZddManager *mgr;
+    uint32_t e;
+
+    Zdd(ZddManager *mgr, uint32_t e);
+};
+
+/// Zero-suppressed decision diagrams of sets of cubes.
+///
+/// Literals x and ~x are ZDD variables 2 * i and 2 * i + 1,
+/// where x has id 2 * i + 1 in its Context, and the order is by index.
+/// A node whose high edge is the empty set is dropped,
+/// so a set of cubes only has nodes for the literals it uses.
+/// Nodes have reference counts and a unique table, results go in a lossy
+/// computed table, and garbage collection runs at the start of an operation
+/// when the number of nodes passes a limit.
+class ZddManager {
+    friend class Zdd;
+
+public:
+    explicit ZddManager(Context &);
+    ZddManager(ZddManager const &) = delete;
+    ZddManager &operator=(ZddManager const &) = delete;
+
+    Zdd empty();
+    Zdd base();
+
+    /// Return the set of one cube of literals.
+    /// A cube with both x and ~x is dropped.
+    Zdd cube(std::vector<bx_t> const &);
+
+    /// Return the cubes of the DNF of an expression with no unknown
+    /// constants. Each operator of its NNF is a union or a product,
+    /// with subsumed cubes removed.
+    Zdd dnf(bx_t const &);
+
+    /// Return the clauses of the CNF of an expression, like dnf.
+    Zdd cnf(bx_t const &);
+
+    /// Remove every cube that contains another cube.
+    Zdd minimal(Zdd const &);
+
+    /// Return an irredundant sum of products of some function
+    /// between lower and upper, by the Minato-Morreale algorithm.
+    Zdd isop(Bdd const &lower, Bdd const &upper);
+    Zdd isop(Bdd const &);
+
+    /// Return the BDD of a set of cubes, read as a DNF.
+    Bdd to_bdd(Zdd const &, BddManager &);
+
+    bx_t to_dnf(Zdd const &);
+    bx_t to_cnf(Zdd const &);
+
+    /// Return the number of cubes.
+    boost::multiprecision::cpp_int count(Zdd const &);
+
+    /// Return the number of nodes of a set, not including the terminals.
+    size_t size(Zdd const &) const;
+
+    /// Return the number of nodes in the unique table.
+    size_t nodes() const { return nlive; }
+
+    /// Free every node that no handle reaches.
+    void gc();
+
+private:
+    struct Node {
+        uint32_t var;
+        uint32_t lo;
+        uint32_t hi;
+        uint32_t next;
+        uint32_t refs;
+    };
+
+    struct CacheEntry {
+        uint32_t op;
+        uint32_t f;
+        uint32_t g;
+        uint32_t r;
+    };
+
+    Context &ctx;
+
+    // Nodes 0 and 1 are the terminals, and freed nodes form a list
+    std::vector<Node> table;
+    uint32_t free_list;
+    size_t nlive;
+    size_t gc_limit;
+
+    std::vector<uint32_t> buckets;
+    size_t keys;
+
+    // By variable index
+    std::vector<var_t> index2var;
+
+    std::vector<CacheEntry> cache;
+
+    void ref(uint32_t e);
+    void deref(uint32_t e);
+    void maybe_gc();
+
+    void index(var_t const &);
+    uint32_t top(uint32_t e) const;
+
+    uint32_t mk(uint32_t z, uint32_t lo, uint32_t hi);
+    void resize();
+
+    bool lookup(uint32_t op, uint32_t f, uint32_t g, uint32_t &r);
+    void insert(uint32_t op, uint32_t f, uint32_t g, uint32_t r);
+
+    uint32_t union_(uint32_t f, uint32_t g);
+    uint32_t intersect(uint32_t f, uint32_t g);
+    uint32_t diff(uint32_t f, uint32_t g);
+    uint32_t product(uint32_t f, uint32_t g);
+    uint32_t nonsupersets(uint32_t f, uint32_t g);
+    uint32_t minimal(uint32_t f);
+
+    // Return the cover and its BDD, memoized by interval
+    std::pair<uint32_t, uint32_t> isop(
+        BddManager &, uint32_t lower, uint32_t upper,
+        std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> &memo);
+
+    uint32_t two_level(bx_t const &, bool cnf);
+    bx_t to_two_level(uint32_t e, bool cnf);
+
+    // Nodes below an edge, children first
+    std::vector<uint32_t> postorder(uint32_t e) const;
+};
+
+/// Return a subset of constraints whose conjunction is unsatisfiable,
+/// or an empty vector if the conjunction is satisfiable.
+///
+/// All constraints share one encoding and one solver,
+/// and each is switched on by an activation literal.
+/// If minimal is true, shrink the core to a minimal unsatisfiable subset,
+/// where dropping any one constraint makes the rest satisfiable.
+std::vector<bx_t> unsat_core(std::vector<bx_t> const &, bool minimal = false);
+
+/// Incremental SAT solver.
+///
+/// A session owns one solver and one encoding.
+/// Constraints accumulate, and learned clauses carry over between solves.
+class SatSession {
+public:
+    SatSession(SatOptions const & = SatOptions());
+
+    /// Constrain an expression to be true.
+    void add(bx_t const &);
+
+    soln_t solve();
+
+    /// Solve with some literals held true for this call only.
+    soln_t solve(std::vector<lit_t> const &);
+
+private:
+    CnfEncoder encoder;
+    Portfolio solver;
+
+    // Number of clauses already given to the solver
+    size_t loaded;
+
+    void load();
+};
+
+/// Encoding of an expression for many queries under partial points.
+///
+/// The cache owns one encoding and one solver,
+/// so a sweep over many cofactors pays for one encoding,
+/// rather than one restrict_ per query.
+/// Known values are passed to the solver as assumptions,
+/// and unknown values fall back to restrict_.
+class AssumptionCache {
+public:
+    explicit AssumptionCache(bx_t const &);
+
+    /// Return a satisfying point under a partial assignment.
+    /// The returned point omits the assigned variables.
+    soln_t sat(point_t const &);
+
+    /// Return true if the expression is equivalent to another
+    /// under a partial assignment.
+    bool equiv(bx_t const &, point_t const &);
+
+private:
+    // Start over when this many other sides have been encoded
+    static size_t const MAX_OTHERS = 1 << 10;
+
+    // Simplified expression
+    bx_t f;
+
+    CnfEncoder encoder;
+    std::unique_ptr<Glucose::Solver> solver;
+    size_t loaded;
+
+    // CNF literal of the expression, and the CNF variables in its support
+    int32_t root;
+    uint32_t nvars;
+
+    // CNF literals of the other sides of equiv queries
+    std::unordered_map<bx_t, int32_t> others;
+
+    void reset();
+    void assume(point_t const &, Glucose::vec<Glucose::Lit> &);
+    bool solve(Glucose::vec<Glucose::Lit> const &);
+};
+
+/// Write a CNF in DIMACS format.
+void write_dimacs(std::ostream &, Cnf const &);
+
+/// Encode an expression, and write it in DIMACS format.
+/// Comment lines map CNF variables to variable names.
+void write_dimacs(std::ostream &, bx_t const &);
+
+/// Parse DIMACS text into a CNF, and return whether it is well formed.
+bool read_dimacs(char const *, char const *, Cnf &);
+
+/// Parse a DIMACS file into a CNF, and return whether it is well formed.
+bool read_dimacs(std::string const &, Cnf &);
+
+/// Write a CNF in a compact binary format.
+///
+/// After the magic "BXC1", the format has nvars, nclauses, and nlits,
+/// then the size of each clause, then the literals.
+/// Every field is a little-endian 32-bit integer.
+void write_binary_cnf(std::ostream &, Cnf const &);
+
+/// Parse the binary format into a CNF, and return whether it is well formed.
+bool read_binary_cnf(char const *, char const *, Cnf &);
+
+/// Return a CNF expression, where CNF variable v is named "<prefix>_<v>".
+bx_t cnf2bx(Context &, Cnf const &, std::string const & = "x");
+
+/// Return the number of models of a CNF over all of its variables.
+boost::multiprecision::cpp_int count_sat(Cnf const &);
+
 class dfs_iter : public std::iterator<std::input_iterator_tag, bx_t> {
 public:
     dfs_iter();
@@ -726,14 +1701,22 @@ public:
     sat_iter();
     sat_iter(bx_t const &);
 
+    /// Iterate through cubes that cover the solutions projected onto vars.
+    ///
+    /// Each model is lifted to an irredundant cube before it is blocked,
+    /// so don't-care inputs do not multiply the results.
+    /// Cubes may overlap.
+    /// Auxiliary variables keep their model values while lifting,
+    /// so an input that one of them depends on may stay in the cube.
+    sat_iter(bx_t const &, std::vector<var_t> const &);
+
     bool operator==(sat_iter const &) const;
     bool operator!=(sat_iter const &) const;
     point_t const &operator*() const;
     sat_iter const &operator++();
 
 private:
-    Context ctx;
-    std::unordered_map<uint32_t, var_t> idx2var;
+    CnfEncoder encoder;
 
     Glucose::Solver solver;
 
@@ -742,7 +1725,16 @@ private:
 
     bool one_soln;
 
+    // Projected enumeration: the lifter holds the encoding without the
+    // root asserted, and proves that a cube implies the function.
+    bool project;
+    Glucose::Solver lifter;
+    int32_t root;
+    std::vector<int32_t> proj;
+    std::vector<int32_t> fixed;
+
     void get_soln();
+    void get_cube();
 };
 
 class space_iter
@@ -829,6 +1821,36 @@ private:
     bx_t cf;
 };
 
+class bdd_sat_iter : public std::iterator<std::input_iterator_tag, point_t> {
+public:
+    bdd_sat_iter();
+
+    /// Iterate through the satisfying points over the support.
+    bdd_sat_iter(Bdd const &);
+
+    bool operator==(bdd_sat_iter const &) const;
+    bool operator!=(bdd_sat_iter const &) const;
+    point_t const &operator*() const;
+    bdd_sat_iter const &operator++();
+
+private:
+    Bdd f;
+    std::vector<var_t> vars;
+    std::vector<uint32_t> indices;
+
+    // Function below each decision, and the value taken.
+    // The handles keep the functions alive when the order changes.
+    std::vector<Bdd> edges;
+    std::vector<bool> vals;
+
+    bool done;
+    point_t point;
+
+    Bdd cofactor(size_t depth, bool val) const;
+    void descend(size_t depth);
+    void get_point();
+};
+
 /// Return Boolean zero.
 zero_t zero();
 
@@ -876,6 +1898,49 @@ bx_t onehot(std::vector<bx_t> const &);
 bx_t onehot(std::vector<bx_t> const &&);
 bx_t onehot(std::initializer_list<bx_t> const);
 
+/// At-most-one constraint encodings
+enum class AMOEncoding { PAIRWISE, SEQCOUNTER, COMMANDER, PRODUCT };
+
+/// Cardinality constraint encodings
+enum class CardEncoding { SEQCOUNTER, TOTALIZER, SORTNET };
+
+// Cardinality constraints return a CNF that is equisatisfiable with the
+// constraint. Auxiliary variables are anonymous variables in the context.
+bx_t at_most_one(Context &, std::vector<bx_t> const &,
+                 AMOEncoding = AMOEncoding::SEQCOUNTER,
+                 std::string const & = "a");
+bx_t exactly_one(Context &, std::vector<bx_t> const &,
+                 AMOEncoding = AMOEncoding::SEQCOUNTER,
+                 std::string const & = "a");
+bx_t at_most_k(Context &, std::vector<bx_t> const &, size_t,
+               CardEncoding = CardEncoding::TOTALIZER,
+               std::string const & = "a");
+bx_t at_least_k(Context &, std::vector<bx_t> const &, size_t,
+                CardEncoding = CardEncoding::TOTALIZER,
+                std::string const & = "a");
+bx_t exactly_k(Context &, std::vector<bx_t> const &, size_t,
+               CardEncoding = CardEncoding::TOTALIZER,
+               std::string const & = "a");
+
+/// Pseudo-Boolean constraint encodings
+enum class PBEncoding { AUTO, BDD, ADDER, GTE };
+
+// Pseudo-Boolean constraints compare sum(w[i] * x[i]) to k.
+// Like cardinality constraints, they return an equisatisfiable CNF.
+// They return none if the absolute weights sum to more than 2^61.
+boost::optional<bx_t> pb_leq(Context &, std::vector<bx_t> const &,
+                             std::vector<int64_t> const &, int64_t,
+                             PBEncoding = PBEncoding::AUTO,
+                             std::string const & = "a");
+boost::optional<bx_t> pb_geq(Context &, std::vector<bx_t> const &,
+                             std::vector<int64_t> const &, int64_t,
+                             PBEncoding = PBEncoding::AUTO,
+                             std::string const & = "a");
+boost::optional<bx_t> pb_eq(Context &, std::vector<bx_t> const &,
+                            std::vector<int64_t> const &, int64_t,
+                            PBEncoding = PBEncoding::AUTO,
+                            std::string const & = "a");
+
 bx_t nor_s(std::vector<bx_t> const &);
 bx_t nor_s(std::vector<bx_t> const &&);
 bx_t nor_s(std::initializer_list<bx_t> const);
@@ -937,6 +2002,7 @@ array_t operator*(size_t, Array const &);
 extern "C" {
 
 typedef char const *const STRING;
+typedef char const *const *const STRINGS;
 typedef void *const CONTEXT;
 typedef void const *const BX;
 typedef void const *const LIT;
@@ -945,12 +2011,23 @@ typedef void *const ARRAY_PAIR;
 typedef void const *const *const BXS;
 typedef void const *const *const VARS;
 typedef void const *const *const CONSTS;
+typedef int64_t const *const WEIGHTS;
+typedef uint64_t const *const PATTERNS;
 typedef void *const VEC;
 typedef void *const VARSET;
 typedef void *const POINT;
 typedef void *const SOLN;
 typedef void *const DFS_ITER;
 typedef void *const SAT_ITER;
+typedef void *const SAT_SESSION;
+typedef void *const ASSUMPTION_CACHE;
+typedef void *const SAT_INTERRUPT;
+typedef void *const COMPILED_EXPR;
+typedef void *const BDD_MANAGER;
+typedef void *const BDD;
+typedef void *const BDD_SAT_ITER;
+typedef void *const ZDD_MANAGER;
+typedef void *const ZDD;
 typedef void *const POINTS_ITER;
 typedef void *const TERMS_ITER;
 typedef void *const DOM_ITER;
@@ -959,6 +2036,9 @@ typedef void *const CF_ITER;
 DllExport CONTEXT boolexpr_Context_new(void);
 DllExport void boolexpr_Context_del(CONTEXT);
 DllExport BX boolexpr_Context_get_var(CONTEXT, STRING);
+DllExport void boolexpr_Context_push_scope(CONTEXT);
+DllExport bool boolexpr_Context_pop_scope(CONTEXT);
+DllExport size_t boolexpr_Context_num_scopes(CONTEXT);
 
 DllExport void boolexpr_String_del(STRING);
 
@@ -980,14 +2060,106 @@ DllExport BX boolexpr_Point_val(POINT);
 
 DllExport void boolexpr_Soln_del(SOLN);
 DllExport bool boolexpr_Soln_first(SOLN);
+DllExport uint8_t boolexpr_Soln_status(SOLN);
 DllExport POINT boolexpr_Soln_second(SOLN);
 
+DllExport SAT_INTERRUPT boolexpr_SatInterrupt_new(void);
+DllExport void boolexpr_SatInterrupt_del(SAT_INTERRUPT);
+DllExport void boolexpr_SatInterrupt_interrupt(SAT_INTERRUPT);
+DllExport void boolexpr_SatInterrupt_reset(SAT_INTERRUPT);
+
+DllExport COMPILED_EXPR boolexpr_CompiledExpr_new(BX);
+DllExport void boolexpr_CompiledExpr_del(COMPILED_EXPR);
+DllExport VEC boolexpr_CompiledExpr_inputs(COMPILED_EXPR);
+DllExport bool boolexpr_CompiledExpr_eval(COMPILED_EXPR, PATTERNS);
+DllExport void boolexpr_CompiledExpr_eval_many(COMPILED_EXPR, size_t, PATTERNS,
+                                               uint64_t *);
+
+DllExport BDD_MANAGER boolexpr_BddManager_new(CONTEXT, uint32_t);
+DllExport void boolexpr_BddManager_del(BDD_MANAGER);
+DllExport BDD boolexpr_BddManager_zero(BDD_MANAGER);
+DllExport BDD boolexpr_BddManager_one(BDD_MANAGER);
+DllExport BDD boolexpr_BddManager_to_bdd(BDD_MANAGER, BX);
+DllExport VEC boolexpr_BddManager_order(BDD_MANAGER);
+DllExport size_t boolexpr_BddManager_nodes(BDD_MANAGER);
+DllExport void boolexpr_BddManager_gc(BDD_MANAGER);
+DllExport void boolexpr_BddManager_reorder(BDD_MANAGER, uint8_t);
+DllExport void boolexpr_BddManager_set_auto_reorder(BDD_MANAGER, uint8_t);
+DllExport void boolexpr_BddManager_group(BDD_MANAGER, size_t, VARS);
+DllExport void boolexpr_BddManager_set_order(BDD_MANAGER, size_t, VARS);
+
+DllExport void boolexpr_Bdd_del(BDD);
+DllExport BDD boolexpr_Bdd_not(BDD);
+DllExport BDD boolexpr_Bdd_and(BDD, BDD);
+DllExport BDD boolexpr_Bdd_or(BDD, BDD);
+DllExport BDD boolexpr_Bdd_xor(BDD, BDD);
+DllExport BDD boolexpr_Bdd_ite(BDD, BDD, BDD);
+DllExport bool boolexpr_Bdd_equal(BDD, BDD);
+DllExport BDD boolexpr_Bdd_restrict(BDD, size_t, VARS, CONSTS);
+DllExport BDD boolexpr_Bdd_exists(BDD, size_t, VARS);
+DllExport BDD boolexpr_Bdd_forall(BDD, size_t, VARS);
+DllExport STRING boolexpr_Bdd_sat_count(BDD);
+DllExport VEC boolexpr_Bdd_support(BDD);
+DllExport size_t boolexpr_Bdd_size(BDD);
+DllExport BX boolexpr_Bdd_to_bx(BDD);
+
+DllExport BDD_SAT_ITER boolexpr_BddSatIter_new(BDD);
+DllExport void boolexpr_BddSatIter_del(BDD_SAT_ITER);
+DllExport void boolexpr_BddSatIter_next(BDD_SAT_ITER);
+DllExport POINT boolexpr_BddSatIter_val(BDD_SAT_ITER);
+
+DllExport ZDD_MANAGER boolexpr_ZddManager_new(CONTEXT);
+DllExport void boolexpr_ZddManager_del(ZDD_MANAGER);
+DllExport ZDD boolexpr_ZddManager_empty(ZDD_MANAGER);
+DllExport ZDD boolexpr_ZddManager_base(ZDD_MANAGER);
+DllExport ZDD boolexpr_ZddManager_cube(ZDD_MANAGER, size_t, BXS);
+DllExport ZDD boolexpr_ZddManager_dnf(ZDD_MANAGER, BX);
+DllExport ZDD boolexpr_ZddManager_cnf(ZDD_MANAGER, BX);
+DllExport ZDD boolexpr_ZddManager_isop(ZDD_MANAGER, BDD, BDD);
+DllExport size_t boolexpr_ZddManager_nodes(ZDD_MANAGER);
+DllExport void boolexpr_ZddManager_gc(ZDD_MANAGER);
+
+DllExport void boolexpr_Zdd_del(ZDD);
+DllExport ZDD boolexpr_Zdd_or(ZDD, ZDD);
+DllExport ZDD boolexpr_Zdd_and(ZDD, ZDD);
+DllExport ZDD boolexpr_Zdd_sub(ZDD, ZDD);
+DllExport ZDD boolexpr_Zdd_mul(ZDD, ZDD);
+DllExport bool boolexpr_Zdd_equal(ZDD, ZDD);
+DllExport ZDD boolexpr_Zdd_minimal(ZDD);
+DllExport BDD boolexpr_Zdd_to_bdd(ZDD, BDD_MANAGER);
+DllExport BX boolexpr_Zdd_to_dnf(ZDD);
+DllExport BX boolexpr_Zdd_to_cnf(ZDD);
+DllExport STRING boolexpr_Zdd_count(ZDD);
+DllExport size_t boolexpr_Zdd_size(ZDD);
+
+DllExport SAT_SESSION boolexpr_SatSession_new(uint32_t);
+DllExport void boolexpr_SatSession_del(SAT_SESSION);
+DllExport void boolexpr_SatSession_add(SAT_SESSION, BX);
+DllExport SOLN boolexpr_SatSession_solve(SAT_SESSION, size_t, BXS);
+
+DllExport ASSUMPTION_CACHE boolexpr_AssumptionCache_new(BX);
+DllExport void boolexpr_AssumptionCache_del(ASSUMPTION_CACHE);
+DllExport SOLN boolexpr_AssumptionCache_sat(ASSUMPTION_CACHE, size_t, VARS,
+                                            CONSTS);
+DllExport bool boolexpr_AssumptionCache_equiv(ASSUMPTION_CACHE, BX, size_t,
+                                              VARS, CONSTS);
+
+DllExport bool boolexpr_serve_cubes(STRING);
+
+DllExport VEC boolexpr_unsat_core(size_t, BXS, bool);
+DllExport void boolexpr_equiv_many(size_t, BXS, BXS, bool *);
+DllExport bool boolexpr_simulate(BX, size_t, VARS, size_t, PATTERNS,
+                                uint64_t *);
+DllExport VEC boolexpr_dfs_order(size_t, BXS);
+DllExport VEC boolexpr_force_order(size_t, BXS, uint32_t);
+
 DllExport DFS_ITER boolexpr_DfsIter_new(BX);
 DllExport void boolexpr_DfsIter_del(DFS_ITER);
 DllExport void boolexpr_DfsIter_next(DFS_ITER);
 DllExport BX boolexpr_DfsIter_val(DFS_ITER);
 
 DllExport SAT_ITER boolexpr_SatIter_new(BX);
+DllExport SAT_ITER boolexpr_SatIter_new_projected(BX, size_t, VARS);
 DllExport void boolexpr_SatIter_del(SAT_ITER);
 DllExport void boolexpr_SatIter_next(SAT_ITER);
 DllExport POINT boolexpr_SatIter_val(SAT_ITER);
@@ -1033,6 +2205,17 @@ DllExport BX boolexpr_nite(BX, BX, BX);
 DllExport BX boolexpr_ite(BX, BX, BX);
 DllExport BX boolexpr_onehot0(size_t, BXS);
 DllExport BX boolexpr_onehot(size_t, BXS);
+DllExport BX boolexpr_at_most_one(CONTEXT, size_t, BXS, uint8_t, STRING);
+DllExport BX boolexpr_exactly_one(CONTEXT, size_t, BXS, uint8_t, STRING);
+DllExport BX boolexpr_at_most_k(CONTEXT, size_t, BXS, size_t, uint8_t, STRING);
+DllExport BX boolexpr_at_least_k(CONTEXT, size_t, BXS, size_t, uint8_t, STRING);
+DllExport BX boolexpr_exactly_k(CONTEXT, size_t, BXS, size_t, uint8_t, STRING);
+DllExport BX boolexpr_pb_leq(CONTEXT, size_t, BXS, WEIGHTS, int64_t, uint8_t,
+                             STRING);
+DllExport BX boolexpr_pb_geq(CONTEXT, size_t, BXS, WEIGHTS, int64_t, uint8_t,
+                             STRING);
+DllExport BX boolexpr_pb_eq(CONTEXT, size_t, BXS, WEIGHTS, int64_t, uint8_t,
+                            STRING);
 
 DllExport BX boolexpr_nor_s(size_t, BXS);
 DllExport BX boolexpr_or_s(size_t, BXS);
@@ -1063,10 +2246,23 @@ DllExport BX boolexpr_BoolExpr_tseytin(BX, CONTEXT, STRING);
 DllExport BX boolexpr_BoolExpr_compose(BX, size_t, VARS, BXS);
 DllExport BX boolexpr_BoolExpr_restrict(BX, size_t, VARS, CONSTS);
 DllExport SOLN boolexpr_BoolExpr_sat(BX);
+DllExport SOLN boolexpr_BoolExpr_sat_portfolio(BX, uint32_t);
+DllExport SOLN boolexpr_BoolExpr_sat_cubes(BX, uint32_t, uint32_t);
+DllExport SOLN boolexpr_BoolExpr_sat_remote(BX, size_t, STRINGS, uint32_t);
+DllExport SOLN boolexpr_BoolExpr_sat_limited(BX, uint32_t, uint32_t, int64_t,
+                                             int64_t, double, SAT_INTERRUPT);
+DllExport SOLN boolexpr_BoolExpr_sat_assuming(BX, size_t, VARS, CONSTS);
 DllExport BX boolexpr_BoolExpr_to_cnf(BX);
 DllExport BX boolexpr_BoolExpr_to_dnf(BX);
 DllExport BX boolexpr_BoolExpr_to_nnf(BX);
 DllExport bool boolexpr_BoolExpr_equiv(BX, BX);
+DllExport bool boolexpr_BoolExpr_equiv_assuming(BX, BX, size_t, VARS, CONSTS);
+DllExport uint8_t boolexpr_BoolExpr_equiv_limited(BX, BX, uint32_t, int64_t,
+                                                 int64_t, double,
+                                                 SAT_INTERRUPT);
+DllExport STRING boolexpr_BoolExpr_count_sat(BX);
+DllExport STRING boolexpr_BoolExpr_approx_count_sat(BX, double, double,
+                                                    uint32_t);
 DllExport VARSET boolexpr_BoolExpr_support(BX);
 DllExport uint32_t boolexpr_BoolExpr_degree(BX);
 
@@ -1075,6 +2271,7 @@ DllExport BX boolexpr_BoolExpr_expand(BX, size_t, VARS);
 DllExport BX boolexpr_BoolExpr_smoothing(BX, size_t, VARS);
 DllExport BX boolexpr_BoolExpr_consensus(BX, size_t, VARS);
 DllExport BX boolexpr_BoolExpr_derivative(BX, size_t, VARS);
+DllExport bool boolexpr_BoolExpr_npn_class(BX, uint32_t *, uint64_t *);
 
 DllExport CONTEXT boolexpr_Literal_ctx(BX);
 DllExport uint32_t boolexpr_Literal_id(BX);
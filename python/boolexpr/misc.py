@@ -28,17 +28,26 @@ from .wrap import array
 from .wrap import not_
 from .wrap import or_
 from .wrap import and_
+from .wrap import at_least_k
+from .wrap import exactly_k
 from .wrap import _expect_array
 
 
-def nhot(n, *args):
+def nhot(n, *args, ctx=None, encoding=None):
     """
     Return a CNF expression that means
     "exactly N input functions are true".
+
+    By default, the result is logically equivalent to the constraint,
+    but its size grows with the binomial coefficients of the inputs.
+    If *encoding* is given, return ``exactly_k(n, *args, ...)`` instead,
+    which is only equisatisfiable, but scales to large inputs.
     """
     if not 0 <= n <= len(args):
         fstr = "expected 0 <= n <= {}, got {}"
         raise ValueError(fstr.format(len(args), n))
+    if encoding is not None:
+        return exactly_k(n, *args, ctx=ctx, encoding=encoding)
     clauses = list()
     for xs in itertools.combinations(args, n+1):
         clauses.append(or_(*[not_(x) for x in xs]))
@@ -47,11 +56,16 @@ def nhot(n, *args):
     return and_(*clauses)
 
 
-def majority(*args):
+def majority(*args, ctx=None, encoding=None):
     """
     Return a CNF expression that means
     "the majority of input functions are true".
+
+    See ``nhot`` for a description of the *ctx* and *encoding* parameters.
     """
+    if encoding is not None:
+        return at_least_k((len(args) + 1) // 2, *args, ctx=ctx,
+                          encoding=encoding)
     clauses = list()
     for xs in itertools.combinations(args, (len(args) + 1) // 2):
         clauses.append(or_(*xs))
@@ -29,9 +29,11 @@ CFFI _boolexpr module wrapper
 
 
 import collections
+import contextlib
 import enum
 import itertools
 import operator
+import weakref
 from functools import reduce
 
 # pylint: disable=no-name-in-module
@@ -116,6 +118,16 @@ class _Point:
             lib.boolexpr_Point_next(self._cdata)
 
 
+# SatStatus value of a solve that stopped at a limit
+_UNKNOWN = 2
+
+# Most variables in a truth table
+_TT_MAX_VARS = 16
+
+# Mask of one word of simulation patterns
+_WORD_MASK = (1 << 64) - 1
+
+
 class _Soln:
     """
     Wrap C Soln
@@ -128,7 +140,10 @@ class _Soln:
 
     @property
     def sat(self):
-        """Return True if the solution is satisfiable."""
+        """Return True if the solution is satisfiable, or None if unknown."""
+        status = lib.boolexpr_Soln_status(self._cdata)
+        if status == _UNKNOWN:
+            return None
         return bool(lib.boolexpr_Soln_first(self._cdata))
 
     @property
@@ -182,6 +197,25 @@ class _SatIter:
             lib.boolexpr_SatIter_next(self._cdata)
 
 
+class _BddSatIter:
+    """
+    Wrap C BddSatIter
+    """
+    def __init__(self, cdata):
+        self._cdata = cdata
+
+    def __del__(self):
+        lib.boolexpr_BddSatIter_del(self._cdata)
+
+    def __iter__(self):
+        while True:
+            val = lib.boolexpr_BddSatIter_val(self._cdata)
+            if val == ffi.NULL:
+                break
+            yield dict(_Point(val))
+            lib.boolexpr_BddSatIter_next(self._cdata)
+
+
 class _PointsIter:
     """
     Wrap C PointsIter
@@ -299,6 +333,41 @@ class Context:
         cdata = lib.boolexpr_Context_get_var(self._cdata, name.encode("ascii"))
         return _bx(cdata)
 
+    def push_scope(self):
+        """Begin a scope for scratch variables."""
+        lib.boolexpr_Context_push_scope(self._cdata)
+
+    def pop_scope(self):
+        """End the innermost scope, and reclaim the variables created in it.
+
+        If any of those variables is still referenced,
+        nothing changes and the return value is ``False``.
+        Drop the references, and try again.
+
+        Raise ValueError if there is no open scope.
+        """
+        if lib.boolexpr_Context_num_scopes(self._cdata) == 0:
+            raise ValueError("expected an open scope")
+        return bool(lib.boolexpr_Context_pop_scope(self._cdata))
+
+    @contextlib.contextmanager
+    def scope(self):
+        """Return a context manager that wraps push_scope/pop_scope.
+
+        For example::
+
+           >>> with ctx.scope():
+           ...     soln = f.tseytin(ctx).sat()
+
+        If a variable from the block is still referenced at its end,
+        the scope stays open, as with pop_scope.
+        """
+        self.push_scope()
+        try:
+            yield self
+        finally:
+            self.pop_scope()
+
     def get_vars(self, name, *dims):
         """Return a multi-dimensional array of variables.
 
@@ -334,6 +403,630 @@ def get_vars(name, *dims):
     return ROOT_CONTEXT.get_vars(name, *dims)
 
 
+class SatSession:
+    """
+    An incremental SAT solving session
+
+    Constraints added to a session accumulate,
+    and the solver keeps its learned clauses between calls to solve.
+
+    If *nthreads* is greater than one,
+    the session runs a parallel portfolio of that many solvers,
+    which share only the unit clauses they learn.
+    """
+    def __init__(self, nthreads=1):
+        self._cdata = lib.boolexpr_SatSession_new(nthreads)
+
+    def __del__(self):
+        lib.boolexpr_SatSession_del(self._cdata)
+
+    def add(self, *fs):
+        """Add one or more constraints to the session."""
+        for f in fs:
+            lib.boolexpr_SatSession_add(self._cdata, _expect_bx(f)._cdata)
+
+    def solve(self, *assumptions):
+        """Solve the constraints added so far.
+
+        The variadic *assumptions* input is a sequence of literals that
+        hold for this call only.
+
+        Returns a two-tuple (sat, point).
+        """
+        for lit in assumptions:
+            if not isinstance(lit, Literal):
+                raise TypeError("Expected assumptions to be Literals")
+        num, c_bxs = _convert_args(assumptions)
+        return _Soln(lib.boolexpr_SatSession_solve(self._cdata, num, c_bxs)).t
+
+
+class AssumptionCache:
+    """
+    An encoding of one expression, for many queries under partial points
+
+    The cache owns one encoding and one solver,
+    so sweeping over many cofactors pays for one encoding,
+    rather than one ``restrict`` per query.
+    """
+    def __init__(self, f):
+        self._f = _expect_bx(f)
+        self._cdata = lib.boolexpr_AssumptionCache_new(self._f._cdata)
+
+    def __del__(self):
+        lib.boolexpr_AssumptionCache_del(self._cdata)
+
+    def sat(self, point):
+        """Return a tuple (sat, point) under a partial assignment.
+
+        The returned point omits the assigned variables.
+        """
+        num, c_vars, c_consts = _convert_point(point)
+        cdata = lib.boolexpr_AssumptionCache_sat(self._cdata, num, c_vars, c_consts)
+        return _Soln(cdata).t
+
+    def equiv(self, other, point):
+        """Return True if the expression is equivalent to another
+        under a partial assignment.
+        """
+        other = _expect_bx(other)
+        num, c_vars, c_consts = _convert_point(point)
+        return bool(lib.boolexpr_AssumptionCache_equiv(self._cdata, other._cdata,
+                                                       num, c_vars, c_consts))
+
+
+class SatInterrupt:
+    """
+    A handle to stop solving from another thread
+
+    Pass it as the *interrupt* argument of
+    :meth:`BoolExpr.sat` or :meth:`BoolExpr.equiv`.
+    """
+    def __init__(self):
+        self._cdata = lib.boolexpr_SatInterrupt_new()
+
+    def __del__(self):
+        lib.boolexpr_SatInterrupt_del(self._cdata)
+
+    def interrupt(self):
+        """Stop every solve that uses this handle, until reset."""
+        lib.boolexpr_SatInterrupt_interrupt(self._cdata)
+
+    def reset(self):
+        """Allow solves that use this handle to run again."""
+        lib.boolexpr_SatInterrupt_reset(self._cdata)
+
+
+class CompiledExpr:
+    """
+    An expression compiled for repeated evaluation
+
+    Use :meth:`BoolExpr.compile` to make one.
+    The *inputs* attribute is a tuple of the support variables,
+    and a point is an int whose bit i is the value of ``inputs[i]``.
+    """
+    def __init__(self, bx):
+        self._cdata = lib.boolexpr_CompiledExpr_new(bx._cdata)
+        if self._cdata == ffi.NULL:
+            raise ValueError("expected a known expression")
+        self.inputs = tuple(_Vec(lib.boolexpr_CompiledExpr_inputs(self._cdata)))
+        self._stride = (len(self.inputs) + 63) // 64
+
+    def __del__(self):
+        if self._cdata != ffi.NULL:
+            lib.boolexpr_CompiledExpr_del(self._cdata)
+
+    def _convert_points(self, points):
+        c_points = ffi.new("uint64_t []", max(1, len(points) * self._stride))
+        for j, point in enumerate(points):
+            for k in range(self._stride):
+                c_points[j * self._stride + k] = (point >> (64 * k)) & _WORD_MASK
+        return c_points
+
+    def eval(self, point):
+        """Return the value of the expression at one point."""
+        c_point = self._convert_points([point])
+        return bool(lib.boolexpr_CompiledExpr_eval(self._cdata, c_point))
+
+    def eval_many(self, points):
+        """Return a list of the values at a sequence of points.
+
+        The points are evaluated in one call, many at a time.
+        """
+        points = list(points)
+        num = len(points)
+        c_points = self._convert_points(points)
+        c_results = ffi.new("uint64_t []", max(1, (num + 63) // 64))
+        lib.boolexpr_CompiledExpr_eval_many(self._cdata, num, c_points, c_results)
+        return [bool((c_results[j // 64] >> (j % 64)) & 1) for j in range(num)]
+
+
+class BddManager:
+    """
+    A manager of reduced ordered binary decision diagrams (BDDs)
+
+    The BDDs are over the variables of *ctx*,
+    which is the root context by default.
+    Variables join the bottom of the order when they first appear,
+    and :meth:`to_bdd` adds new variables in the order they were created.
+    Nodes that no :class:`Bdd` reaches are garbage collected.
+
+    If *nthreads* is greater than one,
+    the operators, :meth:`ite`, and quantification share their work
+    between that many threads.
+    """
+    def __init__(self, ctx=None, nthreads=1):
+        self._ctx = ROOT_CONTEXT if ctx is None else ctx
+        self._cdata = lib.boolexpr_BddManager_new(self._ctx._cdata, nthreads)
+
+    def __del__(self):
+        lib.boolexpr_BddManager_del(self._cdata)
+
+    def zero(self):
+        """Return the BDD of Boolean zero."""
+        return Bdd(self, lib.boolexpr_BddManager_zero(self._cdata))
+
+    def one(self):
+        """Return the BDD of Boolean one."""
+        return Bdd(self, lib.boolexpr_BddManager_one(self._cdata))
+
+    def to_bdd(self, f):
+        """Return the BDD of an expression with no unknown constants."""
+        f = _expect_bx(f)
+        _expect_known(f)
+        for x in f.support():
+            if lib.boolexpr_Literal_ctx(x._cdata) != self._ctx._cdata:
+                raise ValueError("expected variables from the manager's context")
+        return Bdd(self, lib.boolexpr_BddManager_to_bdd(self._cdata, f._cdata))
+
+    def ite(self, f, g, h):
+        """Return the BDD of If-Then-Else (ITE) of three BDDs."""
+        f, g, h = (self._expect_bdd(arg) for arg in (f, g, h))
+        return Bdd(self, lib.boolexpr_Bdd_ite(f._cdata, g._cdata, h._cdata))
+
+    @property
+    def order(self):
+        """A tuple of the variables, in order from the top."""
+        return tuple(_Vec(lib.boolexpr_BddManager_order(self._cdata)))
+
+    @property
+    def nodes(self):
+        """The number of nodes in the unique tables."""
+        return lib.boolexpr_BddManager_nodes(self._cdata)
+
+    def gc(self):
+        """Free every node that no Bdd reaches."""
+        lib.boolexpr_BddManager_gc(self._cdata)
+
+    def reorder(self, method="sift"):
+        """Reorder the variables now.
+
+        The *method* is one of "sift" or "group_sift".
+        Sifting moves each variable, or group of variables, to the level
+        where the BDDs have the fewest nodes.
+        Group sifting also groups adjacent symmetric variables.
+        """
+        lib.boolexpr_BddManager_reorder(self._cdata, _expect_reorder(method))
+
+    def set_auto_reorder(self, method="sift"):
+        """Reorder whenever the number of nodes doubles.
+
+        The *method* is one of "none", "sift", or "group_sift".
+        """
+        code = _expect_reorder(method)
+        lib.boolexpr_BddManager_set_auto_reorder(self._cdata, code)
+
+    def group(self, xs):
+        """Keep a sequence of variables together when reordering."""
+        num, c_vars = self._convert_vars(xs)
+        lib.boolexpr_BddManager_group(self._cdata, num, c_vars)
+
+    def set_order(self, xs):
+        """Move a sequence of variables to the top of the order.
+
+        The other variables keep their relative order below them,
+        and groups are dissolved.
+        """
+        num, c_vars = self._convert_vars(xs)
+        lib.boolexpr_BddManager_set_order(self._cdata, num, c_vars)
+
+    def _convert_vars(self, xs):
+        num = len(xs)
+        c_vars = ffi.new("void * []", num)
+        for i, x in enumerate(xs):
+            c_vars[i] = self._expect_var(x)._cdata
+        return num, c_vars
+
+    def _expect_var(self, obj):
+        """Return a Variable of this manager's context, or raise an error."""
+        x = _expect_var(obj)
+        if lib.boolexpr_Literal_ctx(x._cdata) != self._ctx._cdata:
+            raise ValueError("expected variables from the manager's context")
+        return x
+
+    def _expect_bdd(self, obj):
+        """Return a Bdd of this manager, or raise TypeError."""
+        if isinstance(obj, Bdd) and obj._mgr is self:
+            return obj
+        raise TypeError("Expected obj to be a Bdd of this manager")
+
+
+class Bdd:
+    """
+    A Boolean function in a :class:`BddManager`
+
+    Use :meth:`BddManager.to_bdd` to make one.
+    BDDs are canonical,
+    so two BDDs are equal if and only if they are the same function.
+    """
+    def __init__(self, mgr, cdata):
+        self._mgr = mgr
+        self._cdata = cdata
+
+    def __del__(self):
+        lib.boolexpr_Bdd_del(self._cdata)
+
+    def __invert__(self):
+        return Bdd(self._mgr, lib.boolexpr_Bdd_not(self._cdata))
+
+    def __and__(self, other):
+        other = self._mgr._expect_bdd(other)
+        return Bdd(self._mgr, lib.boolexpr_Bdd_and(self._cdata, other._cdata))
+
+    def __or__(self, other):
+        other = self._mgr._expect_bdd(other)
+        return Bdd(self._mgr, lib.boolexpr_Bdd_or(self._cdata, other._cdata))
+
+    def __xor__(self, other):
+        other = self._mgr._expect_bdd(other)
+        return Bdd(self._mgr, lib.boolexpr_Bdd_xor(self._cdata, other._cdata))
+
+    def __eq__(self, other):
+        if not isinstance(other, Bdd):
+            return NotImplemented
+        return bool(lib.boolexpr_Bdd_equal(self._cdata, other._cdata))
+
+    def is_zero(self):
+        """Return True if the function is Boolean zero."""
+        return self == self._mgr.zero()
+
+    def is_one(self):
+        """Return True if the function is Boolean one."""
+        return self == self._mgr.one()
+
+    def restrict(self, point):
+        """Return the cofactor by a point of variables to constants."""
+        for x in point:
+            self._mgr._expect_var(x)
+        num, c_vars, c_consts = _convert_point(point)
+        cdata = lib.boolexpr_Bdd_restrict(self._cdata, num, c_vars, c_consts)
+        return Bdd(self._mgr, cdata)
+
+    def _quantify(self, func, xs):
+        if isinstance(xs, Variable):
+            xs = [xs]
+        num, c_vars = self._mgr._convert_vars(xs)
+        return Bdd(self._mgr, func(self._cdata, num, c_vars))
+
+    def exists(self, xs):
+        """Return the existential quantification over a sequence of variables."""
+        return self._quantify(lib.boolexpr_Bdd_exists, xs)
+
+    def forall(self, xs):
+        """Return the universal quantification over a sequence of variables."""
+        return self._quantify(lib.boolexpr_Bdd_forall, xs)
+
+    def sat_count(self):
+        """Return the number of satisfying points over the support.
+
+        The count takes time linear in the size of the BDD.
+        """
+        data = bytes(_String(lib.boolexpr_Bdd_sat_count(self._cdata)))
+        return int(data)
+
+    def iter_sat(self):
+        """Iterate through all satisfying points over the support."""
+        yield from _BddSatIter(lib.boolexpr_BddSatIter_new(self._cdata))
+
+    def support(self):
+        """Return a tuple of the support variables, in order from the top."""
+        return tuple(_Vec(lib.boolexpr_Bdd_support(self._cdata)))
+
+    @property
+    def size(self):
+        """The number of nodes, including the terminal."""
+        return lib.boolexpr_Bdd_size(self._cdata)
+
+    def to_bx(self):
+        """Return an expression with one If-Then-Else per node."""
+        return _bx(lib.boolexpr_Bdd_to_bx(self._cdata))
+
+
+class ZddManager:
+    """
+    A manager of zero-suppressed decision diagrams (ZDDs) of sets of cubes
+
+    The cubes are over the literals of the variables of *ctx*,
+    which is the root context by default.
+    A set of cubes reads as a DNF, or as a CNF if each cube is a clause.
+    Nodes that no :class:`Zdd` reaches are garbage collected.
+    """
+    def __init__(self, ctx=None):
+        self._ctx = ROOT_CONTEXT if ctx is None else ctx
+        self._cdata = lib.boolexpr_ZddManager_new(self._ctx._cdata)
+
+    def __del__(self):
+        lib.boolexpr_ZddManager_del(self._cdata)
+
+    def empty(self):
+        """Return the set with no cubes."""
+        return Zdd(self, lib.boolexpr_ZddManager_empty(self._cdata))
+
+    def base(self):
+        """Return the set whose only cube is the empty cube."""
+        return Zdd(self, lib.boolexpr_ZddManager_base(self._cdata))
+
+    def cube(self, lits):
+        """Return the set of one cube of a sequence of literals.
+
+        A cube with both x and ~x is dropped.
+        """
+        num = len(lits)
+        c_lits = ffi.new("void const * []", num)
+        for i, lit in enumerate(lits):
+            if not isinstance(lit, Literal):
+                raise TypeError("Expected lit to be a Literal")
+            self._expect_ctx(lit)
+            c_lits[i] = lit._cdata
+        return Zdd(self, lib.boolexpr_ZddManager_cube(self._cdata, num, c_lits))
+
+    def dnf(self, f):
+        """Return the cubes of a DNF of an expression.
+
+        Each operator of the negation normal form is a union or a product
+        of cube sets, and cubes that contain other cubes are removed.
+        """
+        f = self._expect_bx(f)
+        return Zdd(self, lib.boolexpr_ZddManager_dnf(self._cdata, f._cdata))
+
+    def cnf(self, f):
+        """Return the clauses of a CNF of an expression, like :meth:`dnf`."""
+        f = self._expect_bx(f)
+        return Zdd(self, lib.boolexpr_ZddManager_cnf(self._cdata, f._cdata))
+
+    def isop(self, lower, upper=None):
+        """Return an irredundant sum of products between two BDDs.
+
+        The cover implies *upper*, and is implied by *lower*.
+        By default *upper* is *lower*, so the cover is exact.
+        """
+        if upper is None:
+            upper = lower
+        if not (isinstance(lower, Bdd) and isinstance(upper, Bdd)):
+            raise TypeError("Expected lower and upper to be Bdd")
+        if lower._mgr is not upper._mgr:
+            raise ValueError("expected lower and upper from one manager")
+        if lower._mgr._ctx is not self._ctx:
+            raise ValueError("expected a BddManager of the manager's context")
+        if not (lower & ~upper).is_zero():
+            raise ValueError("expected lower to imply upper")
+        cdata = lib.boolexpr_ZddManager_isop(self._cdata, lower._cdata,
+                                             upper._cdata)
+        return Zdd(self, cdata)
+
+    @property
+    def nodes(self):
+        """The number of nodes in the unique table."""
+        return lib.boolexpr_ZddManager_nodes(self._cdata)
+
+    def gc(self):
+        """Free every node that no Zdd reaches."""
+        lib.boolexpr_ZddManager_gc(self._cdata)
+
+    def _expect_ctx(self, x):
+        if lib.boolexpr_Literal_ctx(x._cdata) != self._ctx._cdata:
+            raise ValueError("expected variables from the manager's context")
+
+    def _expect_bx(self, obj):
+        """Return a BoolExpr of this context with no unknown constants."""
+        f = _expect_bx(obj)
+        _expect_known(f)
+        for x in f.support():
+            self._expect_ctx(x)
+        return f
+
+    def _expect_zdd(self, obj):
+        """Return a Zdd of this manager, or raise TypeError."""
+        if isinstance(obj, Zdd) and obj._mgr is self:
+            return obj
+        raise TypeError("Expected obj to be a Zdd of this manager")
+
+
+class Zdd:
+    """
+    A set of cubes in a :class:`ZddManager`
+
+    The operators are ``|`` for union, ``&`` for intersection,
+    ``-`` for difference, and ``*`` for the product,
+    which joins every pair of cubes and drops those with both x and ~x.
+    ZDDs are canonical,
+    so two ZDDs are equal if and only if they are the same set.
+    """
+    def __init__(self, mgr, cdata):
+        self._mgr = mgr
+        self._cdata = cdata
+
+    def __del__(self):
+        lib.boolexpr_Zdd_del(self._cdata)
+
+    def _apply(self, func, other):
+        other = self._mgr._expect_zdd(other)
+        return Zdd(self._mgr, func(self._cdata, other._cdata))
+
+    def __or__(self, other):
+        return self._apply(lib.boolexpr_Zdd_or, other)
+
+    def __and__(self, other):
+        return self._apply(lib.boolexpr_Zdd_and, other)
+
+    def __sub__(self, other):
+        return self._apply(lib.boolexpr_Zdd_sub, other)
+
+    def __mul__(self, other):
+        return self._apply(lib.boolexpr_Zdd_mul, other)
+
+    def __eq__(self, other):
+        if not isinstance(other, Zdd):
+            return NotImplemented
+        return bool(lib.boolexpr_Zdd_equal(self._cdata, other._cdata))
+
+    def is_empty(self):
+        """Return True if there are no cubes."""
+        return self == self._mgr.empty()
+
+    def is_base(self):
+        """Return True if the only cube is the empty cube."""
+        return self == self._mgr.base()
+
+    def minimal(self):
+        """Return the set without cubes that contain other cubes."""
+        return Zdd(self._mgr, lib.boolexpr_Zdd_minimal(self._cdata))
+
+    def count(self):
+        """Return the number of cubes.
+
+        The count takes time linear in the size of the ZDD.
+        """
+        data = bytes(_String(lib.boolexpr_Zdd_count(self._cdata)))
+        return int(data)
+
+    @property
+    def size(self):
+        """The number of nodes, not including the terminals."""
+        return lib.boolexpr_Zdd_size(self._cdata)
+
+    def to_bdd(self, mgr):
+        """Return the BDD of the cubes read as a DNF."""
+        if not isinstance(mgr, BddManager):
+            raise TypeError("Expected mgr to be a BddManager")
+        if mgr._ctx is not self._mgr._ctx:
+            raise ValueError("expected a BddManager of the manager's context")
+        return Bdd(mgr, lib.boolexpr_Zdd_to_bdd(self._cdata, mgr._cdata))
+
+    def to_dnf(self):
+        """Return the cubes as an OR of ANDs."""
+        return _bx(lib.boolexpr_Zdd_to_dnf(self._cdata))
+
+    def to_cnf(self):
+        """Return the cubes as an AND of ORs."""
+        return _bx(lib.boolexpr_Zdd_to_cnf(self._cdata))
+
+
+def _convert_limits(conflicts, propagations, timeout, interrupt):
+    """Convert solver limits to C arguments, or return None if none apply."""
+    if conflicts is None and propagations is None and timeout is None and interrupt is None:
+        return None
+    return (
+        -1 if conflicts is None else conflicts,
+        -1 if propagations is None else propagations,
+        0.0 if timeout is None else float(timeout),
+        ffi.NULL if interrupt is None else interrupt._cdata,
+    )
+
+
+def unsat_core(*constraints, minimal=False):
+    """Return a tuple of constraints whose conjunction is unsatisfiable.
+
+    If the conjunction of all *constraints* is satisfiable,
+    return an empty tuple.
+
+    If *minimal* is ``True``,
+    shrink the core until dropping any one constraint
+    makes the rest satisfiable.
+    """
+    num, c_bxs = _convert_args(constraints)
+    return tuple(_Vec(lib.boolexpr_unsat_core(num, c_bxs, minimal)))
+
+
+def equiv_many(pairs):
+    """Return a list of whether each pair of expressions is equivalent.
+
+    The *pairs* input is a sequence of (f, g) pairs.
+    All pairs share one encoding and one solver,
+    which is much faster than calling ``equiv`` on each pair
+    when they have logic in common.
+    """
+    pairs = list(pairs)
+    num, c_lhs = _convert_args([f for f, _ in pairs])
+    _, c_rhs = _convert_args([g for _, g in pairs])
+    c_results = ffi.new("_Bool []", num)
+    lib.boolexpr_equiv_many(num, c_lhs, c_rhs, c_results)
+    return [bool(result) for result in c_results]
+
+
+def simulate(f, patterns, num=64):
+    """Evaluate an expression on *num* input points at once.
+
+    The *patterns* input is a {Variable: int} dict,
+    where bit j of each int is the variable's value in point j.
+    Returns an int, where bit j is the value of *f* in point j.
+
+    Every variable in the support of *f* needs a pattern.
+    """
+    for x in f.support():
+        if x not in patterns:
+            raise ValueError("expected a pattern for {}".format(x))
+    _expect_known(f)
+
+    nwords = max(1, (num + 63) // 64)
+    n = len(patterns)
+    c_vars = ffi.new("void * []", n)
+    c_patterns = ffi.new("uint64_t []", n * nwords)
+    for i, (x, pattern) in enumerate(patterns.items()):
+        c_vars[i] = _expect_var(x)._cdata
+        for k in range(nwords):
+            c_patterns[i * nwords + k] = (pattern >> (64 * k)) & _WORD_MASK
+
+    c_result = ffi.new("uint64_t []", nwords)
+    if not lib.boolexpr_simulate(f._cdata, n, c_vars, nwords, c_patterns, c_result):
+        raise ValueError("expected a pattern for every variable")
+    result = 0
+    for k in range(nwords):
+        result |= c_result[k] << (64 * k)
+    return result & ((1 << num) - 1)
+
+
+def dfs_order(*fs):
+    """Return a tuple of the variables of some expressions, in depth-first order.
+
+    Variables that meet in a small subexpression end up close together,
+    which is a good BDD variable order for many circuits.
+    """
+    num, c_bxs = _convert_args(fs)
+    return tuple(_Vec(lib.boolexpr_dfs_order(num, c_bxs)))
+
+
+def force_order(*fs, rounds=20):
+    """Return a tuple of the variables of some expressions, placed by FORCE.
+
+    Each operator and its arguments form a hyperedge.
+    Each of at most *rounds* rounds moves every node to the mean center of
+    its hyperedges, and the order with the least total span wins.
+    """
+    num, c_bxs = _convert_args(fs)
+    return tuple(_Vec(lib.boolexpr_force_order(num, c_bxs, rounds)))
+
+
+def serve_cubes(address):
+    """Listen on *address*, and serve one remote cube-and-conquer coordinator.
+
+    An address with a '/' is a Unix socket path,
+    and anything else is ``host:port`` for TCP.
+
+    Returns ``True`` if the session ended cleanly.
+    """
+    return bool(lib.boolexpr_serve_cubes(address.encode("ascii")))
+
+
 class BoolExpr:
     """
     Wrap boolexpr::BoolExpr class
@@ -572,6 +1265,9 @@ class BoolExpr:
 
         The ``auxvarname`` parameter is the prefix of auxiliary variable names.
         The suffix will be in the form ``_0``, ``_1``, etc.
+        Auxiliary variables are anonymous:
+        they are not registered with the context by name,
+        so they never collide with the context's named variables.
         """
         if ctx is None:
             ctx = ROOT_CONTEXT
@@ -602,26 +1298,94 @@ class BoolExpr:
 
         :math:`f \: | \: x_i = b`
         """
-        num = len(point)
-        c_vars = ffi.new("void * []", num)
-        c_consts = ffi.new("void * []", num)
-        for i, (var, const) in enumerate(point.items()):
-            c_vars[i] = _expect_var(var)._cdata
-            c_consts[i] = _expect_const(const)._cdata
+        num, c_vars, c_consts = _convert_point(point)
         return _bx(lib.boolexpr_BoolExpr_restrict(self._cdata, num, c_vars, c_consts))
 
-    def sat(self):
+    def sat(self, point=None, nthreads=1, cube_depth=0, workers=None,
+            conflicts=None, propagations=None, timeout=None, interrupt=None):
         """Return a tuple (sat, point).
 
         The sat value is ``True`` if the expression is satisfiable.
         If the expression is not satisfiable, the point will be ``None``.
         Otherwise, it will return a satisfying input point.
-        """
-        return _Soln(lib.boolexpr_BoolExpr_sat(self._cdata)).t
 
-    def iter_sat(self):
-        """Iterate through all satisfying input points."""
-        yield from _SatIter(lib.boolexpr_SatIter_new(self._cdata))
+        If the optional *point* argument is given,
+        solve under that partial assignment.
+        The returned point omits the assigned variables.
+        To sweep over many cofactors, use one :class:`AssumptionCache`.
+
+        If *nthreads* is greater than one,
+        run a portfolio of that many diversified solvers in parallel,
+        and return the first answer.
+        The solvers share only the unit clauses they learn.
+        This does not apply to queries with a *point*.
+
+        If *cube_depth* is greater than zero,
+        use cube-and-conquer instead:
+        a lookahead splitter partitions the problem into
+        at most ``2 ** cube_depth`` cubes,
+        and *nthreads* workers solve them until one is satisfiable.
+
+        If *workers* is a sequence of addresses,
+        solve the cubes on worker processes that are running
+        :func:`serve_cubes` instead of on local threads.
+
+        The solve may be limited by *conflicts* and *propagations*,
+        which apply to each solver, by a *timeout* in seconds,
+        or by a :class:`SatInterrupt` handle.
+        If a limit stops the solve, the sat value is ``None``.
+        With a *point*, a limited solve runs on the restricted expression.
+        Limits cannot be combined with *workers*, and raise ValueError.
+        """
+        limits = _convert_limits(conflicts, propagations, timeout, interrupt)
+        if limits is not None and workers is not None:
+            raise ValueError("expected no limits with workers")
+        if limits is not None and point is not None:
+            return self.restrict(point).sat(nthreads=nthreads, cube_depth=cube_depth,
+                                            conflicts=conflicts, propagations=propagations,
+                                            timeout=timeout, interrupt=interrupt)
+        if point is None:
+            if workers is None and limits is not None:
+                cdata = lib.boolexpr_BoolExpr_sat_limited(self._cdata, nthreads, cube_depth,
+                                                          *limits)
+                return _Soln(cdata).t
+            if workers is not None:
+                c_strs = [ffi.new("char []", w.encode("ascii")) for w in workers]
+                c_addresses = ffi.new("char const * []", c_strs)
+                cdata = lib.boolexpr_BoolExpr_sat_remote(self._cdata, len(workers),
+                                                         c_addresses, cube_depth)
+                return _Soln(cdata).t
+            if cube_depth > 0:
+                cdata = lib.boolexpr_BoolExpr_sat_cubes(self._cdata, nthreads, cube_depth)
+                return _Soln(cdata).t
+            if nthreads > 1:
+                return _Soln(lib.boolexpr_BoolExpr_sat_portfolio(self._cdata, nthreads)).t
+            return _Soln(lib.boolexpr_BoolExpr_sat(self._cdata)).t
+        num, c_vars, c_consts = _convert_point(point)
+        cdata = lib.boolexpr_BoolExpr_sat_assuming(self._cdata, num, c_vars, c_consts)
+        return _Soln(cdata).t
+
+    def iter_sat(self, project=None):
+        """Iterate through all satisfying input points.
+
+        If the optional *project* argument is given,
+        it is a sequence of variables to project the solutions onto.
+        The iterator then yields cubes: partial points whose completions
+        all satisfy the expression.
+        Inputs that do not matter are left out of each cube,
+        so there can be exponentially fewer cubes than points.
+        """
+        if project is None:
+            yield from _SatIter(lib.boolexpr_SatIter_new(self._cdata))
+        else:
+            if isinstance(project, Variable):
+                project = [project]
+            num = len(project)
+            c_vars = ffi.new("void * []", num)
+            for i, x in enumerate(project):
+                c_vars[i] = _expect_var(x)._cdata
+            cdata = lib.boolexpr_SatIter_new_projected(self._cdata, num, c_vars)
+            yield from _SatIter(cdata)
 
     def to_cnf(self):
         """Convert the expression to conjunctive normal form (CNF)."""
@@ -642,15 +1406,58 @@ class BoolExpr:
         """
         return _bx(lib.boolexpr_BoolExpr_to_nnf(self._cdata))
 
-    def equiv(self, other):
+    def equiv(self, other, point=None,
+              conflicts=None, propagations=None, timeout=None, interrupt=None):
         """Return True if the two expressions are formally equivalent.
 
+        If the optional *point* argument is given,
+        compare the two expressions under that partial assignment.
+
+        The check may be limited like :meth:`sat`.
+        If a limit stops it, return ``None``.
+
         .. note:: While in practice this check can be quite fast,
                   SAT is an NP-complete problem, so some inputs will require
                   exponential runtime.
         """
         other = _expect_bx(other)
-        return bool(lib.boolexpr_BoolExpr_equiv(self._cdata, other._cdata))
+        limits = _convert_limits(conflicts, propagations, timeout, interrupt)
+        if limits is not None and point is not None:
+            return self.restrict(point).equiv(other.restrict(point),
+                                              conflicts=conflicts, propagations=propagations,
+                                              timeout=timeout, interrupt=interrupt)
+        if point is None:
+            if limits is not None:
+                result = lib.boolexpr_BoolExpr_equiv_limited(self._cdata, other._cdata, 1,
+                                                             *limits)
+                return None if result == _UNKNOWN else bool(result)
+            return bool(lib.boolexpr_BoolExpr_equiv(self._cdata, other._cdata))
+        num, c_vars, c_consts = _convert_point(point)
+        return bool(lib.boolexpr_BoolExpr_equiv_assuming(self._cdata, other._cdata,
+                                                         num, c_vars, c_consts))
+
+    def count_sat(self):
+        """Return the number of satisfying points over the support.
+
+        The count is exact.
+        It uses a model counter with component caching,
+        so it scales far beyond enumerating with ``iter_sat``.
+        """
+        data = bytes(_String(lib.boolexpr_BoolExpr_count_sat(self._cdata)))
+        return int(data)
+
+    def approx_count_sat(self, epsilon=0.8, delta=0.2, seed=1):
+        """Return an estimate of the number of satisfying points.
+
+        With probability at least ``1 - delta``,
+        the estimate is within a factor of ``1 + epsilon`` of the exact count.
+
+        Random XOR constraints split the input space into small cells,
+        and the solver enumerates a bounded number of solutions per cell.
+        Use this when the problem is too large for ``count_sat``.
+        """
+        cdata = lib.boolexpr_BoolExpr_approx_count_sat(self._cdata, epsilon, delta, seed)
+        return int(bytes(_String(cdata)))
 
     def support(self):
         """Return the support set of the expression."""
@@ -735,6 +1542,41 @@ class BoolExpr:
             c_vars[i] = _expect_var(x)._cdata
         return _bx(lib.boolexpr_BoolExpr_derivative(self._cdata, num, c_vars))
 
+    def npn_class(self):
+        """Return the NPN class of the function, as a tuple (n, table).
+
+        Two functions are NPN equivalent if one becomes the other
+        by negating and permuting its inputs, and negating its output.
+        The class is the canonical truth table over the *n* inputs
+        the function depends on, where bit m of the *table* int
+        is its value at minterm m.
+        Up to six inputs, equivalent functions always get the same class.
+        Beyond six, the canonical form is heuristic.
+
+        The expression must contain at most 16 variables,
+        and it must not contain an unknown constant.
+        """
+        if len(self.support()) > _TT_MAX_VARS:
+            raise ValueError("expected at most {} variables".format(_TT_MAX_VARS))
+        _expect_known(self)
+        c_nvars = ffi.new("uint32_t *")
+        c_words = ffi.new("uint64_t []", 1 << (_TT_MAX_VARS - 6))
+        if not lib.boolexpr_BoolExpr_npn_class(self._cdata, c_nvars, c_words):
+            raise ValueError("expected a small, known expression")
+        n = c_nvars[0]
+        table = 0
+        for k in range(max(1, 1 << n >> 6)):
+            table |= c_words[k] << (64 * k)
+        return n, table & ((1 << (1 << n)) - 1)
+
+    def compile(self):
+        """Return a :class:`CompiledExpr` for fast repeated evaluation.
+
+        The expression must not contain an unknown constant.
+        """
+        _expect_known(self)
+        return CompiledExpr(self)
+
     def iter_dfs(self):
         """Iterate through all expression nodes in DFS order."""
         yield from _DfsIter(lib.boolexpr_DfsIter_new(self._cdata))
@@ -1064,7 +1906,180 @@ def onehot(*args):
     return _bx(lib.boolexpr_onehot(num, c_bxs))
 
 
-_LITS = dict()
+_AMO_ENCODINGS = {
+    "pairwise"   : lib.AMO_PAIRWISE,
+    "seqcounter" : lib.AMO_SEQCOUNTER,
+    "commander"  : lib.AMO_COMMANDER,
+    "product"    : lib.AMO_PRODUCT,
+}
+
+_CARD_ENCODINGS = {
+    "seqcounter" : lib.CARD_SEQCOUNTER,
+    "totalizer"  : lib.CARD_TOTALIZER,
+    "sortnet"    : lib.CARD_SORTNET,
+}
+
+
+def _expect_encoding(encoding, encodings):
+    """Return the C code for an encoding name, or raise ValueError."""
+    try:
+        return encodings[encoding]
+    except KeyError:
+        fstr = "expected encoding in {}, got {!r}"
+        raise ValueError(fstr.format(sorted(encodings), encoding))
+
+
+def at_most_one(*args, ctx=None, encoding="seqcounter", auxvarname="a"):
+    """
+    Return a CNF expression that means
+    "at most one input function is true".
+
+    Unlike ``onehot0``, the result is not logically equivalent to the
+    constraint, but it is equisatisfiable,
+    and its size is linear in the number of inputs.
+    Auxiliary variables are created in context *ctx*,
+    and they do not appear in satisfying points.
+
+    The *encoding* is one of
+    ``"pairwise"``, ``"seqcounter"``, ``"commander"``, or ``"product"``.
+    """
+    if ctx is None:
+        ctx = ROOT_CONTEXT
+    code = _expect_encoding(encoding, _AMO_ENCODINGS)
+    num, c_bxs = _convert_args(args)
+    name = auxvarname.encode("ascii")
+    return _bx(lib.boolexpr_at_most_one(ctx._cdata, num, c_bxs, code, name))
+
+
+def exactly_one(*args, ctx=None, encoding="seqcounter", auxvarname="a"):
+    """
+    Return a CNF expression that means
+    "exactly one input function is true".
+
+    See ``at_most_one`` for a description of the parameters.
+    """
+    if ctx is None:
+        ctx = ROOT_CONTEXT
+    code = _expect_encoding(encoding, _AMO_ENCODINGS)
+    num, c_bxs = _convert_args(args)
+    name = auxvarname.encode("ascii")
+    return _bx(lib.boolexpr_exactly_one(ctx._cdata, num, c_bxs, code, name))
+
+
+def at_most_k(k, *args, ctx=None, encoding="totalizer", auxvarname="a"):
+    """
+    Return a CNF expression that means
+    "at most *k* input functions are true".
+
+    The result is equisatisfiable with the constraint.
+    Auxiliary variables are created in context *ctx*,
+    and they do not appear in satisfying points.
+
+    The *encoding* is one of
+    ``"seqcounter"``, ``"totalizer"``, or ``"sortnet"``.
+    """
+    if ctx is None:
+        ctx = ROOT_CONTEXT
+    code = _expect_encoding(encoding, _CARD_ENCODINGS)
+    num, c_bxs = _convert_args(args)
+    name = auxvarname.encode("ascii")
+    return _bx(lib.boolexpr_at_most_k(ctx._cdata, num, c_bxs, k, code, name))
+
+
+def at_least_k(k, *args, ctx=None, encoding="totalizer", auxvarname="a"):
+    """
+    Return a CNF expression that means
+    "at least *k* input functions are true".
+
+    See ``at_most_k`` for a description of the parameters.
+    """
+    if ctx is None:
+        ctx = ROOT_CONTEXT
+    code = _expect_encoding(encoding, _CARD_ENCODINGS)
+    num, c_bxs = _convert_args(args)
+    name = auxvarname.encode("ascii")
+    return _bx(lib.boolexpr_at_least_k(ctx._cdata, num, c_bxs, k, code, name))
+
+
+def exactly_k(k, *args, ctx=None, encoding="totalizer", auxvarname="a"):
+    """
+    Return a CNF expression that means
+    "exactly *k* input functions are true".
+
+    See ``at_most_k`` for a description of the parameters.
+    """
+    if ctx is None:
+        ctx = ROOT_CONTEXT
+    code = _expect_encoding(encoding, _CARD_ENCODINGS)
+    num, c_bxs = _convert_args(args)
+    name = auxvarname.encode("ascii")
+    return _bx(lib.boolexpr_exactly_k(ctx._cdata, num, c_bxs, k, code, name))
+
+
+_PB_ENCODINGS = {
+    "auto"  : lib.PB_AUTO,
+    "bdd"   : lib.PB_BDD,
+    "adder" : lib.PB_ADDER,
+    "gte"   : lib.PB_GTE,
+}
+
+
+def _pb(cfunc, terms, k, ctx, encoding, auxvarname):
+    if ctx is None:
+        ctx = ROOT_CONTEXT
+    code = _expect_encoding(encoding, _PB_ENCODINGS)
+    terms = list(terms)
+    num, c_bxs = _convert_args([x for _, x in terms])
+    c_weights = ffi.new("int64_t []", [w for w, _ in terms])
+    name = auxvarname.encode("ascii")
+    cdata = cfunc(ctx._cdata, num, c_bxs, c_weights, k, code, name)
+    if cdata == ffi.NULL:
+        raise ValueError("expected absolute weights that sum to at most 2**61")
+    return _bx(cdata)
+
+
+def pb_leq(terms, k, ctx=None, encoding="auto", auxvarname="a"):
+    """
+    Return a CNF expression that means
+    "the weighted sum of input functions is at most *k*".
+
+    The *terms* argument is a sequence of ``(weight, function)`` pairs,
+    where weights are ``int``, and may be negative.
+    The absolute weights must sum to at most ``2 ** 61``.
+
+    The result is equisatisfiable with the constraint.
+    Auxiliary variables are created in context *ctx*,
+    and they do not appear in satisfying points.
+
+    The *encoding* is one of
+    ``"auto"``, ``"bdd"``, ``"adder"``, or ``"gte"``
+    (generalized totalizer).
+    By default, it is chosen by the size of the constraint.
+    """
+    return _pb(lib.boolexpr_pb_leq, terms, k, ctx, encoding, auxvarname)
+
+
+def pb_geq(terms, k, ctx=None, encoding="auto", auxvarname="a"):
+    """
+    Return a CNF expression that means
+    "the weighted sum of input functions is at least *k*".
+
+    See ``pb_leq`` for a description of the parameters.
+    """
+    return _pb(lib.boolexpr_pb_geq, terms, k, ctx, encoding, auxvarname)
+
+
+def pb_eq(terms, k, ctx=None, encoding="auto", auxvarname="a"):
+    """
+    Return a CNF expression that means
+    "the weighted sum of input functions equals *k*".
+
+    See ``pb_leq`` for a description of the parameters.
+    """
+    return _pb(lib.boolexpr_pb_eq, terms, k, ctx, encoding, auxvarname)
+
+
+_LITS = weakref.WeakValueDictionary()
 
 _KIND2CONST = {
     lib.ZERO : ZERO,
@@ -1182,6 +2197,40 @@ def _convert_args(args):
     return num, c_args
 
 
+def _expect_known(bx):
+    """Raise ValueError if an expression contains an unknown constant."""
+    for node in bx.iter_dfs():
+        if node.kind in (BoolExpr.Kind.log, BoolExpr.Kind.ill):
+            raise ValueError("expected no unknown constants")
+
+
+_BDD_REORDERS = {
+    "none"       : lib.BDD_REORDER_NONE,
+    "sift"       : lib.BDD_REORDER_SIFT,
+    "group_sift" : lib.BDD_REORDER_GROUP_SIFT,
+}
+
+
+def _expect_reorder(method):
+    """Return the C code for a reordering method, or raise ValueError."""
+    try:
+        return _BDD_REORDERS[method]
+    except KeyError:
+        fstr = "expected method in {}, got {!r}"
+        raise ValueError(fstr.format(sorted(_BDD_REORDERS), method))
+
+
+def _convert_point(point):
+    """Convert a Python {Variable: Constant} dict to C [Variable], [Constant]."""
+    num = len(point)
+    c_vars = ffi.new("void * []", num)
+    c_consts = ffi.new("void * []", num)
+    for i, (var, const) in enumerate(point.items()):
+        c_vars[i] = _expect_var(var)._cdata
+        c_consts[i] = _expect_const(const)._cdata
+    return num, c_vars, c_consts
+
+
 def _bx(cbx):
     kind = lib.boolexpr_BoolExpr_kind(cbx)
     if kind in _KIND2CONST:
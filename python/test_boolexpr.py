@@ -13,8 +13,13 @@
 # limitations under the License.
 
 
+import os
+import subprocess
+import sys
+import tempfile
 import unittest
 
+import boolexpr
 from boolexpr import *
 
 
@@ -36,6 +41,20 @@ class ContextTest(unittest.TestCase):
         ctx = Context()
         del ctx
 
+    def test_scope(self):
+        ctx = Context()
+        a, b = map(ctx.get_var, "ab")
+        f = xor(a, b, a & b)
+        with ctx.scope():
+            self.assertTrue(f.tseytin(ctx).is_cnf())
+        ctx.push_scope()
+        g = f.tseytin(ctx)
+        self.assertFalse(ctx.pop_scope())
+        del g
+        self.assertTrue(ctx.pop_scope())
+        with self.assertRaises(ValueError):
+            ctx.pop_scope()
+
 
 class BoolExprTest(unittest.TestCase):
 
@@ -558,6 +577,307 @@ array([[x[1,3,7], x[1,4,7], x[1,5,7], x[1,6,7]],
         with self.assertRaises(ValueError):
             nhot(9, *B)
 
+    def test_card(self):
+        ctx = Context()
+        for encoding in ("seqcounter", "totalizer", "sortnet"):
+            for i in range(6):
+                f = nhot(i, *B, ctx=ctx, encoding=encoding)
+                pnts = list(f.iter_sat())
+                self.assertEqual(len(pnts), len(list(nhot(i, *B).iter_sat())))
+                for pnt in pnts:
+                    self.assertEqual(sum(bool(v) for v in pnt.values()), i)
+        for encoding in ("pairwise", "seqcounter", "commander", "product"):
+            f = exactly_one(*B, ctx=ctx, encoding=encoding)
+            self.assertEqual(len(list(f.iter_sat())), 8)
+        with self.assertRaises(ValueError):
+            at_most_one(*B, encoding="bogus")
+
+    def test_pb(self):
+        ctx = Context()
+        ws = (3, -2, 5, 1, 4, 2)
+        terms = list(zip(ws, B))
+        for encoding in ("auto", "bdd", "adder", "gte"):
+            f = pb_eq(terms, 4, ctx=ctx, encoding=encoding)
+            pnts = list(f.iter_sat())
+            self.assertEqual(len(pnts), 5)
+            for pnt in pnts:
+                self.assertEqual(sum(w * int(pnt[x]) for w, x in terms), 4)
+        with self.assertRaises(ValueError):
+            pb_leq([(-2 ** 63, B[0]), (1, B[1])], 0, ctx=ctx)
+
+    def test_sat_session(self):
+        a, b, c = map(ctx.get_var, "abc")
+        s = SatSession()
+        s.add(onehot(a, b, c))
+        self.assertEqual(s.solve(a), (True, {a: ONE, b: ZERO, c: ZERO}))
+        self.assertEqual(s.solve(a, b), (False, None))
+        self.assertEqual(s.solve(~a, ~c), (True, {a: ZERO, b: ONE, c: ZERO}))
+        s.add(~b, ~c)
+        self.assertEqual(s.solve(), (True, {a: ONE, b: ZERO, c: ZERO}))
+        self.assertEqual(s.solve(~a), (False, None))
+        with self.assertRaises(TypeError):
+            s.solve(a | b)
+
+    def test_portfolio(self):
+        a, b, c = map(ctx.get_var, "abc")
+        f = onehot(a, b, c) & (a | c)
+        sat, point = f.sat(nthreads=4)
+        self.assertTrue(sat)
+        self.assertEqual(f.restrict(point), ONE)
+        self.assertEqual((f & ~a & ~c).sat(nthreads=4), (False, None))
+        s = SatSession(nthreads=4)
+        s.add(onehot(a, b, c))
+        self.assertEqual(s.solve(a), (True, {a: ONE, b: ZERO, c: ZERO}))
+        self.assertEqual(s.solve(a, b), (False, None))
+
+    def test_cube_and_conquer(self):
+        a, b, c, d = map(ctx.get_var, "abcd")
+        f = onehot(a, b, c, d) & (c | d)
+        sat, point = f.sat(nthreads=2, cube_depth=2)
+        self.assertTrue(sat)
+        self.assertEqual(f.restrict(point), ONE)
+        self.assertEqual((f & ~c & ~d).sat(nthreads=2, cube_depth=2), (False, None))
+
+    def test_remote_sat(self):
+        a, b, c, d = map(ctx.get_var, "abcd")
+        f = onehot(a, b, c, d) & (c | d)
+        tmpdir = tempfile.mkdtemp()
+        paths = [os.path.join(tmpdir, "worker%d" % i) for i in range(2)]
+        env = dict(os.environ)
+        env["PYTHONPATH"] = os.path.dirname(os.path.dirname(boolexpr.__file__))
+        code = "import sys, boolexpr; sys.exit(not boolexpr.serve_cubes(sys.argv[1]))"
+        procs = [subprocess.Popen([sys.executable, "-c", code, path], env=env)
+                 for path in paths]
+        sat, point = f.sat(cube_depth=2, workers=paths)
+        for proc in procs:
+            self.assertEqual(proc.wait(), 0)
+        os.rmdir(tmpdir)
+        self.assertTrue(sat)
+        self.assertEqual(f.restrict(point), ONE)
+
+    def test_sat_limits(self):
+        xs = [ctx.get_var("h_" + str(i)) for i in range(56)]
+        # Eight pigeons in seven holes
+        f = and_(*[or_(*xs[7*i:7*i+7]) for i in range(8)],
+                 *[~xs[7*i+j] | ~xs[7*k+j]
+                   for j in range(7) for i in range(8) for k in range(i+1, 8)])
+        self.assertEqual(f.sat(conflicts=10), (None, None))
+        self.assertEqual(f.sat(propagations=10, nthreads=2), (None, None))
+        self.assertIsNone(f.equiv(ZERO, conflicts=10))
+        a, b = map(ctx.get_var, "ab")
+        self.assertTrue((~(a & b)).equiv(~a | ~b, timeout=10))
+        self.assertEqual((a & b).sat(conflicts=10), (True, {a: ONE, b: ONE}))
+        stop = SatInterrupt()
+        stop.interrupt()
+        self.assertEqual(f.sat(interrupt=stop), (None, None))
+        stop.reset()
+        self.assertEqual((a & ~a).sat(interrupt=stop), (False, None))
+        # Limits with a point apply to the restricted expression
+        self.assertEqual((f | a).sat({a: 0}, conflicts=10), (None, None))
+        self.assertEqual((a & b).sat({a: 1}, conflicts=10), (True, {b: ONE}))
+        self.assertIsNone(f.equiv(ZERO | a, {a: 0}, conflicts=10))
+        self.assertTrue((a & b).equiv(b, {a: 1}, timeout=10))
+        with self.assertRaises(ValueError):
+            f.sat(cube_depth=2, workers=["unused"], timeout=1)
+
+    def test_equiv_many(self):
+        a, b, c = map(ctx.get_var, "abc")
+        f = onehot(a, b, c)
+        g = (a | b | c) & (~a | ~b) & (~a | ~c) & (~b | ~c)
+        self.assertEqual(equiv_many([(f, g), (f, ~g), (a, a), (a & b, b & a)]),
+                         [True, False, True, True])
+        self.assertEqual(equiv_many([]), [])
+
+    def test_simulate(self):
+        a, b, c = map(ctx.get_var, "abc")
+        pats = {a: 0b11110000, b: 0b11001100, c: 0b10101010}
+        self.assertEqual(simulate(a & b | c, pats, num=8), 0b11101010)
+        self.assertEqual(simulate(~a ^ b, pats, num=8), 0b11000011)
+        self.assertEqual(simulate(a & ~a, pats, num=8), 0)
+        # Wide patterns span several words
+        x = (1 << 200) - 1
+        self.assertEqual(simulate(a | b, {a: x, b: 1 << 250}, num=256),
+                         x | 1 << 250)
+        self.assertEqual(simulate(or_(ONE, ZERO), {}, num=100), (1 << 100) - 1)
+        with self.assertRaises(ValueError):
+            simulate(a | b, {a: 1})
+
+    def test_compile(self):
+        a, b, c = map(ctx.get_var, "abc")
+        f = ite(a, b ^ c, ~b)
+        prog = f.compile()
+        self.assertEqual(set(prog.inputs), {a, b, c})
+        points = list(range(8))
+        expected = []
+        for j in points:
+            point = {x: (j >> i) & 1 for i, x in enumerate(prog.inputs)}
+            expected.append(f.restrict(point) is ONE)
+        self.assertEqual([prog.eval(j) for j in points], expected)
+        self.assertEqual(prog.eval_many(points * 50), expected * 50)
+        self.assertEqual(prog.eval_many([]), [])
+        with self.assertRaises(ValueError):
+            (a | LOGICAL).compile()
+
+    def test_npn_class(self):
+        a, b, c, d = map(ctx.get_var, "abcd")
+        self.assertEqual((a & ~b).npn_class(), (~c | d).npn_class())
+        self.assertNotEqual((a & b).npn_class(), (a ^ b).npn_class())
+        self.assertEqual((a & b | c & ~c).npn_class()[0], 2)
+        self.assertEqual(ONE.npn_class(), (0, 0))
+        with self.assertRaises(ValueError):
+            (a | LOGICAL).npn_class()
+
+    def test_bdd(self):
+        a, b, c = map(ctx.get_var, "abc")
+        mgr = BddManager(ctx)
+        f = mgr.to_bdd(a & b | ~a & c)
+        self.assertEqual(f, mgr.ite(mgr.to_bdd(a), mgr.to_bdd(b), mgr.to_bdd(c)))
+        self.assertEqual(~f | mgr.to_bdd(b), mgr.to_bdd(a | ~c | b))
+        self.assertTrue((f ^ f).is_zero())
+        self.assertEqual(f.restrict({a: 1}), mgr.to_bdd(b))
+        self.assertEqual(f.exists([b, c]), mgr.one())
+        self.assertEqual(f.forall(a), mgr.to_bdd(b & c))
+        self.assertEqual(f.support(), (a, b, c))
+        self.assertEqual(mgr.order, (a, b, c))
+        self.assertEqual(f.size, 4)
+        self.assertEqual(f.sat_count(), 4)
+        points = list(f.iter_sat())
+        self.assertEqual(len(points), 4)
+        for point in points:
+            self.assertIs((a & b | ~a & c).restrict(point), ONE)
+        self.assertTrue(f.to_bx().equiv(a & b | ~a & c))
+        g = mgr.to_bdd(xor(*[ctx.get_var("p_" + str(i)) for i in range(80)]))
+        self.assertEqual(g.sat_count(), 1 << 79)
+        del g
+        mgr.gc()
+        self.assertEqual(mgr.nodes, f.size - 1)
+        with self.assertRaises(ValueError):
+            mgr.to_bdd(a | LOGICAL)
+        with self.assertRaises(ValueError):
+            mgr.to_bdd(Context().get_var("a"))
+        # A variable of another context may have the same id
+        other = Context().get_var("a")
+        with self.assertRaises(ValueError):
+            f.exists([other])
+        with self.assertRaises(ValueError):
+            f.forall(other)
+        with self.assertRaises(ValueError):
+            f.restrict({other: 0})
+        with self.assertRaises(TypeError):
+            f & BddManager(ctx).one()
+
+    def test_bdd_reorder(self):
+        xs = [ctx.get_var("r_" + str(i)) for i in range(12)]
+        f = or_(*[xs[i] & xs[6 + i] for i in range(6)])
+        mgr = BddManager(ctx)
+        bdd = mgr.to_bdd(f)
+        self.assertEqual(bdd.size, 127)
+        mgr.reorder("sift")
+        self.assertEqual(bdd.size, 13)
+        self.assertEqual(bdd, mgr.to_bdd(f))
+        mgr.set_order(xs)
+        self.assertEqual(mgr.order, tuple(xs))
+        self.assertEqual(bdd.size, 127)
+        mgr.group(xs[:6])
+        mgr.group(xs[6:])
+        mgr.reorder("group_sift")
+        self.assertEqual(bdd.size, 127)
+        with self.assertRaises(ValueError):
+            mgr.reorder("random")
+        self.assertEqual(dfs_order(f), tuple(x for i in range(6) for x in (xs[i], xs[6 + i])))
+        order = force_order(f)
+        self.assertEqual(set(order), set(xs))
+        mgr.set_order(order)
+        self.assertEqual(bdd.size, 13)
+
+    def test_bdd_threads(self):
+        xs = [ctx.get_var("r_" + str(i)) for i in range(12)]
+        f = or_(*[xs[i] & xs[6 + i] for i in range(6)])
+        seq = BddManager(ctx)
+        par = BddManager(ctx, nthreads=4)
+        a = seq.to_bdd(f)
+        b = par.to_bdd(f)
+        self.assertEqual(b.size, a.size)
+        self.assertEqual(b.sat_count(), a.sat_count())
+        self.assertTrue(b.exists([xs[0], xs[6]]).to_bx().equiv(a.exists([xs[0], xs[6]]).to_bx()))
+        self.assertTrue(par.ite(b, ~b, b).is_zero())
+
+    def test_zdd(self):
+        a, b, c = map(ctx.get_var, "abc")
+        mgr = ZddManager(ctx)
+        self.assertTrue(mgr.empty().is_empty())
+        self.assertTrue(mgr.base().is_base())
+        self.assertTrue(mgr.cube([a, ~a]).is_empty())
+        s = mgr.cube([a]) | mgr.cube([a, b]) | mgr.cube([~c])
+        self.assertEqual(s.count(), 3)
+        self.assertEqual(s.minimal(), mgr.cube([a]) | mgr.cube([~c]))
+        self.assertEqual((s - mgr.cube([a])).count(), 2)
+        self.assertEqual((s & mgr.cube([~c])), mgr.cube([~c]))
+        self.assertTrue((mgr.cube([a]) * mgr.cube([~a])).is_empty())
+        f = (a | b) & (~a | c)
+        dnf = mgr.dnf(f)
+        self.assertTrue(dnf.to_dnf().equiv(f))
+        self.assertTrue(mgr.cnf(f).to_cnf().equiv(f))
+        bdd = BddManager(ctx)
+        self.assertEqual(dnf.to_bdd(bdd), bdd.to_bdd(f))
+        cover = mgr.isop(bdd.to_bdd(f))
+        self.assertTrue(cover.to_dnf().equiv(f))
+        self.assertEqual(cover.count(), 2)
+        with self.assertRaises(ValueError):
+            mgr.isop(bdd.to_bdd(a), bdd.to_bdd(b))
+        with self.assertRaises(TypeError):
+            s | bdd.one()
+
+    def test_unsat_core(self):
+        a, b, c, d = map(ctx.get_var, "abcd")
+        self.assertEqual(unsat_core(a | b, ~a), ())
+        f = a | b
+        core = unsat_core(f, c, ~a, d, ~b)
+        self.assertEqual(and_(*core).sat(), (False, None))
+        mus = unsat_core(f, c, ~a, d, ~b, minimal=True)
+        self.assertEqual([str(g) for g in mus], ["Or(a, b)", "~a", "~b"])
+
+    def test_sat_assuming(self):
+        a, b, c = map(ctx.get_var, "abc")
+        f = onehot(a, b, c)
+        self.assertEqual(f.sat({a: 1}), (True, {b: ZERO, c: ZERO}))
+        self.assertEqual(f.sat({a: 1, b: 1}), (False, None))
+        self.assertEqual(f.sat({a: "x"}), (False, None))
+        g = a & b | c
+        self.assertTrue(g.equiv(c, {a: 0}))
+        self.assertFalse(g.equiv(c, {a: 1}))
+        self.assertTrue(c.equiv(g, {b: 0}))
+        cache = AssumptionCache(g)
+        for point in ({a: 0}, {b: 0}, {a: 1, b: 1}):
+            self.assertEqual(cache.sat(point)[0], g.restrict(point).sat()[0])
+        self.assertTrue(cache.equiv(c, {a: 0}))
+        self.assertFalse(cache.equiv(c, {a: 1}))
+
+    def test_iter_sat_project(self):
+        a, b, c, d = map(ctx.get_var, "abcd")
+        f = a & b | c
+        cubes = list(f.iter_sat(project=[a, b, c, d]))
+        self.assertLessEqual(len(cubes), 3)
+        for cube in cubes:
+            self.assertTrue(f.restrict(cube).equiv(ONE))
+        pnts = set()
+        for cube in cubes:
+            for pnt in iter_points([x for x in (a, b, c, d) if x not in cube]):
+                pnt.update(cube)
+                pnts.add(frozenset(pnt.items()))
+        self.assertEqual(len(pnts), 10)
+
+    def test_count_sat(self):
+        xs = ctx.get_vars("cs", 100)
+        self.assertEqual(ZERO.count_sat(), 0)
+        self.assertEqual(ONE.count_sat(), 1)
+        self.assertEqual(onehot(*xs[:8]).count_sat(), 8)
+        self.assertEqual(or_(*xs).count_sat(), 2**100 - 1)
+        self.assertEqual(xor(*xs).count_sat(), 2**99)
+        self.assertEqual(onehot(*xs[:8]).approx_count_sat(), 8)
+        approx = or_(*xs[:10]).approx_count_sat(epsilon=2.0, delta=0.8)
+        self.assertTrue(1023 / 3 <= approx <= 1023 * 3)
+
 
 if __name__ == "__main__":
     unittest.main()
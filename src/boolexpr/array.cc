@@ -197,8 +197,13 @@ bool Array::equiv(Array const& other) const {
         return false;
     }
 
+    vector<std::pair<bx_t, bx_t>> pairs;
     for (size_t i = 0; i < this->items.size(); ++i) {
-        if (!this->items[i]->equiv(other.items[i])) {
+        pairs.push_back(make_pair(this->items[i], other.items[i]));
+    }
+
+    for (bool result : equiv_many(pairs)) {
+        if (!result) {
             return false;
         }
     }
@@ -0,0 +1,922 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // fill, max, min, sort, unique
+#include <cassert>
+#include <unordered_map>
+
+#include "boolexpr/boolexpr.h"
+#include "bdd.h"
+
+using std::atomic;
+using std::unordered_map;
+using std::vector;
+
+using boost::multiprecision::cpp_int;
+
+namespace boolexpr {
+
+static size_t const MIN_BUCKETS = 16;
+static size_t const MIN_GC_LIMIT = 1 << 16;
+static size_t const CACHE_SIZE = 1 << 18;
+static size_t const MIN_REORDER_LIMIT = 1 << 12;
+
+Bdd::Bdd() : mgr{nullptr}, e{BDD_ZERO} {}
+
+Bdd::Bdd(BddManager *mgr, uint32_t e) : mgr{mgr}, e{e} { mgr->ref(e); }
+
+Bdd::Bdd(Bdd const &f) : mgr{f.mgr}, e{f.e} {
+    if (mgr) {
+        mgr->ref(e);
+    }
+}
+
+Bdd::Bdd(Bdd &&f) : mgr{f.mgr}, e{f.e} { f.mgr = nullptr; }
+
+Bdd::~Bdd() {
+    if (mgr) {
+        mgr->deref(e);
+    }
+}
+
+Bdd &Bdd::operator=(Bdd const &f) {
+    if (f.mgr) {
+        f.mgr->ref(f.e);
+    }
+    if (mgr) {
+        mgr->deref(e);
+    }
+    mgr = f.mgr;
+    e = f.e;
+    return *this;
+}
+
+Bdd &Bdd::operator=(Bdd &&f) {
+    if (this != &f) {
+        if (mgr) {
+            mgr->deref(e);
+        }
+        mgr = f.mgr;
+        e = f.e;
+        f.mgr = nullptr;
+    }
+    return *this;
+}
+
+bool Bdd::is_zero() const { return e == BDD_ZERO; }
+
+bool Bdd::is_one() const { return e == BDD_ONE; }
+
+Bdd Bdd::operator~() const { return Bdd(mgr, e ^ 1); }
+
+Bdd Bdd::operator&(Bdd const &g) const {
+    assert(mgr && mgr == g.mgr);
+    mgr->maybe_gc();
+    return Bdd(mgr, mgr->apply(OP_AND, e, g.e, 0));
+}
+
+Bdd Bdd::operator|(Bdd const &g) const {
+    assert(mgr && mgr == g.mgr);
+    mgr->maybe_gc();
+    return Bdd(mgr, mgr->apply(OP_AND, e ^ 1, g.e ^ 1, 0) ^ 1);
+}
+
+Bdd Bdd::operator^(Bdd const &g) const {
+    assert(mgr && mgr == g.mgr);
+    mgr->maybe_gc();
+    return Bdd(mgr, mgr->apply(OP_XOR, e, g.e, 0));
+}
+
+bool Bdd::operator==(Bdd const &g) const { return mgr == g.mgr && e == g.e; }
+
+bool Bdd::operator!=(Bdd const &g) const { return !(*this == g); }
+
+BddManager::BddManager(Context &ctx, uint32_t nthreads)
+    : ctx(ctx),
+      table(1),
+      free_list{0},
+      nlive{0},
+      gc_limit{MIN_GC_LIMIT},
+      cache(CACHE_SIZE),
+      auto_reorder{BddReorder::NONE},
+      reorder_limit{MIN_REORDER_LIMIT},
+      ngroups{0} {
+    assert(nthreads > 0);
+    table[0] = {FREE, BDD_ONE, BDD_ONE, 0, 0};
+    if (nthreads > 1) {
+        pool.reset(new BddPool(*this, nthreads));
+    }
+}
+
+BddManager::~BddManager() {}
+
+void BddManager::ref(uint32_t e) {
+    if (e >> 1) {
+        ++table[e >> 1].refs;
+    }
+}
+
+void BddManager::deref(uint32_t e) {
+    if (e >> 1) {
+        assert(table[e >> 1].refs > 0);
+        --table[e >> 1].refs;
+    }
+}
+
+// Intermediate results hold no references,
+// so only collect or reorder at the start of a top-level operation.
+void BddManager::maybe_gc() {
+    if (auto_reorder != BddReorder::NONE && nlive >= reorder_limit) {
+        reorder(auto_reorder);
+        reorder_limit = std::max(MIN_REORDER_LIMIT, 2 * nlive);
+    }
+    if (nlive >= gc_limit) {
+        gc();
+        // Most nodes are live, so collect less often
+        if (2 * nlive > gc_limit) {
+            gc_limit *= 2;
+        }
+    }
+}
+
+void BddManager::gc() {
+    // A node holds a reference to each of its children,
+    // so dead nodes release their children in turn.
+    vector<bool> dead(table.size(), false);
+    vector<uint32_t> stack;
+    for (uint32_t i = 1; i < table.size(); ++i) {
+        if (table[i].var != FREE && table[i].refs == 0) {
+            dead[i] = true;
+            stack.push_back(i);
+        }
+    }
+    vector<uint32_t> freed;
+    while (!stack.empty()) {
+        auto i = stack.back();
+        stack.pop_back();
+        freed.push_back(i);
+        for (auto child : {table[i].lo, table[i].hi}) {
+            auto j = child >> 1;
+            if (j && --table[j].refs == 0) {
+                dead[j] = true;
+                stack.push_back(j);
+            }
+        }
+    }
+
+    if (freed.empty()) {
+        return;
+    }
+
+    for (auto &sub : subtables) {
+        for (auto &bucket : sub.buckets) {
+            auto head = bucket.load(std::memory_order_relaxed);
+            while (head && dead[head]) {
+                head = table[head].next;
+                --sub.keys;
+            }
+            bucket.store(head, std::memory_order_relaxed);
+            for (auto i = head; i;) {
+                auto j = table[i].next;
+                if (j && dead[j]) {
+                    table[i].next = table[j].next;
+                    --sub.keys;
+                } else {
+                    i = j;
+                }
+            }
+        }
+    }
+
+    for (auto i : freed) {
+        table[i].var = FREE;
+        table[i].next = free_list;
+        free_list = i;
+    }
+    nlive -= freed.size();
+
+    // Entries may name freed nodes
+    clear_cache();
+}
+
+void BddManager::clear_cache() {
+    std::fill(cache.begin(), cache.end(), CacheEntry{0, 0, 0, 0, 0});
+    if (pool) {
+        pool->clear_cache();
+    }
+}
+
+uint32_t BddManager::index(var_t const &x) {
+    assert(x->ctx == &ctx);
+
+    uint32_t v = x->id >> 1;
+    if (v >= index2var.size()) {
+        index2var.resize(v + 1);
+        var2level.resize(v + 1, NO_LEVEL);
+        subtables.resize(v + 1);
+        var2group.resize(v + 1, NO_GROUP);
+    }
+    if (!index2var[v]) {
+        index2var[v] = x;
+        var2level[v] = level2var.size();
+        level2var.push_back(v);
+        subtables[v].buckets = vector<atomic<uint32_t>>(MIN_BUCKETS);
+        subtables[v].keys = 0;
+    }
+    return v;
+}
+
+uint32_t BddManager::level(uint32_t e) const {
+    auto i = e >> 1;
+    return i == 0 ? NO_LEVEL : var2level[table[i].var];
+}
+
+uint32_t BddManager::cofactor(uint32_t e, uint32_t v, bool val) const {
+    auto i = e >> 1;
+    if (i == 0 || table[i].var != v) {
+        return e;
+    }
+    return (val ? table[i].hi : table[i].lo) ^ (e & 1);
+}
+
+uint32_t BddManager::mk(uint32_t v, uint32_t lo, uint32_t hi) {
+    if (lo == hi) {
+        return lo;
+    }
+
+    // Keep the high edge regular
+    uint32_t c = hi & 1;
+    lo ^= c;
+    hi ^= c;
+
+    auto const &sub = subtables[v];
+    auto b = hash2(lo, hi) & (sub.buckets.size() - 1);
+    for (auto i = sub.buckets[b].load(std::memory_order_relaxed); i;
+         i = table[i].next) {
+        if (table[i].lo == lo && table[i].hi == hi) {
+            return i << 1 | c;
+        }
+    }
+
+    uint32_t i;
+    if (free_list) {
+        i = free_list;
+        free_list = table[i].next;
+    } else {
+        i = table.size();
+        table.push_back(Node());
+    }
+    table[i] = {v, lo, hi, 0, 0};
+    link(i);
+    ++nlive;
+
+    ref(lo);
+    ref(hi);
+
+    return i << 1 | c;
+}
+
+void BddManager::link(uint32_t i) {
+    auto &sub = subtables[table[i].var];
+    auto b = hash2(table[i].lo, table[i].hi) & (sub.buckets.size() - 1);
+    table[i].next = sub.buckets[b].load(std::memory_order_relaxed);
+    sub.buckets[b].store(i, std::memory_order_relaxed);
+    ++sub.keys;
+
+    if (sub.keys > 2 * sub.buckets.size()) {
+        resize(sub);
+    }
+}
+
+void BddManager::unlink(uint32_t i) {
+    auto &sub = subtables[table[i].var];
+    auto b = hash2(table[i].lo, table[i].hi) & (sub.buckets.size() - 1);
+    auto &head = sub.buckets[b];
+    if (head.load(std::memory_order_relaxed) == i) {
+        head.store(table[i].next, std::memory_order_relaxed);
+    } else {
+        auto p = head.load(std::memory_order_relaxed);
+        while (table[p].next != i) {
+            p = table[p].next;
+        }
+        table[p].next = table[i].next;
+    }
+    --sub.keys;
+}
+
+void BddManager::release(uint32_t e) {
+    auto i = e >> 1;
+    if (i && --table[i].refs == 0) {
+        unlink(i);
+        release(table[i].lo);
+        release(table[i].hi);
+        table[i].var = FREE;
+        table[i].next = free_list;
+        free_list = i;
+        --nlive;
+    }
+}
+
+void BddManager::resize(Subtable &sub) {
+    vector<atomic<uint32_t>> buckets(2 * sub.buckets.size());
+    auto mask = buckets.size() - 1;
+    for (auto const &head : sub.buckets) {
+        for (auto i = head.load(std::memory_order_relaxed); i;) {
+            auto next = table[i].next;
+            auto b = hash2(table[i].lo, table[i].hi) & mask;
+            table[i].next = buckets[b].load(std::memory_order_relaxed);
+            buckets[b].store(i, std::memory_order_relaxed);
+            i = next;
+        }
+    }
+    sub.buckets.swap(buckets);
+}
+
+bool BddManager::lookup(uint32_t op, uint32_t f, uint32_t g, uint32_t h,
+                        uint32_t &r) {
+    auto const &entry = cache[hash4(op, f, g, h) & (cache.size() - 1)];
+    if (entry.op == op && entry.f == f && entry.g == g && entry.h == h) {
+        r = entry.r;
+        return true;
+    }
+    return false;
+}
+
+void BddManager::insert(uint32_t op, uint32_t f, uint32_t g, uint32_t h,
+                        uint32_t r) {
+    cache[hash4(op, f, g, h) & (cache.size() - 1)] = {op, f, g, h, r};
+}
+
+uint32_t BddManager::apply_and(uint32_t f, uint32_t g) {
+    uint32_t r;
+    if (and_terminal(f, g, r)) {
+        return r;
+    }
+
+    if (lookup(OP_AND, f, g, 0, r)) {
+        return r;
+    }
+
+    auto v = level2var[std::min(level(f), level(g))];
+    auto lo = apply_and(cofactor(f, v, false), cofactor(g, v, false));
+    auto hi = apply_and(cofactor(f, v, true), cofactor(g, v, true));
+    r = mk(v, lo, hi);
+
+    insert(OP_AND, f, g, 0, r);
+    return r;
+}
+
+uint32_t BddManager::apply_xor(uint32_t f, uint32_t g) {
+    uint32_t c, r;
+    if (xor_terminal(f, g, c, r)) {
+        return r;
+    }
+
+    if (lookup(OP_XOR, f, g, 0, r)) {
+        return r ^ c;
+    }
+
+    auto v = level2var[std::min(level(f), level(g))];
+    auto lo = apply_xor(cofactor(f, v, false), cofactor(g, v, false));
+    auto hi = apply_xor(cofactor(f, v, true), cofactor(g, v, true));
+    r = mk(v, lo, hi);
+
+    insert(OP_XOR, f, g, 0, r);
+    return r ^ c;
+}
+
+uint32_t BddManager::apply_ite(uint32_t f, uint32_t g, uint32_t h) {
+    uint32_t c, r;
+    switch (ite_terminal(f, g, h, c, r)) {
+        case IteCase::DONE:
+            return r;
+        case IteCase::AND:
+            return apply_and(f, g) ^ c;
+        default:
+            break;
+    }
+
+    if (lookup(OP_ITE, f, g, h, r)) {
+        return r ^ c;
+    }
+
+    auto v = level2var[std::min({level(f), level(g), level(h)})];
+    auto lo = apply_ite(cofactor(f, v, false), cofactor(g, v, false),
+                        cofactor(h, v, false));
+    auto hi = apply_ite(cofactor(f, v, true), cofactor(g, v, true),
+                        cofactor(h, v, true));
+    r = mk(v, lo, hi);
+
+    insert(OP_ITE, f, g, h, r);
+    return r ^ c;
+}
+
+uint32_t BddManager::apply(uint32_t op, uint32_t f, uint32_t g, uint32_t h) {
+    if (pool) {
+        return pool->apply(op, f, g, h);
+    }
+    switch (op) {
+        case OP_AND:
+            return apply_and(f, g);
+        case OP_XOR:
+            return apply_xor(f, g);
+        case OP_ITE:
+            return apply_ite(f, g, h);
+        case OP_EXISTS:
+            return exists_cube(f, g);
+        default:
+            assert(false);  // LCOV_EXCL_LINE
+            return BDD_ZERO;
+    }
+}
+
+// The cube is a conjunction of positive literals
+uint32_t BddManager::exists_cube(uint32_t f, uint32_t cube) {
+    if ((f >> 1) == 0) {
+        return f;
+    }
+    auto lf = level(f);
+    while (cube != BDD_ONE && level(cube) < lf) {
+        cube = table[cube >> 1].hi;
+    }
+    if (cube == BDD_ONE) {
+        return f;
+    }
+
+    uint32_t r;
+    if (lookup(OP_EXISTS, f, cube, 0, r)) {
+        return r;
+    }
+
+    auto v = table[f >> 1].var;
+    auto f0 = cofactor(f, v, false);
+    auto f1 = cofactor(f, v, true);
+    if (level(cube) == lf) {
+        auto rest = table[cube >> 1].hi;
+        r = exists_cube(f0, rest);
+        if (r != BDD_ONE) {
+            r = apply_and(r ^ 1, exists_cube(f1, rest) ^ 1) ^ 1;
+        }
+    } else {
+        auto lo = exists_cube(f0, cube);
+        auto hi = exists_cube(f1, cube);
+        r = mk(v, lo, hi);
+    }
+
+    insert(OP_EXISTS, f, cube, 0, r);
+    return r;
+}
+
+// The cube is a conjunction of literals
+uint32_t BddManager::restrict_cube(uint32_t f, uint32_t cube) {
+    if ((f >> 1) == 0) {
+        return f;
+    }
+    auto lf = level(f);
+
+    // A literal is x & rest or ~x & rest, so one cofactor is zero
+    auto next = [this](uint32_t c, bool &val) {
+        auto v = table[c >> 1].var;
+        auto c0 = cofactor(c, v, false);
+        val = c0 == BDD_ZERO;
+        return val ? cofactor(c, v, true) : c0;
+    };
+
+    bool val;
+    while (cube != BDD_ONE && level(cube) < lf) {
+        cube = next(cube, val);
+    }
+    if (cube == BDD_ONE) {
+        return f;
+    }
+
+    uint32_t r;
+    if (lookup(OP_RESTRICT, f, cube, 0, r)) {
+        return r;
+    }
+
+    auto v = table[f >> 1].var;
+    if (level(cube) == lf) {
+        auto rest = next(cube, val);
+        r = restrict_cube(cofactor(f, v, val), rest);
+    } else {
+        auto lo = restrict_cube(cofactor(f, v, false), cube);
+        auto hi = restrict_cube(cofactor(f, v, true), cube);
+        r = mk(v, lo, hi);
+    }
+
+    insert(OP_RESTRICT, f, cube, 0, r);
+    return r;
+}
+
+uint32_t BddManager::cube(vector<var_t> const &xs) {
+    vector<uint32_t> vs;
+    for (auto const &x : xs) {
+        vs.push_back(index(x));
+    }
+    // Build from the bottom up
+    std::sort(vs.begin(), vs.end(), [this](uint32_t a, uint32_t b) {
+        return var2level[a] > var2level[b];
+    });
+    vs.erase(std::unique(vs.begin(), vs.end()), vs.end());
+
+    uint32_t r = BDD_ONE;
+    for (auto v : vs) {
+        r = mk(v, BDD_ZERO, r);
+    }
+    return r;
+}
+
+uint32_t BddManager::cube(point_t const &point) {
+    vector<std::pair<uint32_t, bool>> lits;
+    for (auto const &item : point) {
+        assert(IS_KNOWN(item.second));
+        lits.push_back({index(item.first), IS_ONE(item.second)});
+    }
+    std::sort(lits.begin(), lits.end(),
+              [this](std::pair<uint32_t, bool> const &a,
+                     std::pair<uint32_t, bool> const &b) {
+                  return var2level[a.first] > var2level[b.first];
+              });
+
+    uint32_t r = BDD_ONE;
+    for (auto const &lit : lits) {
+        if (lit.second) {
+            r = mk(lit.first, BDD_ZERO, r);
+        } else {
+            r = mk(lit.first, r, BDD_ZERO);
+        }
+    }
+    return r;
+}
+
+vector<uint32_t> BddManager::postorder(uint32_t e) const {
+    vector<uint32_t> order;
+    vector<bool> seen(table.size(), false);
+
+    // Each node is pushed once to expand it, and once to emit it
+    vector<std::pair<uint32_t, bool>> stack;
+    if (e >> 1) {
+        stack.push_back({e >> 1, false});
+    }
+    while (!stack.empty()) {
+        auto item = stack.back();
+        stack.pop_back();
+        auto i = item.first;
+        if (item.second) {
+            order.push_back(i);
+            continue;
+        }
+        if (seen[i]) {
+            continue;
+        }
+        seen[i] = true;
+        stack.push_back({i, true});
+        for (auto child : {table[i].hi, table[i].lo}) {
+            auto j = child >> 1;
+            if (j && !seen[j]) {
+                stack.push_back({j, false});
+            }
+        }
+    }
+
+    return order;
+}
+
+Bdd BddManager::zero() { return Bdd(this, BDD_ZERO); }
+
+Bdd BddManager::one() { return Bdd(this, BDD_ONE); }
+
+Bdd BddManager::var(var_t const &x) {
+    maybe_gc();
+    return Bdd(this, mk(index(x), BDD_ZERO, BDD_ONE));
+}
+
+Bdd BddManager::ite(Bdd const &f, Bdd const &g, Bdd const &h) {
+    assert(f.mgr == this && g.mgr == this && h.mgr == this);
+    maybe_gc();
+    return Bdd(this, apply(OP_ITE, f.e, g.e, h.e));
+}
+
+Bdd BddManager::restrict_(Bdd const &f, point_t const &point) {
+    assert(f.mgr == this);
+    maybe_gc();
+    return Bdd(this, restrict_cube(f.e, cube(point)));
+}
+
+Bdd BddManager::exists(Bdd const &f, vector<var_t> const &xs) {
+    assert(f.mgr == this);
+    maybe_gc();
+    return Bdd(this, apply(OP_EXISTS, f.e, cube(xs), 0));
+}
+
+Bdd BddManager::forall(Bdd const &f, vector<var_t> const &xs) {
+    assert(f.mgr == this);
+    maybe_gc();
+    return Bdd(this, apply(OP_EXISTS, f.e ^ 1, cube(xs), 0) ^ 1);
+}
+
+cpp_int BddManager::sat_count(Bdd const &f) {
+    assert(f.mgr == this);
+
+    auto nodes = postorder(f.e);
+
+    // Position of each support variable, from the top
+    vector<uint32_t> levels;
+    for (auto i : nodes) {
+        levels.push_back(var2level[table[i].var]);
+    }
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    uint32_t n = levels.size();
+
+    unordered_map<uint32_t, uint32_t> level2pos;
+    for (uint32_t k = 0; k < n; ++k) {
+        level2pos.insert({levels[k], k});
+    }
+    auto pos = [&](uint32_t e) {
+        return (e >> 1) ? level2pos[level(e)] : n;
+    };
+
+    // Number of points over the variables at or below an edge's position
+    unordered_map<uint32_t, cpp_int> counts;
+    auto count = [&](uint32_t e) -> cpp_int {
+        cpp_int c = (e >> 1) ? counts[e >> 1] : cpp_int(1);
+        if (e & 1) {
+            c = (cpp_int(1) << (n - pos(e))) - c;
+        }
+        return c;
+    };
+
+    for (auto i : nodes) {
+        auto p = pos(i << 1);
+        auto lo = table[i].lo;
+        auto hi = table[i].hi;
+        counts[i] = (count(lo) << (pos(lo) - p - 1)) +
+                    (count(hi) << (pos(hi) - p - 1));
+    }
+
+    return count(f.e) << pos(f.e);
+}
+
+vector<var_t> BddManager::support(Bdd const &f) {
+    assert(f.mgr == this);
+
+    vector<uint32_t> levels;
+    for (auto i : postorder(f.e)) {
+        levels.push_back(var2level[table[i].var]);
+    }
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+
+    vector<var_t> xs;
+    for (auto l : levels) {
+        xs.push_back(index2var[level2var[l]]);
+    }
+    return xs;
+}
+
+Bdd BddManager::to_bdd(bx_t const &bx) {
+    maybe_gc();
+
+    // Without a better order, add new variables in id order
+    auto s = bx->support();
+    vector<var_t> xs(s.begin(), s.end());
+    std::sort(xs.begin(), xs.end(), [](var_t const &a, var_t const &b) {
+        return a->id < b->id;
+    });
+    for (auto const &x : xs) {
+        index(x);
+    }
+
+    unordered_map<BoolExpr const *, uint32_t> memo;
+
+    for (auto it = dfs_iter(bx); it != dfs_iter(); ++it) {
+        auto const &node = *it;
+        uint32_t r = BDD_ZERO;
+
+        switch (node->kind) {
+            case BoolExpr::ZERO:
+                r = BDD_ZERO;
+                break;
+
+            case BoolExpr::ONE:
+                r = BDD_ONE;
+                break;
+
+            case BoolExpr::COMP:
+            case BoolExpr::VAR: {
+                auto x = std::static_pointer_cast<Literal const>(node);
+                r = mk(x->id >> 1, BDD_ZERO, BDD_ONE) ^ IS_COMP(x);
+                break;
+            }
+
+            default: {
+                assert(IS_OP(node));
+                auto op = std::static_pointer_cast<Operator const>(node);
+                vector<uint32_t> args;
+                for (auto const &arg : op->args) {
+                    args.push_back(memo[arg.get()]);
+                }
+
+                // Negative operators have even kinds
+                switch (node->kind | 1) {
+                    case BoolExpr::OR:
+                        r = BDD_ZERO;
+                        for (auto a : args) {
+                            r = apply(OP_AND, r ^ 1, a ^ 1, 0) ^ 1;
+                        }
+                        break;
+
+                    case BoolExpr::AND:
+                        r = BDD_ONE;
+                        for (auto a : args) {
+                            r = apply(OP_AND, r, a, 0);
+                        }
+                        break;
+
+                    case BoolExpr::XOR:
+                        r = BDD_ZERO;
+                        for (auto a : args) {
+                            r = apply(OP_XOR, r, a, 0);
+                        }
+                        break;
+
+                    case BoolExpr::EQ: {
+                        // All ones or all zeros
+                        uint32_t ones = BDD_ONE;
+                        uint32_t zeros = BDD_ONE;
+                        for (auto a : args) {
+                            ones = apply(OP_AND, ones, a, 0);
+                            zeros = apply(OP_AND, zeros, a ^ 1, 0);
+                        }
+                        r = apply(OP_AND, ones ^ 1, zeros ^ 1, 0) ^ 1;
+                        break;
+                    }
+
+                    case BoolExpr::IMPL:
+                        r = apply(OP_AND, args[0], args[1] ^ 1, 0) ^ 1;
+                        break;
+
+                    case BoolExpr::ITE:
+                        r = apply(OP_ITE, args[0], args[1], args[2]);
+                        break;
+
+                    default:
+                        assert(false);  // LCOV_EXCL_LINE
+                }
+
+                if (IS_NEG(node)) {
+                    r ^= 1;
+                }
+            }
+        }
+
+        memo.insert({node.get(), r});
+    }
+
+    return Bdd(this, memo[bx.get()]);
+}
+
+bx_t BddManager::from_bdd(Bdd const &f) {
+    assert(f.mgr == this);
+
+    unordered_map<uint32_t, bx_t> memo;
+    auto edge = [&](uint32_t e) {
+        bx_t y = (e >> 1) ? memo[e >> 1] : boolexpr::one();
+        return (e & 1) ? ~y : y;
+    };
+
+    for (auto i : postorder(f.e)) {
+        bx_t x = index2var[table[i].var];
+        auto lo = table[i].lo;
+        auto hi = table[i].hi;
+
+        // The high edge is regular, so it is never zero
+        bx_t y;
+        if (hi == BDD_ONE && lo == BDD_ZERO) {
+            y = x;
+        } else if (hi == BDD_ONE) {
+            y = or_({x, edge(lo)});
+        } else if (lo == BDD_ZERO) {
+            y = and_({x, edge(hi)});
+        } else if (lo == BDD_ONE) {
+            y = impl(x, edge(hi));
+        } else {
+            y = boolexpr::ite(x, edge(hi), edge(lo));
+        }
+        memo.insert({i, y});
+    }
+
+    return (f.e >> 1) ? edge(f.e) : (f.e & 1) ? bx_t(boolexpr::zero())
+                                               : bx_t(boolexpr::one());
+}
+
+vector<var_t> BddManager::order() const {
+    vector<var_t> xs;
+    for (auto v : level2var) {
+        xs.push_back(index2var[v]);
+    }
+    return xs;
+}
+
+size_t BddManager::size(Bdd const &f) const {
+    assert(f.mgr == this);
+    return postorder(f.e).size() + 1;
+}
+
+bdd_sat_iter::bdd_sat_iter() : done{true} {}
+
+bdd_sat_iter::bdd_sat_iter(Bdd const &f) : f{f}, done{f.is_zero()} {
+    if (!done) {
+        vars = f.mgr->support(f);
+        for (auto const &x : vars) {
+            indices.push_back(x->id >> 1);
+        }
+        edges.assign(vars.size() + 1, f);
+        vals.assign(vars.size(), false);
+        descend(0);
+        get_point();
+    }
+}
+
+bool bdd_sat_iter::operator==(bdd_sat_iter const &rhs) const {
+    return done == rhs.done;
+}
+
+bool bdd_sat_iter::operator!=(bdd_sat_iter const &rhs) const {
+    return !(*this == rhs);
+}
+
+point_t const &bdd_sat_iter::operator*() const { return point; }
+
+// Reordering between steps moves the decision variables,
+// so the variable at a depth is not always the top of its edge.
+Bdd bdd_sat_iter::cofactor(size_t depth, bool val) const {
+    auto mgr = f.mgr;
+    auto e = edges[depth].e;
+    auto v = indices[depth];
+    auto level = mgr->level(e);
+    if (level == mgr->var2level[v]) {
+        return Bdd(mgr, mgr->cofactor(e, v, val));
+    }
+    if (level > mgr->var2level[v]) {
+        return edges[depth];
+    }
+    auto x = mgr->mk(v, BDD_ZERO, BDD_ONE);
+    return Bdd(mgr, mgr->restrict_cube(e, val ? x : x ^ 1));
+}
+
+// Every edge other than zero has a satisfying point,
+// so the search never backtracks on the way down.
+void bdd_sat_iter::descend(size_t depth) {
+    for (; depth < vars.size(); ++depth) {
+        auto lo = cofactor(depth, false);
+        vals[depth] = lo.is_zero();
+        edges[depth + 1] = vals[depth] ? cofactor(depth, true) : lo;
+    }
+}
+
+void bdd_sat_iter::get_point() {
+    point.clear();
+    for (size_t i = 0; i < vars.size(); ++i) {
+        if (vals[i]) {
+            point.insert({vars[i], one()});
+        } else {
+            point.insert({vars[i], zero()});
+        }
+    }
+}
+
+bdd_sat_iter const &bdd_sat_iter::operator++() {
+    auto depth = vars.size();
+    while (depth > 0) {
+        --depth;
+        if (!vals[depth]) {
+            auto hi = cofactor(depth, true);
+            if (!hi.is_zero()) {
+                vals[depth] = true;
+                edges[depth + 1] = hi;
+                descend(depth + 1);
+                get_point();
+                return *this;
+            }
+        }
+    }
+
+    done = true;
+    point.clear();
+    return *this;
+}
+
+}  // namespace boolexpr
@@ -0,0 +1,277 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// WARNING:
+//     The contents of this file are implementation details.
+//     Do not use these declarations for anything,
+//     because they may change without notice.
+
+#ifndef BOOLEXPR_BDD_H_
+#define BOOLEXPR_BDD_H_
+
+#include <algorithm>  // swap
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "boolexpr/boolexpr.h"
+
+namespace boolexpr {
+
+// The terminal is node 0, so the constant edges are its two polarities
+uint32_t const BDD_ONE = 0;
+uint32_t const BDD_ZERO = 1;
+
+// Variable of a freed node
+uint32_t const FREE = UINT32_MAX;
+
+// Level of the terminal, and of variables not in the order
+uint32_t const NO_LEVEL = UINT32_MAX;
+
+// Group of a variable that moves on its own
+uint32_t const NO_GROUP = UINT32_MAX;
+
+// Computed table operations. Zero marks an empty entry.
+enum : uint32_t { OP_AND = 1, OP_XOR, OP_ITE, OP_EXISTS, OP_RESTRICT };
+
+inline size_t hash2(uint32_t a, uint32_t b) {
+    uint64_t h = (uint64_t(a) << 32 | b) * 0x9E3779B97F4A7C15ull;
+    return h >> 32;
+}
+
+inline size_t hash4(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    uint64_t h = (uint64_t(a) << 32 | b) * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t(c) << 32 | d) * 0xC2B2AE3D27D4EB4Full;
+    return h ^ (h >> 31);
+}
+
+// Terminal cases of the recursive operations.
+// Each returns true with the result in r,
+// or puts the operands in the form the computed table uses.
+
+inline bool and_terminal(uint32_t &f, uint32_t &g, uint32_t &r) {
+    if (f == BDD_ZERO || g == BDD_ZERO || f == (g ^ 1)) {
+        r = BDD_ZERO;
+        return true;
+    }
+    if (f == BDD_ONE || f == g) {
+        r = g;
+        return true;
+    }
+    if (g == BDD_ONE) {
+        r = f;
+        return true;
+    }
+    if (f > g) {
+        std::swap(f, g);
+    }
+    return false;
+}
+
+// The result of the regular operands is complemented by c
+inline bool xor_terminal(uint32_t &f, uint32_t &g, uint32_t &c, uint32_t &r) {
+    // Pull the complements out: ~f ^ g = ~(f ^ g)
+    c = (f ^ g) & 1;
+    f &= ~1u;
+    g &= ~1u;
+
+    if (f == g) {
+        r = BDD_ZERO ^ c;
+        return true;
+    }
+    if (f == BDD_ONE) {
+        r = g ^ 1 ^ c;
+        return true;
+    }
+    if (g == BDD_ONE) {
+        r = f ^ 1 ^ c;
+        return true;
+    }
+    if (f > g) {
+        std::swap(f, g);
+    }
+    return false;
+}
+
+enum class IteCase { DONE, AND, RECURSE };
+
+// The two-operand cases become f & g, complemented by c
+inline IteCase ite_terminal(uint32_t &f, uint32_t &g, uint32_t &h, uint32_t &c,
+                            uint32_t &r) {
+    c = 0;
+    if (f == BDD_ONE) {
+        r = g;
+        return IteCase::DONE;
+    }
+    if (f == BDD_ZERO) {
+        r = h;
+        return IteCase::DONE;
+    }
+    if (g == f) {
+        g = BDD_ONE;
+    } else if (g == (f ^ 1)) {
+        g = BDD_ZERO;
+    }
+    if (h == f) {
+        h = BDD_ZERO;
+    } else if (h == (f ^ 1)) {
+        h = BDD_ONE;
+    }
+    if (g == h) {
+        r = g;
+        return IteCase::DONE;
+    }
+
+    if (g == BDD_ONE && h == BDD_ZERO) {
+        r = f;
+        return IteCase::DONE;
+    }
+    if (g == BDD_ZERO && h == BDD_ONE) {
+        r = f ^ 1;
+        return IteCase::DONE;
+    }
+    if (g == BDD_ONE) {
+        f ^= 1;
+        g = h ^ 1;
+        c = 1;
+        return IteCase::AND;
+    }
+    if (g == BDD_ZERO) {
+        f ^= 1;
+        g = h;
+        return IteCase::AND;
+    }
+    if (h == BDD_ZERO) {
+        return IteCase::AND;
+    }
+    if (h == BDD_ONE) {
+        g ^= 1;
+        c = 1;
+        return IteCase::AND;
+    }
+
+    // Make f and g regular: ite(~f, g, h) = ite(f, h, g),
+    // and ite(f, ~g, ~h) = ~ite(f, g, h)
+    if (f & 1) {
+        f ^= 1;
+        std::swap(g, h);
+    }
+    c = g & 1;
+    g ^= c;
+    h ^= c;
+    return IteCase::RECURSE;
+}
+
+// Threads that share the recursion of one operation at a time.
+//
+// A worker pushes the high branch of each step near the top onto its own
+// deque, works on the low branch, then takes the high branch back unless
+// it was stolen from the other end. A worker that waits for a stolen task
+// only steals from the thief, which bounds the depth of its stack.
+//
+// New nodes come from free slots set aside before the operation,
+// and join a unique table with a compare-and-swap on the bucket head.
+// Reference counts are fixed up after the operation.
+// If the slots run out or a chain gets long, every worker stops,
+// the tables grow, and the operation runs again over the warm cache.
+class BddPool {
+public:
+    BddPool(BddManager &, uint32_t nthreads);
+    ~BddPool();
+
+    uint32_t apply(uint32_t op, uint32_t f, uint32_t g, uint32_t h);
+
+    void clear_cache();
+
+private:
+    struct Task {
+        uint32_t op;
+        uint32_t f;
+        uint32_t g;
+        uint32_t h;
+        uint32_t depth;
+        std::atomic<uint32_t> thief;
+        std::atomic<uint32_t> result;
+        std::atomic<bool> done;
+
+        Task(uint32_t op, uint32_t f, uint32_t g, uint32_t h, uint32_t depth);
+    };
+
+    struct Worker {
+        // Owner pushes and pops at the back, thieves take from the front
+        std::mutex lock;
+        std::deque<Task *> tasks;
+
+        // Slots taken from the pool, and the one left by a lost race
+        size_t first;
+        size_t last;
+        uint32_t spare;
+
+        std::vector<uint32_t> created;
+        std::vector<uint32_t> crowded;
+        uint32_t seed;
+    };
+
+    // Written under a sequence lock, and skipped by a writer that loses it
+    struct CacheEntry {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint32_t> op;
+        std::atomic<uint32_t> f;
+        std::atomic<uint32_t> g;
+        std::atomic<uint32_t> h;
+        std::atomic<uint32_t> r;
+    };
+
+    BddManager &mgr;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::vector<CacheEntry> cache;
+
+    // Free slots, handed out in chunks from the back
+    std::vector<uint32_t> slots;
+    std::atomic<size_t> taken;
+    size_t reserve;
+
+    std::atomic<bool> full;
+    std::atomic<bool> busy;
+
+    std::mutex control;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    uint64_t epoch;
+    size_t nactive;
+    bool quit;
+
+    void loop(uint32_t w);
+
+    void prepare();
+    void finish();
+
+    uint32_t exec(uint32_t w, uint32_t op, uint32_t f, uint32_t g, uint32_t h,
+                  uint32_t depth);
+    uint32_t sync(uint32_t w, Task &);
+    bool steal(uint32_t w, uint32_t victim);
+
+    uint32_t alloc(Worker &);
+    uint32_t mk(Worker &, uint32_t v, uint32_t lo, uint32_t hi);
+
+    bool lookup(uint32_t op, uint32_t f, uint32_t g, uint32_t h, uint32_t &r);
+    void insert(uint32_t op, uint32_t f, uint32_t g, uint32_t h, uint32_t r);
+};
+
+}  // namespace boolexpr
+
+#endif  // BOOLEXPR_BDD_H_
@@ -0,0 +1,472 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // fill, min
+#include <cassert>
+
+#include "boolexpr/boolexpr.h"
+#include "bdd.h"
+
+using std::lock_guard;
+using std::mutex;
+using std::unique_lock;
+using std::vector;
+
+namespace boolexpr {
+
+static size_t const CACHE_SIZE = 1 << 18;
+static size_t const MIN_SLOTS = 1 << 16;
+
+// Slots a worker takes from the pool at a time
+static size_t const CHUNK = 64;
+
+// Steps below this depth run on the worker that reaches them
+static uint32_t const SPAWN_DEPTH = 16;
+
+// Longest chain a worker scans before the tables grow
+static size_t const MAX_CHAIN = 32;
+
+// Result of an operation stopped because the tables are full
+static uint32_t const NO_RESULT = UINT32_MAX;
+
+static uint32_t const NO_THIEF = UINT32_MAX;
+
+BddPool::Task::Task(uint32_t op, uint32_t f, uint32_t g, uint32_t h,
+                    uint32_t depth)
+    : op{op},
+      f{f},
+      g{g},
+      h{h},
+      depth{depth},
+      thief{NO_THIEF},
+      result{NO_RESULT},
+      done{false} {}
+
+BddPool::BddPool(BddManager &mgr, uint32_t nthreads)
+    : mgr(mgr),
+      cache(CACHE_SIZE),
+      taken{0},
+      reserve{MIN_SLOTS},
+      full{false},
+      busy{false},
+      epoch{0},
+      nactive{0},
+      quit{false} {
+    clear_cache();
+    for (uint32_t w = 0; w < nthreads; ++w) {
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->first = worker->last = 0;
+        worker->spare = 0;
+        worker->seed = w + 1;
+        workers.push_back(std::move(worker));
+    }
+    // The calling thread is worker zero
+    for (uint32_t w = 1; w < nthreads; ++w) {
+        threads.emplace_back(&BddPool::loop, this, w);
+    }
+}
+
+BddPool::~BddPool() {
+    {
+        lock_guard<mutex> guard(control);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+
+void BddPool::clear_cache() {
+    for (auto &entry : cache) {
+        entry.seq.store(0, std::memory_order_relaxed);
+        entry.op.store(0, std::memory_order_relaxed);
+    }
+}
+
+void BddPool::loop(uint32_t w) {
+    auto &worker = *workers[w];
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            unique_lock<mutex> lock(control);
+            wake.wait(lock, [&] { return quit || epoch != seen; });
+            if (quit) {
+                return;
+            }
+            seen = epoch;
+        }
+
+        while (busy.load(std::memory_order_acquire)) {
+            // xorshift
+            worker.seed ^= worker.seed << 13;
+            worker.seed ^= worker.seed >> 17;
+            worker.seed ^= worker.seed << 5;
+            auto victim = worker.seed % workers.size();
+            if (victim == w || !steal(w, victim)) {
+                std::this_thread::yield();
+            }
+        }
+
+        {
+            lock_guard<mutex> guard(control);
+            if (--nactive == 0) {
+                idle.notify_all();
+            }
+        }
+    }
+}
+
+uint32_t BddPool::apply(uint32_t op, uint32_t f, uint32_t g, uint32_t h) {
+    for (;;) {
+        prepare();
+        {
+            lock_guard<mutex> guard(control);
+            busy.store(true, std::memory_order_release);
+            nactive = threads.size();
+            ++epoch;
+        }
+        wake.notify_all();
+
+        auto r = exec(0, op, f, g, h, 0);
+
+        // Every stolen task is done, so only the idle loops are left
+        busy.store(false, std::memory_order_release);
+        {
+            unique_lock<mutex> lock(control);
+            idle.wait(lock, [this] { return nactive == 0; });
+        }
+        finish();
+
+        if (r != NO_RESULT) {
+            return r;
+        }
+    }
+}
+
+// Take every free node of the manager, and add more up to the reserve
+void BddPool::prepare() {
+    auto &table = mgr.table;
+    while (mgr.free_list) {
+        slots.push_back(mgr.free_list);
+        mgr.free_list = table[mgr.free_list].next;
+    }
+    if (slots.size() < reserve) {
+        auto n = table.size();
+        table.resize(n + reserve - slots.size(),
+                     BddManager::Node{FREE, BDD_ONE, BDD_ONE, 0, 0});
+        for (auto i = table.size(); i-- > n;) {
+            slots.push_back(i);
+        }
+    }
+
+    taken.store(0, std::memory_order_relaxed);
+    full.store(false, std::memory_order_relaxed);
+}
+
+void BddPool::finish() {
+    auto &table = mgr.table;
+
+    // Nothing referred to the new nodes while the workers ran
+    for (auto &worker : workers) {
+        for (auto i : worker->created) {
+            ++mgr.subtables[table[i].var].keys;
+            ++mgr.nlive;
+            mgr.ref(table[i].lo);
+            mgr.ref(table[i].hi);
+        }
+        worker->created.clear();
+    }
+
+    // Give back what is left of each chunk
+    vector<uint32_t> unused;
+    for (auto &worker : workers) {
+        for (; worker->first < worker->last; ++worker->first) {
+            unused.push_back(slots[worker->first]);
+        }
+        if (worker->spare) {
+            table[worker->spare].var = FREE;
+            unused.push_back(worker->spare);
+            worker->spare = 0;
+        }
+    }
+    auto ntaken = std::min(taken.load(std::memory_order_relaxed), slots.size());
+    if (ntaken == slots.size() && full.load(std::memory_order_relaxed)) {
+        reserve *= 2;
+    }
+    slots.resize(slots.size() - ntaken);
+    slots.insert(slots.end(), unused.begin(), unused.end());
+
+    // Grow the unique tables, and any that had a long chain
+    for (auto &worker : workers) {
+        for (auto v : worker->crowded) {
+            mgr.resize(mgr.subtables[v]);
+        }
+        worker->crowded.clear();
+    }
+    for (auto &sub : mgr.subtables) {
+        while (sub.keys > 2 * sub.buckets.size()) {
+            mgr.resize(sub);
+        }
+    }
+}
+
+uint32_t BddPool::alloc(Worker &worker) {
+    if (worker.first == worker.last) {
+        auto k = taken.fetch_add(CHUNK, std::memory_order_relaxed);
+        if (k >= slots.size()) {
+            return 0;
+        }
+        worker.first = slots.size() - std::min(k + CHUNK, slots.size());
+        worker.last = slots.size() - k;
+    }
+    return slots[worker.first++];
+}
+
+uint32_t BddPool::mk(Worker &worker, uint32_t v, uint32_t lo, uint32_t hi) {
+    if (lo == hi) {
+        return lo;
+    }
+
+    // Keep the high edge regular
+    uint32_t c = hi & 1;
+    lo ^= c;
+    hi ^= c;
+
+    auto &table = mgr.table;
+    auto &sub = mgr.subtables[v];
+    auto &head = sub.buckets[hash2(lo, hi) & (sub.buckets.size() - 1)];
+    auto first = head.load(std::memory_order_acquire);
+    for (;;) {
+        size_t n = 0;
+        for (auto i = first; i; i = table[i].next) {
+            if (table[i].lo == lo && table[i].hi == hi) {
+                return i << 1 | c;
+            }
+            ++n;
+        }
+        if (n > MAX_CHAIN) {
+            worker.crowded.push_back(v);
+            full.store(true, std::memory_order_relaxed);
+            return NO_RESULT;
+        }
+
+        if (!worker.spare) {
+            worker.spare = alloc(worker);
+            if (!worker.spare) {
+                full.store(true, std::memory_order_relaxed);
+                return NO_RESULT;
+            }
+        }
+
+        // Publish the node, or rescan the chain if another worker won
+        auto i = worker.spare;
+        table[i] = {v, lo, hi, first, 0};
+        if (head.compare_exchange_weak(first, i, std::memory_order_release,
+                                       std::memory_order_acquire)) {
+            worker.spare = 0;
+            worker.created.push_back(i);
+            return i << 1 | c;
+        }
+    }
+}
+
+bool BddPool::lookup(uint32_t op, uint32_t f, uint32_t g, uint32_t h,
+                     uint32_t &r) {
+    auto const &entry = cache[hash4(op, f, g, h) & (cache.size() - 1)];
+    auto seq = entry.seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+        return false;
+    }
+    bool hit = entry.op.load(std::memory_order_relaxed) == op &&
+               entry.f.load(std::memory_order_relaxed) == f &&
+               entry.g.load(std::memory_order_relaxed) == g &&
+               entry.h.load(std::memory_order_relaxed) == h;
+    r = entry.r.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return hit && entry.seq.load(std::memory_order_relaxed) == seq;
+}
+
+void BddPool::insert(uint32_t op, uint32_t f, uint32_t g, uint32_t h,
+                     uint32_t r) {
+    auto &entry = cache[hash4(op, f, g, h) & (cache.size() - 1)];
+    auto seq = entry.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) ||
+        !entry.seq.compare_exchange_strong(seq, seq + 1,
+                                           std::memory_order_relaxed)) {
+        return;
+    }
+    // Keep the stores below from becoming visible before the odd sequence
+    // number. Otherwise a reader could see the old even number together
+    // with some new fields, and return a wrong edge.
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.op.store(op, std::memory_order_relaxed);
+    entry.f.store(f, std::memory_order_relaxed);
+    entry.g.store(g, std::memory_order_relaxed);
+    entry.h.store(h, std::memory_order_relaxed);
+    entry.r.store(r, std::memory_order_relaxed);
+    entry.seq.store(seq + 2, std::memory_order_release);
+}
+
+bool BddPool::steal(uint32_t w, uint32_t victim) {
+    Task *task;
+    {
+        auto &other = *workers[victim];
+        lock_guard<mutex> guard(other.lock);
+        if (other.tasks.empty()) {
+            return false;
+        }
+        task = other.tasks.front();
+        other.tasks.pop_front();
+        task->thief.store(w, std::memory_order_relaxed);
+    }
+
+    auto r = exec(w, task->op, task->f, task->g, task->h, task->depth);
+    task->result.store(r, std::memory_order_relaxed);
+    task->done.store(true, std::memory_order_release);
+    return true;
+}
+
+uint32_t BddPool::sync(uint32_t w, Task &task) {
+    auto &worker = *workers[w];
+    bool mine;
+    {
+        lock_guard<mutex> guard(worker.lock);
+        mine = !worker.tasks.empty() && worker.tasks.back() == &task;
+        if (mine) {
+            worker.tasks.pop_back();
+        }
+    }
+    if (mine) {
+        return exec(w, task.op, task.f, task.g, task.h, task.depth);
+    }
+
+    // Leapfrog: help the thief until the task is done
+    auto thief = task.thief.load(std::memory_order_relaxed);
+    while (!task.done.load(std::memory_order_acquire)) {
+        if (!steal(w, thief)) {
+            std::this_thread::yield();
+        }
+    }
+    return task.result.load(std::memory_order_relaxed);
+}
+
+uint32_t BddPool::exec(uint32_t w, uint32_t op, uint32_t f, uint32_t g,
+                       uint32_t h, uint32_t depth) {
+    if (full.load(std::memory_order_relaxed)) {
+        return NO_RESULT;
+    }
+
+    uint32_t c = 0;
+    uint32_t r;
+    switch (op) {
+        case OP_AND:
+            if (and_terminal(f, g, r)) {
+                return r;
+            }
+            break;
+
+        case OP_XOR:
+            if (xor_terminal(f, g, c, r)) {
+                return r;
+            }
+            break;
+
+        case OP_ITE:
+            switch (ite_terminal(f, g, h, c, r)) {
+                case IteCase::DONE:
+                    return r;
+                case IteCase::AND:
+                    r = exec(w, OP_AND, f, g, 0, depth);
+                    return r == NO_RESULT ? r : r ^ c;
+                default:
+                    break;
+            }
+            break;
+
+        case OP_EXISTS:
+            // The cube is a conjunction of positive literals
+            if ((f >> 1) == 0) {
+                return f;
+            }
+            while (g != BDD_ONE && mgr.level(g) < mgr.level(f)) {
+                g = mgr.table[g >> 1].hi;
+            }
+            if (g == BDD_ONE) {
+                return f;
+            }
+            break;
+
+        default:
+            assert(false);  // LCOV_EXCL_LINE
+    }
+
+    if (lookup(op, f, g, h, r)) {
+        return r ^ c;
+    }
+
+    uint32_t v;
+    uint32_t g0, g1, h0, h1;
+    bool quantify = false;
+    if (op == OP_EXISTS) {
+        v = mgr.table[f >> 1].var;
+        quantify = mgr.level(g) == mgr.level(f);
+        g0 = g1 = quantify ? mgr.table[g >> 1].hi : g;
+        h0 = h1 = h;
+    } else {
+        v = mgr.level2var[std::min(
+            {mgr.level(f), mgr.level(g), mgr.level(h)})];
+        g0 = mgr.cofactor(g, v, false);
+        g1 = mgr.cofactor(g, v, true);
+        h0 = mgr.cofactor(h, v, false);
+        h1 = mgr.cofactor(h, v, true);
+    }
+    auto f0 = mgr.cofactor(f, v, false);
+    auto f1 = mgr.cofactor(f, v, true);
+
+    uint32_t lo, hi;
+    if (depth < SPAWN_DEPTH) {
+        Task task(op, f1, g1, h1, depth + 1);
+        {
+            auto &worker = *workers[w];
+            lock_guard<mutex> guard(worker.lock);
+            worker.tasks.push_back(&task);
+        }
+        lo = exec(w, op, f0, g0, h0, depth + 1);
+        hi = sync(w, task);
+    } else {
+        lo = exec(w, op, f0, g0, h0, depth + 1);
+        hi = exec(w, op, f1, g1, h1, depth + 1);
+    }
+    if (lo == NO_RESULT || hi == NO_RESULT) {
+        return NO_RESULT;
+    }
+
+    if (quantify) {
+        r = exec(w, OP_AND, lo ^ 1, hi ^ 1, 0, depth);
+        if (r == NO_RESULT) {
+            return r;
+        }
+        r ^= 1;
+    } else {
+        r = mk(*workers[w], v, lo, hi);
+        if (r == NO_RESULT) {
+            return r;
+        }
+    }
+
+    insert(op, f, g, h, r);
+    return r ^ c;
+}
+
+}  // namespace boolexpr
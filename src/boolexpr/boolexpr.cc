@@ -12,10 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <unordered_map>
+
 #include "boolexpr/boolexpr.h"
+#include "truthtable.h"
 
 using std::make_shared;
 using std::static_pointer_cast;
+using std::unordered_map;
 using std::unordered_set;
 using std::vector;
 
@@ -293,19 +297,58 @@ bx_t BoolExpr::expand(vector<var_t> const &xs) const {
     return or_(std::move(or_args));
 }
 
+// Reduce the cofactors over xs with a truth table, if the function is small.
+// Variables outside the support still count, so a derivative over one is zero.
+static bool small_reduce(bx_t const &f, vector<var_t> const &xs,
+                         TruthTable (TruthTable::*reduce)(uint32_t) const,
+                         bx_t &result) {
+    vector<bx_t> exprs{f};
+    exprs.insert(exprs.end(), xs.begin(), xs.end());
+
+    vector<var_t> vars;
+    if (!small_support(exprs, vars)) {
+        return false;
+    }
+
+    unordered_map<var_t, uint32_t> index;
+    for (uint32_t i = 0; i < vars.size(); ++i) {
+        index.insert({vars[i], i});
+    }
+
+    TruthTable tt(f, vars);
+    for (auto const &x : xs) {
+        tt = (tt.*reduce)(index.find(x)->second);
+    }
+
+    result = tt.to_bx(vars);
+    return true;
+}
+
 // FIXME(cjdrake): Implement these as reductions
 bx_t BoolExpr::smoothing(vector<var_t> const &xs) const {
     auto self = shared_from_this();
+    bx_t result;
+    if (small_reduce(self, xs, &TruthTable::exists, result)) {
+        return result;
+    }
     return or_s(vector<bx_t>(cf_iter(self, xs), cf_iter()));
 }
 
 bx_t BoolExpr::consensus(vector<var_t> const &xs) const {
     auto self = shared_from_this();
+    bx_t result;
+    if (small_reduce(self, xs, &TruthTable::forall, result)) {
+        return result;
+    }
     return and_s(vector<bx_t>(cf_iter(self, xs), cf_iter()));
 }
 
 bx_t BoolExpr::derivative(vector<var_t> const &xs) const {
     auto self = shared_from_this();
+    bx_t result;
+    if (small_reduce(self, xs, &TruthTable::difference, result)) {
+        return result;
+    }
     return xor_s(vector<bx_t>(cf_iter(self, xs), cf_iter()));
 }
 
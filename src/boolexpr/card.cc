@@ -0,0 +1,381 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // min, swap
+
+#include "boolexpr/boolexpr.h"
+
+using std::string;
+using std::vector;
+
+namespace boolexpr {
+
+static void amo_pairwise(vector<bx_t> const &xs, vector<bx_t> &clauses) {
+    for (size_t i = 0; i + 1 < xs.size(); ++i) {
+        for (size_t j = i + 1; j < xs.size(); ++j) {
+            clauses.push_back(or_({~xs[i], ~xs[j]}));
+        }
+    }
+}
+
+// Sinz sequential counter: s[i] means "one of xs[0..i] is true"
+static void amo_seqcounter(Context &ctx, string const &auxvarname,
+                           vector<bx_t> const &xs, vector<bx_t> &clauses) {
+    size_t n = xs.size();
+    if (n < 2) {
+        return;
+    }
+
+    bx_t s = ctx.get_anon_var(auxvarname);
+    clauses.push_back(or_({~xs[0], s}));
+    for (size_t i = 1; i < n - 1; ++i) {
+        bx_t t = ctx.get_anon_var(auxvarname);
+        clauses.push_back(or_({~xs[i], t}));
+        clauses.push_back(or_({~s, t}));
+        clauses.push_back(or_({~xs[i], ~s}));
+        s = t;
+    }
+    clauses.push_back(or_({~xs[n - 1], ~s}));
+}
+
+// Klieber-Kwon commander encoding with groups of three
+static void amo_commander(Context &ctx, string const &auxvarname,
+                          vector<bx_t> const &xs, vector<bx_t> &clauses) {
+    size_t const group = 3;
+    size_t n = xs.size();
+
+    if (n <= group + 1) {
+        amo_pairwise(xs, clauses);
+        return;
+    }
+
+    vector<bx_t> cmds;
+    for (size_t i = 0; i < n; i += group) {
+        size_t end = std::min(i + group, n);
+        if (end - i == 1) {
+            cmds.push_back(xs[i]);
+            continue;
+        }
+
+        bx_t c = ctx.get_anon_var(auxvarname);
+        vector<bx_t> members(xs.cbegin() + i, xs.cbegin() + end);
+        vector<bx_t> lits{~c};
+        for (bx_t const &x : members) {
+            clauses.push_back(or_({~x, c}));
+            lits.push_back(x);
+        }
+        clauses.push_back(or_(std::move(lits)));
+        amo_pairwise(members, clauses);
+        cmds.push_back(c);
+    }
+
+    amo_commander(ctx, auxvarname, cmds, clauses);
+}
+
+// Chen product encoding: xs arranged on a grid of rows x cols
+static void amo_product(Context &ctx, string const &auxvarname,
+                        vector<bx_t> const &xs, vector<bx_t> &clauses) {
+    size_t n = xs.size();
+
+    if (n <= 4) {
+        amo_pairwise(xs, clauses);
+        return;
+    }
+
+    size_t cols = 1;
+    while (cols * cols < n) {
+        ++cols;
+    }
+    size_t rows = (n + cols - 1) / cols;
+
+    vector<bx_t> us(rows), vs(cols);
+    for (auto &u : us) u = ctx.get_anon_var(auxvarname);
+    for (auto &v : vs) v = ctx.get_anon_var(auxvarname);
+
+    for (size_t k = 0; k < n; ++k) {
+        clauses.push_back(or_({~xs[k], us[k / cols]}));
+        clauses.push_back(or_({~xs[k], vs[k % cols]}));
+    }
+
+    amo_product(ctx, auxvarname, us, clauses);
+    amo_product(ctx, auxvarname, vs, clauses);
+}
+
+static void amo(Context &ctx, string const &auxvarname,
+                vector<bx_t> const &xs, AMOEncoding encoding,
+                vector<bx_t> &clauses) {
+    switch (encoding) {
+        case AMOEncoding::PAIRWISE:
+            amo_pairwise(xs, clauses);
+            break;
+        case AMOEncoding::SEQCOUNTER:
+            amo_seqcounter(ctx, auxvarname, xs, clauses);
+            break;
+        case AMOEncoding::COMMANDER:
+            amo_commander(ctx, auxvarname, xs, clauses);
+            break;
+        case AMOEncoding::PRODUCT:
+            amo_product(ctx, auxvarname, xs, clauses);
+            break;
+    }
+}
+
+// Sinz sequential counter: s[i][j] means "j+1 of xs[0..i] are true".
+// Requires 0 < k < n.
+static void atmost_seqcounter(Context &ctx, string const &auxvarname,
+                              vector<bx_t> const &xs, size_t k,
+                              vector<bx_t> &clauses) {
+    size_t n = xs.size();
+
+    vector<bx_t> prev(k);
+    for (auto &s : prev) s = ctx.get_anon_var(auxvarname);
+
+    clauses.push_back(or_({~xs[0], prev[0]}));
+    for (size_t j = 1; j < k; ++j) {
+        clauses.push_back(~prev[j]);
+    }
+
+    for (size_t i = 1; i < n - 1; ++i) {
+        vector<bx_t> curr(k);
+        for (auto &s : curr) s = ctx.get_anon_var(auxvarname);
+
+        clauses.push_back(or_({~xs[i], curr[0]}));
+        clauses.push_back(or_({~prev[0], curr[0]}));
+        for (size_t j = 1; j < k; ++j) {
+            clauses.push_back(or_({~xs[i], ~prev[j - 1], curr[j]}));
+            clauses.push_back(or_({~prev[j], curr[j]}));
+        }
+        clauses.push_back(or_({~xs[i], ~prev[k - 1]}));
+
+        prev = std::move(curr);
+    }
+
+    clauses.push_back(or_({~xs[n - 1], ~prev[k - 1]}));
+}
+
+// Bailleux-Boufkhad totalizer over xs[lo..hi), with unary outputs
+// truncated to m bits: out[j] means "at least j+1 inputs are true".
+// The upward clauses enforce out >= count, the downward out <= count.
+static vector<bx_t> totalizer(Context &ctx, string const &auxvarname,
+                              vector<bx_t> const &xs, size_t lo, size_t hi,
+                              size_t m, bool up, bool down,
+                              vector<bx_t> &clauses) {
+    if (hi - lo == 1) {
+        return vector<bx_t>{xs[lo]};
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    auto as = totalizer(ctx, auxvarname, xs, lo, mid, m, up, down, clauses);
+    auto bs = totalizer(ctx, auxvarname, xs, mid, hi, m, up, down, clauses);
+
+    vector<bx_t> rs(std::min(hi - lo, m));
+    for (auto &r : rs) r = ctx.get_anon_var(auxvarname);
+
+    for (size_t i = 0; i <= as.size(); ++i) {
+        for (size_t j = 0; j <= bs.size(); ++j) {
+            if (up && 0 < i + j && i + j <= rs.size()) {
+                vector<bx_t> lits;
+                if (i > 0) lits.push_back(~as[i - 1]);
+                if (j > 0) lits.push_back(~bs[j - 1]);
+                lits.push_back(rs[i + j - 1]);
+                clauses.push_back(or_(std::move(lits)));
+            }
+            if (down && i + j < rs.size()) {
+                vector<bx_t> lits{~rs[i + j]};
+                if (i < as.size()) lits.push_back(as[i]);
+                if (j < bs.size()) lits.push_back(bs[j]);
+                clauses.push_back(or_(std::move(lits)));
+            }
+        }
+    }
+
+    return rs;
+}
+
+// Compare-and-swap: afterwards a = a | b, and b = a & b
+static void comparator(Context &ctx, string const &auxvarname, bx_t &a,
+                       bx_t &b, bool up, bool down, vector<bx_t> &clauses) {
+    if (IS_ZERO(a) || IS_ONE(b)) {
+        std::swap(a, b);
+        return;
+    }
+    if (IS_ZERO(b) || IS_ONE(a)) {
+        return;
+    }
+
+    bx_t c = ctx.get_anon_var(auxvarname);
+    bx_t d = ctx.get_anon_var(auxvarname);
+
+    if (up) {
+        clauses.push_back(or_({~a, c}));
+        clauses.push_back(or_({~b, c}));
+        clauses.push_back(or_({~a, ~b, d}));
+    }
+    if (down) {
+        clauses.push_back(or_({~c, a, b}));
+        clauses.push_back(or_({~d, a}));
+        clauses.push_back(or_({~d, b}));
+    }
+
+    a = c;
+    b = d;
+}
+
+// Batcher odd-even merge sort, in descending order.
+// Inputs are padded with zeros to a power of two.
+static vector<bx_t> sortnet(Context &ctx, string const &auxvarname,
+                            vector<bx_t> const &xs, bool up, bool down,
+                            vector<bx_t> &clauses) {
+    size_t n = 1;
+    while (n < xs.size()) {
+        n <<= 1;
+    }
+
+    vector<bx_t> ys(xs);
+    ys.resize(n, zero());
+
+    for (size_t p = 1; p < n; p <<= 1) {
+        for (size_t k = p; k >= 1; k >>= 1) {
+            for (size_t j = k % p; j + k < n; j += 2 * k) {
+                for (size_t i = 0; i < std::min(k, n - j - k); ++i) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        comparator(ctx, auxvarname, ys[i + j], ys[i + j + k],
+                                   up, down, clauses);
+                    }
+                }
+            }
+        }
+    }
+
+    ys.resize(xs.size());
+    return ys;
+}
+
+// Return unary outputs: out[j] means "at least j+1 inputs are true"
+static vector<bx_t> counter(Context &ctx, string const &auxvarname,
+                            vector<bx_t> const &xs, size_t m,
+                            CardEncoding encoding, bool up, bool down,
+                            vector<bx_t> &clauses) {
+    if (encoding == CardEncoding::SORTNET) {
+        return sortnet(ctx, auxvarname, xs, up, down, clauses);
+    }
+    return totalizer(ctx, auxvarname, xs, 0, xs.size(), m, up, down, clauses);
+}
+
+static bx_t all_of(vector<bx_t> const &xs) { return and_s(xs); }
+
+static bx_t none_of(vector<bx_t> const &xs) {
+    vector<bx_t> lits;
+    for (bx_t const &x : xs) lits.push_back(~x);
+    return and_s(std::move(lits));
+}
+
+bx_t at_most_one(Context &ctx, vector<bx_t> const &args, AMOEncoding encoding,
+                 string const &auxvarname) {
+    vector<bx_t> clauses;
+    amo(ctx, auxvarname, args, encoding, clauses);
+    return and_s(std::move(clauses));
+}
+
+bx_t exactly_one(Context &ctx, vector<bx_t> const &args, AMOEncoding encoding,
+                 string const &auxvarname) {
+    vector<bx_t> clauses{or_(args)};
+    amo(ctx, auxvarname, args, encoding, clauses);
+    return and_s(std::move(clauses));
+}
+
+bx_t at_most_k(Context &ctx, vector<bx_t> const &args, size_t k,
+               CardEncoding encoding, string const &auxvarname) {
+    size_t n = args.size();
+
+    if (k >= n) {
+        return one();
+    }
+    if (k == 0) {
+        return none_of(args);
+    }
+
+    vector<bx_t> clauses;
+
+    if (encoding == CardEncoding::SEQCOUNTER) {
+        atmost_seqcounter(ctx, auxvarname, args, k, clauses);
+    } else {
+        auto outs = counter(ctx, auxvarname, args, k + 1, encoding, true,
+                            false, clauses);
+        clauses.push_back(~outs[k]);
+    }
+
+    return and_s(std::move(clauses));
+}
+
+bx_t at_least_k(Context &ctx, vector<bx_t> const &args, size_t k,
+                CardEncoding encoding, string const &auxvarname) {
+    size_t n = args.size();
+
+    if (k == 0) {
+        return one();
+    }
+    if (k > n) {
+        return zero();
+    }
+    if (k == n) {
+        return all_of(args);
+    }
+    if (k == 1) {
+        return or_s(args);
+    }
+
+    if (encoding == CardEncoding::SEQCOUNTER) {
+        // At least k of xs <=> at most n-k of ~xs
+        vector<bx_t> xns;
+        for (bx_t const &arg : args) xns.push_back(~arg);
+        return at_most_k(ctx, xns, n - k, encoding, auxvarname);
+    }
+
+    vector<bx_t> clauses;
+    auto outs =
+        counter(ctx, auxvarname, args, k, encoding, false, true, clauses);
+    clauses.push_back(outs[k - 1]);
+
+    return and_s(std::move(clauses));
+}
+
+bx_t exactly_k(Context &ctx, vector<bx_t> const &args, size_t k,
+               CardEncoding encoding, string const &auxvarname) {
+    size_t n = args.size();
+
+    if (k > n) {
+        return zero();
+    }
+    if (k == 0) {
+        return none_of(args);
+    }
+    if (k == n) {
+        return all_of(args);
+    }
+
+    if (encoding == CardEncoding::SEQCOUNTER) {
+        return and_s({at_most_k(ctx, args, k, encoding, auxvarname),
+                      at_least_k(ctx, args, k, encoding, auxvarname)});
+    }
+
+    vector<bx_t> clauses;
+    auto outs =
+        counter(ctx, auxvarname, args, k + 1, encoding, true, true, clauses);
+    clauses.push_back(outs[k - 1]);
+    clauses.push_back(~outs[k]);
+
+    return and_s(std::move(clauses));
+}
+
+}  // namespace boolexpr
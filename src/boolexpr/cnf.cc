@@ -0,0 +1,288 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <cassert>
+#include <cstdlib>  // abs
+
+#include "boolexpr/boolexpr.h"
+
+using std::initializer_list;
+using std::static_pointer_cast;
+using std::vector;
+
+using Glucose::Lit;
+using Glucose::lbool;  // l_False, l_True
+using Glucose::mkLit;
+
+namespace boolexpr {
+
+Cnf::Cnf() : nvars{0}, offsets{0} {}
+
+int32_t Cnf::new_var() { return ++nvars; }
+
+void Cnf::add_clause(initializer_list<int32_t> const clause) {
+    lits.insert(lits.end(), clause.begin(), clause.end());
+    offsets.push_back(lits.size());
+}
+
+void Cnf::add_clause(int32_t const *first, int32_t const *last) {
+    lits.insert(lits.end(), first, last);
+    offsets.push_back(lits.size());
+}
+
+size_t Cnf::nclauses() const { return offsets.size() - 1; }
+
+void Cnf::load(Glucose::Solver &solver, size_t first) const {
+    while (static_cast<uint32_t>(solver.nVars()) < nvars) {
+        solver.newVar();
+    }
+
+    Glucose::vec<Lit> clause;
+    for (size_t i = first; i < nclauses(); ++i) {
+        clause.clear();
+        for (uint32_t j = offsets[i]; j < offsets[i + 1]; ++j) {
+            clause.push(mkLit(std::abs(lits[j]) - 1, lits[j] < 0));
+        }
+        solver.addClause(clause);
+    }
+}
+
+CnfEncoder::CnfEncoder() : idx2var{nullptr}, last_ctx{0}, true_lit{0} {}
+
+int32_t CnfEncoder::new_var(var_t const &x) {
+    idx2var.push_back(x);
+    return cnf.new_var();
+}
+
+int32_t CnfEncoder::encode(bx_t const &bx) {
+    if (IS_LIT(bx)) {
+        return encode_lit(bx);
+    }
+
+    if (IS_OP(bx)) {
+        auto search = memo.find(bx.get());
+        if (search != memo.end()) {
+            return search->second;
+        }
+        auto y = encode_op(static_cast<Operator const *>(bx.get()));
+        memo.insert({bx.get(), y});
+        memo_nodes.push_back(bx);
+        return y;
+    }
+
+    // Unknown constants have no CNF encoding
+    assert(IS_KNOWN(bx));
+
+    if (true_lit == 0) {
+        true_lit = new_var();
+        cnf.add_clause({true_lit});
+    }
+    return IS_ONE(bx) ? true_lit : -true_lit;
+}
+
+void CnfEncoder::add(bx_t const &bx) {
+    if (IS_ONE(bx)) {
+        return;
+    }
+
+    if (IS_ZERO(bx)) {
+        cnf.add_clause({});
+    } else if (IS_AND(bx)) {
+        auto op = static_cast<Operator const *>(bx.get());
+        for (bx_t const &arg : op->args) {
+            add(arg);
+        }
+    } else if (IS_OR(bx)) {
+        auto op = static_cast<Operator const *>(bx.get());
+        vector<int32_t> clause;
+        for (bx_t const &arg : op->args) {
+            clause.push_back(encode(arg));
+        }
+        cnf.add_clause(clause.data(), clause.data() + clause.size());
+    } else {
+        cnf.add_clause({encode(bx)});
+    }
+}
+
+point_t CnfEncoder::model(Glucose::Solver const &solver) const {
+    return model(solver, cnf.nvars);
+}
+
+point_t CnfEncoder::model(Glucose::Solver const &solver, uint32_t n) const {
+    point_t point;
+    for (size_t v = 1; v <= n; ++v) {
+        auto const &x = idx2var[v];
+        // Auxiliary variables are projected away
+        if (x && !x->ctx->is_anon(x->id)) {
+            if (solver.modelValue(v - 1) == l_False) {
+                point.insert({x, zero()});
+            } else if (solver.modelValue(v - 1) == l_True) {
+                point.insert({x, one()});
+            }
+        }
+    }
+    return point;
+}
+
+point_t CnfEncoder::model(vector<int32_t> const &lits) const {
+    point_t point;
+    for (auto lit : lits) {
+        auto v = static_cast<uint32_t>(std::abs(lit));
+        if (v >= idx2var.size()) {
+            continue;
+        }
+        auto const &x = idx2var[v];
+        if (x && !x->ctx->is_anon(x->id)) {
+            if (lit > 0) {
+                point.insert({x, one()});
+            } else {
+                point.insert({x, zero()});
+            }
+        }
+    }
+    return point;
+}
+
+int32_t CnfEncoder::encode_lit(bx_t const &bx) {
+    auto lit = static_cast<Literal const *>(bx.get());
+
+    if (ctx2idx.empty() || ctx2idx[last_ctx].first != lit->ctx) {
+        last_ctx = 0;
+        while (last_ctx < ctx2idx.size() &&
+               ctx2idx[last_ctx].first != lit->ctx) {
+            ++last_ctx;
+        }
+        if (last_ctx == ctx2idx.size()) {
+            ctx2idx.push_back({lit->ctx, vector<int32_t>()});
+        }
+    }
+
+    auto &idx = ctx2idx[last_ctx].second;
+    auto k = lit->id >> 1;
+    if (idx.size() <= k) {
+        idx.resize(k + 1, 0);
+    }
+    if (idx[k] == 0) {
+        auto x = IS_VAR(bx) ? static_pointer_cast<Variable const>(bx)
+                            : static_pointer_cast<Variable const>(~bx);
+        idx[k] = new_var(x);
+    }
+
+    return IS_VAR(bx) ? idx[k] : -idx[k];
+}
+
+int32_t CnfEncoder::encode_op(Operator const *op) {
+    vector<int32_t> xs;
+    for (bx_t const &arg : op->args) {
+        xs.push_back(encode(arg));
+    }
+
+    int32_t y = 0;
+
+    switch (op->kind) {
+        case BoolExpr::NOR:
+        case BoolExpr::OR:
+            y = encode_or(xs);
+            break;
+        case BoolExpr::NAND:
+        case BoolExpr::AND:
+            y = encode_and(xs);
+            break;
+        case BoolExpr::XNOR:
+        case BoolExpr::XOR:
+            // Chain binary XORs to keep the encoding linear
+            y = xs[0];
+            for (size_t i = 1; i < xs.size(); ++i) {
+                y = encode_xor(y, xs[i]);
+            }
+            break;
+        case BoolExpr::NEQ:
+        case BoolExpr::EQ: {
+            // Equal(a, b, ...) <=> And(a, b, ...) | And(~a, ~b, ...)
+            auto all1 = encode_and(xs);
+            for (auto &x : xs) {
+                x = -x;
+            }
+            auto all0 = encode_and(xs);
+            y = encode_or({all1, all0});
+            break;
+        }
+        case BoolExpr::NIMPL:
+        case BoolExpr::IMPL:
+            y = encode_or({-xs[0], xs[1]});
+            break;
+        case BoolExpr::NITE:
+        case BoolExpr::ITE:
+            y = encode_ite(xs[0], xs[1], xs[2]);
+            break;
+        default:
+            assert(false);
+    }
+
+    return IS_POS(op) ? y : -y;
+}
+
+int32_t CnfEncoder::encode_or(vector<int32_t> const &xs) {
+    auto y = new_var();
+
+    // y = x0 | x1 | ... <=> (y | ~x0) & (y | ~x1) & ... & (~y | x0 | x1 | ...)
+    vector<int32_t> clause{-y};
+    for (int32_t x : xs) {
+        cnf.add_clause({y, -x});
+        clause.push_back(x);
+    }
+    cnf.add_clause(clause.data(), clause.data() + clause.size());
+
+    return y;
+}
+
+int32_t CnfEncoder::encode_and(vector<int32_t> const &xs) {
+    auto y = new_var();
+
+    // y = x0 & x1 & ... <=> (~y | x0) & (~y | x1) & ... & (y | ~x0 | ~x1 | ...)
+    vector<int32_t> clause{y};
+    for (int32_t x : xs) {
+        cnf.add_clause({-y, x});
+        clause.push_back(-x);
+    }
+    cnf.add_clause(clause.data(), clause.data() + clause.size());
+
+    return y;
+}
+
+int32_t CnfEncoder::encode_xor(int32_t a, int32_t b) {
+    auto y = new_var();
+
+    cnf.add_clause({-a, -b, -y});
+    cnf.add_clause({a, b, -y});
+    cnf.add_clause({a, -b, y});
+    cnf.add_clause({-a, b, y});
+
+    return y;
+}
+
+int32_t CnfEncoder::encode_ite(int32_t s, int32_t d1, int32_t d0) {
+    auto y = new_var();
+
+    cnf.add_clause({-s, -d1, y});
+    cnf.add_clause({-s, d1, -y});
+    cnf.add_clause({s, -d0, y});
+    cnf.add_clause({s, d0, -y});
+    // Redundant, but they help propagation
+    cnf.add_clause({-d1, -d0, y});
+    cnf.add_clause({d1, d0, -y});
+
+    return y;
+}
+
+}  // namespace boolexpr
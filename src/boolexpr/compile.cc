@@ -0,0 +1,165 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // fill, min
+#include <cassert>
+
+#include "boolexpr/boolexpr.h"
+#include "simulate.h"
+
+using std::vector;
+
+namespace boolexpr {
+
+static uint8_t bit(uint64_t const *point, size_t i) {
+    return (point[i / 64] >> (i % 64)) & 1;
+}
+
+CompiledExpr::CompiledExpr(bx_t const &f)
+    : sim{new Simulator({f})}, vals(sim->program().size()) {}
+
+CompiledExpr::CompiledExpr(CompiledExpr &&) = default;
+
+CompiledExpr::~CompiledExpr() = default;
+
+bool CompiledExpr::okay() const { return sim->okay(); }
+
+vector<var_t> const &CompiledExpr::inputs() const { return sim->inputs(); }
+
+bool CompiledExpr::eval(uint64_t const *point) {
+    if (!okay()) {
+        return false;
+    }
+
+    auto const &nodes = sim->program();
+    auto const &args = sim->arguments();
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        auto const &node = nodes[i];
+        uint8_t val = 0;
+
+        switch (node.kind) {
+            case BoolExpr::ZERO:
+                break;
+
+            case BoolExpr::ONE:
+                val = 1;
+                break;
+
+            case BoolExpr::COMP:
+                val = bit(point, node.begin) ^ 1;
+                break;
+
+            case BoolExpr::VAR:
+                val = bit(point, node.begin);
+                break;
+
+            case BoolExpr::NOR:
+            case BoolExpr::OR:
+                for (auto j = node.begin; j < node.end && !val; ++j) {
+                    val = vals[args[j]];
+                }
+                break;
+
+            case BoolExpr::NAND:
+            case BoolExpr::AND:
+                val = 1;
+                for (auto j = node.begin; j < node.end && val; ++j) {
+                    val = vals[args[j]];
+                }
+                break;
+
+            case BoolExpr::XNOR:
+            case BoolExpr::XOR:
+                for (auto j = node.begin; j < node.end; ++j) {
+                    val ^= vals[args[j]];
+                }
+                break;
+
+            case BoolExpr::NEQ:
+            case BoolExpr::EQ:
+                // Equal if every argument matches the first
+                val = 1;
+                for (auto j = node.begin + 1; j < node.end && val; ++j) {
+                    val = vals[args[j]] == vals[args[node.begin]];
+                }
+                break;
+
+            case BoolExpr::NIMPL:
+            case BoolExpr::IMPL:
+                val = !vals[args[node.begin]] || vals[args[node.begin + 1]];
+                break;
+
+            case BoolExpr::NITE:
+            case BoolExpr::ITE:
+                val = vals[args[node.begin]] ? vals[args[node.begin + 1]]
+                                             : vals[args[node.begin + 2]];
+                break;
+
+            default:
+                assert(false);  // LCOV_EXCL_LINE
+        }
+
+        // Negative operators have even kinds
+        if (node.kind >> 4 == 1 && !(node.kind & 1)) {
+            val ^= 1;
+        }
+        vals[i] = val;
+    }
+
+    // The root is last in post-order
+    return vals.back();
+}
+
+void CompiledExpr::eval(uint64_t const *points, size_t n, uint64_t *results) {
+    if (!okay()) {
+        std::fill(results, results + (n + 63) / 64, 0);
+        return;
+    }
+
+    size_t const block = 64 * Simulator::WORDS;
+    auto ninputs = inputs().size();
+
+    for (size_t first = 0; first < n; first += block) {
+        auto count = std::min(block, n - first);
+
+        // Transpose the block, so each input holds one bit per point
+        for (size_t i = 0; i < ninputs; ++i) {
+            auto words = sim->input(i);
+            for (size_t k = 0; k < Simulator::WORDS; ++k) {
+                words[k] = 0;
+            }
+        }
+        for (size_t j = 0; j < count; ++j) {
+            auto point = points + (first + j) * stride();
+            for (size_t i = 0; i < ninputs; ++i) {
+                sim->input(i)[j / 64] |= uint64_t(bit(point, i)) << (j % 64);
+            }
+        }
+
+        sim->run();
+
+        auto out = sim->output(0);
+        for (size_t k = 0; 64 * k < count; ++k) {
+            auto word = out[k];
+            if (count - 64 * k < 64) {
+                word &= (uint64_t(1) << (count - 64 * k)) - 1;
+            }
+            results[first / 64 + k] = word;
+        }
+    }
+}
+
+CompiledExpr compile(bx_t const &f) { return CompiledExpr(f); }
+
+}  // namespace boolexpr
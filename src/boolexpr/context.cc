@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>  // upper_bound
+
 #include "boolexpr/boolexpr.h"
 
 using std::make_shared;
@@ -26,19 +28,105 @@ var_t Context::get_var(string name) {
     if (search == vars.end()) {
         auto xn = make_shared<Complement>(this, id++);
         auto x = make_shared<Variable>(this, id++);
-        vars.insert({name, x});
-        id2name.insert({xn->id >> 1, name});
-        id2lit.insert({xn->id, xn});
-        id2lit.insert({x->id, x});
+        auto it = vars.insert({std::move(name), x}).first;
+        id2name.push_back(&it->first);
+        id2lit.push_back(xn);
+        id2lit.push_back(x);
         return x;
     }
     return search->second;
 }
 
+var_t Context::get_anon_var(string const &prefix) {
+    auto count = anon_counts.insert({prefix, 0}).first;
+    auto const *name = &count->first;
+    auto index = count->second++;
+
+    // Start a new block unless this variable extends the last one
+    bool extends = false;
+    if (!anon_blocks.empty()) {
+        auto const &last = anon_blocks.back();
+        extends = last.prefix == name &&
+                  last.first + ((index - last.index) << 1) == id;
+    }
+    if (!extends) {
+        anon_blocks.push_back({id, index, name});
+    }
+
+    auto xn = make_shared<Complement>(this, id++);
+    auto x = make_shared<Variable>(this, id++);
+    id2name.push_back(nullptr);
+    id2lit.push_back(xn);
+    id2lit.push_back(x);
+
+    return x;
+}
+
+bool Context::is_anon(id_t id) const { return id2name[id >> 1] == nullptr; }
+
 string Context::get_name(id_t id) const {
-    return id2name.find(id >> 1)->second;
+    auto name = id2name[id >> 1];
+    if (name != nullptr) {
+        return *name;
+    }
+
+    // Find the last block that starts at or before id
+    auto it = std::upper_bound(
+        anon_blocks.cbegin(), anon_blocks.cend(), id,
+        [](id_t id, AnonBlock const &block) { return id < block.first; });
+    --it;
+
+    auto index = it->index + ((id - it->first) >> 1);
+    return *it->prefix + "_" + std::to_string(index);
+}
+
+lit_t Context::get_lit(id_t id) const { return id2lit[id]; }
+
+void Context::push_scope() { scopes.push_back(id); }
+
+bool Context::pop_scope() {
+    if (scopes.empty()) {
+        return false;
+    }
+
+    auto mark = scopes.back();
+
+    // Every literal is owned by id2lit, and named variables also by vars.
+    for (auto i = mark; i < id; ++i) {
+        long owners = (i & 1) && id2name[i >> 1] != nullptr ? 2 : 1;
+        if (id2lit[i].use_count() > owners) {
+            return false;
+        }
+    }
+
+    scopes.pop_back();
+
+    for (auto i = mark >> 1; i < (id >> 1); ++i) {
+        if (id2name[i] != nullptr) {
+            vars.erase(vars.find(*id2name[i]));
+        }
+    }
+
+    while (!anon_blocks.empty() && anon_blocks.back().first >= mark) {
+        auto const &block = anon_blocks.back();
+        anon_counts.find(*block.prefix)->second = block.index;
+        anon_blocks.pop_back();
+    }
+
+    // The last block might have started before the scope
+    if (!anon_blocks.empty()) {
+        auto const &block = anon_blocks.back();
+        auto &count = anon_counts.find(*block.prefix)->second;
+        count = std::min(count, block.index + ((mark - block.first) >> 1));
+    }
+
+    id2name.resize(mark >> 1);
+    id2lit.resize(mark);
+    id = mark;
+
+    return true;
 }
 
-lit_t Context::get_lit(id_t id) const { return id2lit.find(id)->second; }
+size_t Context::num_scopes() const { return scopes.size(); }
 
 }  // namespace boolexpr
@@ -0,0 +1,126 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // sort
+#include <cstdlib>    // abs
+
+#include "boolexpr/boolexpr.h"
+
+using std::vector;
+
+using Glucose::Lit;
+using Glucose::mkLit;
+
+namespace boolexpr {
+
+static Lit to_lit(int32_t x) { return mkLit(std::abs(x) - 1, x < 0); }
+
+// Each constraint i holds when its activation variable acts[i] is assumed.
+// Return the constraints in the final conflict,
+// or an empty vector if the assumed constraints are satisfiable.
+static vector<size_t> solve_core(Glucose::Solver &solver,
+                                 vector<int32_t> const &acts,
+                                 vector<size_t> const &assumed) {
+    Glucose::vec<Lit> assumps;
+    for (auto i : assumed) {
+        assumps.push(to_lit(acts[i]));
+    }
+
+    if (solver.solve(assumps)) {
+        return {};
+    }
+
+    // The conflict holds the negations of the assumptions it used
+    vector<bool> in_conflict(solver.nVars(), false);
+    for (int k = 0; k < solver.conflict.size(); ++k) {
+        in_conflict[Glucose::var(solver.conflict[k])] = true;
+    }
+    vector<bool> used(acts.size(), false);
+    for (auto i : assumed) {
+        used[i] = in_conflict[std::abs(acts[i]) - 1];
+    }
+
+    vector<size_t> core;
+    for (auto i : assumed) {
+        if (used[i]) {
+            core.push_back(i);
+        }
+    }
+    // A solver may give up on the conflict, but every assumption is safe
+    return core.empty() ? assumed : core;
+}
+
+vector<bx_t> unsat_core(vector<bx_t> const &constraints, bool minimal) {
+    CnfEncoder encoder;
+    vector<int32_t> acts;
+
+    // Shared subexpressions are encoded once, for every constraint
+    for (auto const &bx : constraints) {
+        auto lit = encoder.encode(bx->simplify());
+        auto act = encoder.new_var();
+        encoder.cnf.add_clause({-act, lit});
+        acts.push_back(act);
+    }
+
+    Glucose::Solver solver;
+    encoder.cnf.load(solver);
+
+    vector<size_t> all;
+    for (size_t i = 0; i < constraints.size(); ++i) {
+        all.push_back(i);
+    }
+
+    auto core = solve_core(solver, acts, all);
+
+    if (minimal && !core.empty()) {
+        // Deletion: drop each constraint in turn.
+        // If the rest is still UNSAT, shrink to its conflict,
+        // otherwise the constraint is necessary.
+        vector<size_t> necessary;
+        while (!core.empty()) {
+            auto i = core.back();
+            core.pop_back();
+
+            auto assumed = necessary;
+            assumed.insert(assumed.end(), core.begin(), core.end());
+
+            auto refined = solve_core(solver, acts, assumed);
+            if (refined.empty()) {
+                necessary.push_back(i);
+            } else {
+                // Clause-set refinement keeps only what the conflict used
+                vector<bool> keep(constraints.size(), false);
+                for (auto j : refined) {
+                    keep[j] = true;
+                }
+                vector<size_t> rest;
+                for (auto j : core) {
+                    if (keep[j]) {
+                        rest.push_back(j);
+                    }
+                }
+                core.swap(rest);
+            }
+        }
+        std::sort(necessary.begin(), necessary.end());
+        core.swap(necessary);
+    }
+
+    vector<bx_t> result;
+    for (auto i : core) {
+        result.push_back(constraints[i]);
+    }
+    return result;
+}
+
+}  // namespace boolexpr
@@ -0,0 +1,431 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // min, sort
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>  // abs
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "boolexpr/boolexpr.h"
+#include "cube.h"
+#include "limiter.h"
+
+using std::atomic;
+using std::deque;
+using std::make_pair;
+using std::mutex;
+using std::thread;
+using std::unique_ptr;
+using std::vector;
+
+using Glucose::Lit;
+using Glucose::lbool;  // l_False, l_True, l_Undef
+using Glucose::mkLit;
+
+namespace boolexpr {
+
+// Score at most this many of the busiest candidates at each split
+static size_t const MAX_CANDIDATES = 64;
+
+static Lit to_lit(int32_t x) { return mkLit(std::abs(x) - 1, x < 0); }
+
+// Unit propagation over a Cnf, with cheap undo
+class Lookahead {
+public:
+    explicit Lookahead(Cnf const &);
+
+    // Return false if the clauses are refuted by unit propagation
+    bool okay() const { return ok; }
+
+    // Assign a literal and propagate. Return false on conflict.
+    bool assign(int32_t lit);
+
+    // Undo assignments back to a trail size
+    void undo(size_t mark);
+
+    size_t mark() const { return trail.size(); }
+
+    // Return 1 if true, -1 if false, 0 if unassigned
+    int8_t value(int32_t lit) const;
+
+    // Number of clauses that contain a variable
+    size_t occurs(int32_t v) const;
+
+private:
+    Cnf const &cnf;
+    bool ok;
+
+    // Clause indices by literal: 2 * v for +v, 2 * v + 1 for -v
+    vector<vector<uint32_t>> occ;
+    vector<int8_t> vals;
+    vector<int32_t> trail;
+
+    static size_t index(int32_t lit) { return 2 * std::abs(lit) + (lit < 0); }
+};
+
+Lookahead::Lookahead(Cnf const &cnf)
+    : cnf{cnf},
+      ok{true},
+      occ(2 * (cnf.nvars + 1)),
+      vals(cnf.nvars + 1, 0) {
+    for (size_t i = 0; i < cnf.nclauses(); ++i) {
+        for (auto j = cnf.offsets[i]; j < cnf.offsets[i + 1]; ++j) {
+            occ[index(cnf.lits[j])].push_back(i);
+        }
+    }
+    for (size_t i = 0; ok && i < cnf.nclauses(); ++i) {
+        auto n = cnf.offsets[i + 1] - cnf.offsets[i];
+        if (n == 0) {
+            ok = false;
+        } else if (n == 1) {
+            auto lit = cnf.lits[cnf.offsets[i]];
+            if (value(lit) < 0 || (value(lit) == 0 && !assign(lit))) {
+                ok = false;
+            }
+        }
+    }
+}
+
+int8_t Lookahead::value(int32_t lit) const {
+    auto val = vals[std::abs(lit)];
+    return lit < 0 ? -val : val;
+}
+
+size_t Lookahead::occurs(int32_t v) const {
+    return occ[index(v)].size() + occ[index(-v)].size();
+}
+
+bool Lookahead::assign(int32_t lit) {
+    auto head = trail.size();
+    vals[std::abs(lit)] = lit < 0 ? -1 : 1;
+    trail.push_back(lit);
+
+    while (head < trail.size()) {
+        auto x = trail[head++];
+        // Only clauses that contain the complement can become unit
+        for (auto i : occ[index(-x)]) {
+            int32_t unit = 0;
+            size_t nfree = 0;
+            bool sat = false;
+            for (auto j = cnf.offsets[i]; j < cnf.offsets[i + 1]; ++j) {
+                auto y = cnf.lits[j];
+                auto val = value(y);
+                if (val > 0) {
+                    sat = true;
+                    break;
+                }
+                if (val == 0) {
+                    unit = y;
+                    ++nfree;
+                }
+            }
+            if (sat || nfree > 1) {
+                continue;
+            }
+            if (nfree == 0) {
+                return false;
+            }
+            vals[std::abs(unit)] = unit < 0 ? -1 : 1;
+            trail.push_back(unit);
+        }
+    }
+
+    return true;
+}
+
+void Lookahead::undo(size_t mark) {
+    while (trail.size() > mark) {
+        vals[std::abs(trail.back())] = 0;
+        trail.pop_back();
+    }
+}
+
+// Lookahead splitter.
+// Each split branches on the candidate whose two sides propagate the most,
+// and fixes the other side of a failed literal.
+class Splitter {
+public:
+    Splitter(Cnf const &, vector<int32_t> const &candidates);
+
+    vector<vector<int32_t>> split(uint32_t depth);
+
+private:
+    Lookahead la;
+    vector<int32_t> candidates;
+    vector<int32_t> cube;
+    vector<vector<int32_t>> cubes;
+
+    void split_(uint32_t depth);
+};
+
+Splitter::Splitter(Cnf const &cnf, vector<int32_t> const &vs) : la{cnf} {
+    candidates = vs;
+    std::sort(candidates.begin(), candidates.end(),
+              [this](int32_t a, int32_t b) {
+                  return la.occurs(a) > la.occurs(b);
+              });
+}
+
+vector<vector<int32_t>> Splitter::split(uint32_t depth) {
+    if (la.okay()) {
+        split_(depth);
+    }
+    return std::move(cubes);
+}
+
+void Splitter::split_(uint32_t depth) {
+    auto mark = la.mark();
+    auto size = cube.size();
+
+    int32_t best = 0;
+    while (depth > 0) {
+        best = 0;
+        size_t best_score = 0;
+        size_t nscored = 0;
+        bool failed = false;
+
+        for (auto v : candidates) {
+            if (la.value(v) != 0) {
+                continue;
+            }
+            if (nscored++ == MAX_CANDIDATES) {
+                break;
+            }
+
+            auto m = la.mark();
+            bool pos = la.assign(v);
+            auto npos = la.mark() - m;
+            la.undo(m);
+            bool neg = la.assign(-v);
+            auto nneg = la.mark() - m;
+            la.undo(m);
+
+            if (!pos && !neg) {
+                // Refuted
+                la.undo(mark);
+                cube.resize(size);
+                return;
+            }
+            if (!pos || !neg) {
+                // Failed literal: the other side is implied
+                auto lit = pos ? v : -v;
+                la.assign(lit);
+                cube.push_back(lit);
+                failed = true;
+                break;
+            }
+
+            auto score = (npos + 1) * (nneg + 1);
+            if (score > best_score) {
+                best_score = score;
+                best = v;
+            }
+        }
+
+        // Rescore after every failed literal
+        if (!failed) {
+            break;
+        }
+    }
+
+    if (depth == 0 || best == 0) {
+        cubes.push_back(cube);
+    } else {
+        for (auto lit : {best, -best}) {
+            auto m = la.mark();
+            cube.push_back(lit);
+            if (la.assign(lit)) {
+                split_(depth - 1);
+            }
+            cube.pop_back();
+            la.undo(m);
+        }
+    }
+
+    la.undo(mark);
+    cube.resize(size);
+}
+
+vector<vector<int32_t>> split_cubes(CnfEncoder const &encoder, bx_t const &f,
+                                    uint32_t depth, vector<CubeStat> &results) {
+    auto const &cnf = encoder.cnf;
+
+    auto support = f->support();
+    vector<int32_t> candidates;
+    for (uint32_t i = 1; i <= cnf.nvars; ++i) {
+        auto const &x = encoder.idx2var[i];
+        if (x && support.find(x) != support.end()) {
+            candidates.push_back(i);
+        }
+    }
+
+    Splitter splitter(cnf, candidates);
+    auto cubes = splitter.split(depth);
+
+    results.assign(cubes.size(), CubeStat());
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        for (auto lit : cubes[i]) {
+            auto const &x = encoder.idx2var[std::abs(lit)];
+            if (lit > 0) {
+                results[i].cube.insert({x, one()});
+            } else {
+                results[i].cube.insert({x, zero()});
+            }
+        }
+        results[i].status = CubeStat::SKIPPED;
+        results[i].worker = 0;
+        results[i].conflicts = 0;
+        results[i].seconds = 0.0;
+    }
+
+    return cubes;
+}
+
+limited_soln_t cube_and_conquer(bx_t const &self, SatOptions const &options,
+                                vector<CubeStat> *stats) {
+    assert(options.nthreads > 0);
+
+    auto f = self->simplify();
+
+    if (stats) {
+        stats->clear();
+    }
+
+    if (!IS_OP(f)) {
+        return f->sat_limited(SatOptions());
+    }
+
+    CnfEncoder encoder;
+    encoder.add(f);
+    auto const &cnf = encoder.cnf;
+
+    vector<CubeStat> results;
+    auto cubes = split_cubes(encoder, f, options.cube_depth, results);
+
+    auto nworkers = std::min<size_t>(options.nthreads, cubes.size());
+
+    vector<unique_ptr<Glucose::Solver>> solvers;
+    vector<Glucose::Solver *> ptrs;
+    for (size_t i = 0; i < nworkers; ++i) {
+        unique_ptr<Glucose::Solver> solver(new Glucose::Solver());
+        cnf.load(*solver);
+        ptrs.push_back(solver.get());
+        solvers.push_back(std::move(solver));
+    }
+
+    SatLimiter limiter(options, ptrs);
+
+    // Each worker pops from the front of its own queue,
+    // and steals from the back of the others.
+    vector<deque<size_t>> queues(nworkers);
+    unique_ptr<mutex[]> locks(new mutex[nworkers]);
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        queues[i % nworkers].push_back(i);
+    }
+
+    auto next = [&](size_t w, size_t &cube) {
+        for (size_t k = 0; k < nworkers; ++k) {
+            auto victim = (w + k) % nworkers;
+            std::lock_guard<mutex> guard(locks[victim]);
+            auto &queue = queues[victim];
+            if (!queue.empty()) {
+                if (k == 0) {
+                    cube = queue.front();
+                    queue.pop_front();
+                } else {
+                    cube = queue.back();
+                    queue.pop_back();
+                }
+                return true;
+            }
+        }
+        return false;
+    };
+
+    atomic<bool> done(false);
+    size_t win = 0;
+
+    auto run = [&](size_t w) {
+        auto &solver = *solvers[w];
+        size_t i;
+
+        while (!done.load() && !limiter.stopped() && next(w, i)) {
+            Glucose::vec<Lit> assumps;
+            for (auto lit : cubes[i]) {
+                assumps.push(to_lit(lit));
+            }
+
+            auto conflicts = solver.conflicts;
+            auto start = std::chrono::steady_clock::now();
+
+            if (!limiter.set_budget(w)) {
+                break;
+            }
+            auto r = solver.solveLimited(assumps);
+
+            std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+
+            auto &result = results[i];
+            result.worker = w;
+            result.conflicts = solver.conflicts - conflicts;
+            result.seconds = elapsed.count();
+
+            if (r == l_True) {
+                result.status = CubeStat::SAT;
+                if (!done.exchange(true)) {
+                    win = w;
+                    for (auto &other : solvers) {
+                        other->interrupt();
+                    }
+                }
+            } else if (r == l_False) {
+                result.status = CubeStat::UNSAT;
+            }
+        }
+    };
+
+    if (nworkers == 1) {
+        run(0);
+    } else {
+        vector<thread> threads;
+        for (size_t w = 0; w < nworkers; ++w) {
+            threads.emplace_back(run, w);
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+    }
+
+    if (stats) {
+        *stats = results;
+    }
+
+    if (done.load()) {
+        return make_pair(SatStatus::SAT, encoder.model(*solvers[win]));
+    }
+
+    auto status = SatStatus::UNSAT;
+    for (auto const &result : results) {
+        if (result.status != CubeStat::UNSAT) {
+            status = SatStatus::UNKNOWN;
+        }
+    }
+    return make_pair(status, boost::none);
+}
+
+}  // namespace boolexpr
@@ -0,0 +1,35 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// WARNING:
+//     The contents of this file are implementation details.
+//     Do not use these declarations for anything,
+//     because they may change without notice.
+
+#ifndef BOOLEXPR_CUBE_H_
+#define BOOLEXPR_CUBE_H_
+
+#include "boolexpr/boolexpr.h"
+
+namespace boolexpr {
+
+// Split an encoded expression into at most 2^depth cubes over its support.
+// Return the cubes as CNF literals, and one SKIPPED result per cube.
+std::vector<std::vector<int32_t>> split_cubes(CnfEncoder const &,
+                                              bx_t const &, uint32_t depth,
+                                              std::vector<CubeStat> &);
+
+}  // namespace boolexpr
+
+#endif  // BOOLEXPR_CUBE_H_
@@ -0,0 +1,408 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // equal, max, min
+#include <cstdint>    // INT32_MAX, INT32_MIN
+#include <cstdlib>    // abs
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "boolexpr/boolexpr.h"
+
+using std::string;
+using std::vector;
+
+namespace boolexpr {
+
+// Buffered writer, so we never build the whole text in memory
+class DimacsWriter {
+public:
+    explicit DimacsWriter(std::ostream &os) : os(os), n{0} {}
+    ~DimacsWriter() { flush(); }
+
+    void put(char c) {
+        if (n == sizeof(buf)) {
+            flush();
+        }
+        buf[n++] = c;
+    }
+
+    void put(char const *s) {
+        while (*s) {
+            put(*s++);
+        }
+    }
+
+    void put(int64_t x) {
+        char digits[24];
+        size_t i = 0;
+        uint64_t u = x < 0 ? -static_cast<uint64_t>(x) : x;
+        do {
+            digits[i++] = '0' + (u % 10);
+            u /= 10;
+        } while (u != 0);
+        if (x < 0) {
+            put('-');
+        }
+        while (i > 0) {
+            put(digits[--i]);
+        }
+    }
+
+    // Little-endian, regardless of the host
+    void put_u32(uint32_t x) {
+        for (int i = 0; i < 4; ++i) {
+            put(static_cast<char>((x >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void flush() {
+        os.write(buf, n);
+        n = 0;
+    }
+
+private:
+    std::ostream &os;
+    char buf[1 << 16];
+    size_t n;
+};
+
+static void write_clauses(DimacsWriter &w, Cnf const &cnf) {
+    w.put("p cnf ");
+    w.put(static_cast<int64_t>(cnf.nvars));
+    w.put(' ');
+    w.put(static_cast<int64_t>(cnf.nclauses()));
+    w.put('\n');
+
+    for (size_t i = 0; i < cnf.nclauses(); ++i) {
+        for (uint32_t j = cnf.offsets[i]; j < cnf.offsets[i + 1]; ++j) {
+            w.put(static_cast<int64_t>(cnf.lits[j]));
+            w.put(' ');
+        }
+        w.put("0\n");
+    }
+}
+
+void write_dimacs(std::ostream &os, Cnf const &cnf) {
+    DimacsWriter w(os);
+    write_clauses(w, cnf);
+}
+
+void write_dimacs(std::ostream &os, bx_t const &bx) {
+    CnfEncoder encoder;
+    encoder.add(bx);
+
+    DimacsWriter w(os);
+    for (size_t v = 1; v < encoder.idx2var.size(); ++v) {
+        auto const &x = encoder.idx2var[v];
+        if (x && !x->ctx->is_anon(x->id)) {
+            w.put("c ");
+            w.put(static_cast<int64_t>(v));
+            w.put(' ');
+            w.put(x->to_string().c_str());
+            w.put('\n');
+        }
+    }
+    write_clauses(w, encoder.cnf);
+}
+
+static char const BINARY_MAGIC[4] = {'B', 'X', 'C', '1'};
+
+void write_binary_cnf(std::ostream &os, Cnf const &cnf) {
+    DimacsWriter w(os);
+    for (auto c : BINARY_MAGIC) {
+        w.put(c);
+    }
+    w.put_u32(cnf.nvars);
+    w.put_u32(cnf.nclauses());
+    w.put_u32(cnf.lits.size());
+    for (size_t i = 0; i < cnf.nclauses(); ++i) {
+        w.put_u32(cnf.offsets[i + 1] - cnf.offsets[i]);
+    }
+    for (auto lit : cnf.lits) {
+        w.put_u32(static_cast<uint32_t>(lit));
+    }
+}
+
+static bool get_u32(char const *&p, char const *last, uint32_t &x) {
+    if (last - p < 4) {
+        return false;
+    }
+    x = 0;
+    for (int i = 0; i < 4; ++i) {
+        x |= static_cast<uint32_t>(static_cast<uint8_t>(*p++)) << (8 * i);
+    }
+    return true;
+}
+
+bool read_binary_cnf(char const *first, char const *last, Cnf &cnf) {
+    auto p = first;
+
+    if (last - p < 4 || !std::equal(BINARY_MAGIC, BINARY_MAGIC + 4, p)) {
+        return false;
+    }
+    p += 4;
+
+    uint32_t nvars, nclauses, nlits;
+    if (!get_u32(p, last, nvars) || !get_u32(p, last, nclauses) ||
+        !get_u32(p, last, nlits)) {
+        return false;
+    }
+    // Check the sizes before reserving anything
+    if (static_cast<uint64_t>(last - p) !=
+        4 * (static_cast<uint64_t>(nclauses) + nlits)) {
+        return false;
+    }
+
+    // Check every size and literal before changing the CNF
+    auto q = p;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < nclauses; ++i) {
+        uint32_t size;
+        get_u32(q, last, size);
+        total += size;
+    }
+    if (total != nlits) {
+        return false;
+    }
+    for (uint32_t i = 0; i < nlits; ++i) {
+        uint32_t x;
+        get_u32(q, last, x);
+        auto lit = static_cast<int32_t>(x);
+        if (lit == 0 || lit == INT32_MIN) {
+            return false;
+        }
+        auto v = static_cast<uint32_t>(std::abs(lit));
+        if (v > nvars) {
+            nvars = v;
+        }
+    }
+
+    cnf.nvars = std::max(cnf.nvars, nvars);
+    cnf.offsets.reserve(cnf.offsets.size() + nclauses);
+    uint64_t end = cnf.lits.size();
+    for (uint32_t i = 0; i < nclauses; ++i) {
+        uint32_t size;
+        get_u32(p, last, size);
+        end += size;
+        cnf.offsets.push_back(end);
+    }
+    cnf.lits.reserve(cnf.lits.size() + nlits);
+    for (uint32_t i = 0; i < nlits; ++i) {
+        uint32_t x;
+        get_u32(p, last, x);
+        cnf.lits.push_back(static_cast<int32_t>(x));
+    }
+
+    return true;
+}
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static void skip_space(char const *&p, char const *last) {
+    while (p != last && is_space(*p)) {
+        ++p;
+    }
+}
+
+static void skip_line(char const *&p, char const *last) {
+    while (p != last && *p != '\n') {
+        ++p;
+    }
+}
+
+static bool parse_int(char const *&p, char const *last, int64_t &x) {
+    bool neg = false;
+    if (p != last && (*p == '-' || *p == '+')) {
+        neg = *p == '-';
+        ++p;
+    }
+    if (p == last || *p < '0' || '9' < *p) {
+        return false;
+    }
+    x = 0;
+    while (p != last && '0' <= *p && *p <= '9') {
+        x = 10 * x + (*p - '0');
+        if (x > INT32_MAX) {
+            return false;
+        }
+        ++p;
+    }
+    if (neg) {
+        x = -x;
+    }
+    return true;
+}
+
+bool read_dimacs(char const *first, char const *last, Cnf &cnf) {
+    auto p = first;
+
+    // Preamble: comments, then the problem line
+    for (;;) {
+        skip_space(p, last);
+        if (p == last) {
+            return false;
+        }
+        if (*p == 'c') {
+            skip_line(p, last);
+        } else {
+            break;
+        }
+    }
+
+    if (*p++ != 'p' || p == last || !is_space(*p)) {
+        return false;
+    }
+    skip_space(p, last);
+    for (char const *q = "cnf"; *q; ++q, ++p) {
+        if (p == last || *p != *q) {
+            return false;
+        }
+    }
+    if (p == last || !is_space(*p)) {
+        return false;
+    }
+
+    int64_t nvars, nclauses;
+    skip_space(p, last);
+    if (!parse_int(p, last, nvars) || nvars < 0) {
+        return false;
+    }
+    skip_space(p, last);
+    if (!parse_int(p, last, nclauses) || nclauses < 0) {
+        return false;
+    }
+
+    // On error, the CNF goes back to these sizes
+    auto nlits0 = cnf.lits.size();
+    auto noffsets0 = cnf.offsets.size();
+    auto maxvar = std::max(cnf.nvars, static_cast<uint32_t>(nvars));
+    // The header is not trusted: each clause takes at least two bytes
+    auto most = static_cast<int64_t>((last - p) / 2 + 1);
+    cnf.offsets.reserve(cnf.offsets.size() + std::min(nclauses, most));
+
+    // Clauses: each one is a list of literals ending with 0
+    for (;;) {
+        skip_space(p, last);
+        if (p == last) {
+            break;
+        }
+        if (*p == 'c' || *p == '%') {
+            skip_line(p, last);
+            continue;
+        }
+
+        int64_t lit;
+        if (!parse_int(p, last, lit)) {
+            cnf.lits.resize(nlits0);
+            cnf.offsets.resize(noffsets0);
+            return false;
+        }
+        if (lit == 0) {
+            cnf.offsets.push_back(cnf.lits.size());
+        } else {
+            cnf.lits.push_back(static_cast<int32_t>(lit));
+            auto v = static_cast<uint32_t>(std::abs(lit));
+            if (v > maxvar) {
+                maxvar = v;
+            }
+        }
+    }
+
+    cnf.nvars = maxvar;
+
+    // Accept a missing 0 after the last clause
+    if (cnf.lits.size() != cnf.offsets.back()) {
+        cnf.offsets.push_back(cnf.lits.size());
+    }
+
+    return true;
+}
+
+bool read_dimacs(string const &path, Cnf &cnf) {
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = st.st_size;
+    if (size == 0) {
+        close(fd);
+        return read_dimacs(nullptr, nullptr, cnf);
+    }
+
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    madvise(addr, size, MADV_SEQUENTIAL);
+
+    auto first = static_cast<char const *>(addr);
+    auto ok = read_dimacs(first, first + size, cnf);
+
+    munmap(addr, size);
+    return ok;
+#else
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        return false;
+    }
+    vector<char> text((std::istreambuf_iterator<char>(ifs)),
+                      std::istreambuf_iterator<char>());
+    return read_dimacs(text.data(), text.data() + text.size(), cnf);
+#endif
+}
+
+bx_t cnf2bx(Context &ctx, Cnf const &cnf, string const &prefix) {
+    vector<var_t> vars(cnf.nvars + 1);
+    for (uint32_t v = 1; v <= cnf.nvars; ++v) {
+        vars[v] = ctx.get_var(prefix + "_" + std::to_string(v));
+    }
+
+    vector<bx_t> clauses;
+    clauses.reserve(cnf.nclauses());
+    for (size_t i = 0; i < cnf.nclauses(); ++i) {
+        vector<bx_t> lits;
+        for (uint32_t j = cnf.offsets[i]; j < cnf.offsets[i + 1]; ++j) {
+            auto lit = cnf.lits[j];
+            if (lit > 0) {
+                lits.push_back(vars[lit]);
+            } else {
+                lits.push_back(~vars[-lit]);
+            }
+        }
+        clauses.push_back(or_(std::move(lits)));
+    }
+
+    return and_(std::move(clauses));
+}
+
+}  // namespace boolexpr
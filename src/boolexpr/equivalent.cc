@@ -11,15 +11,121 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
+#include <cstdlib>  // abs
 
 #include "boolexpr/boolexpr.h"
+#include "simulate.h"
+#include "truthtable.h"
+
+using std::pair;
+using std::vector;
+
+using Glucose::Lit;
+using Glucose::mkLit;
 
 namespace boolexpr {
 
+static Lit to_lit(int32_t x) { return mkLit(std::abs(x) - 1, x < 0); }
+
 bool BoolExpr::equiv(bx_t const& other) const {
     auto self = shared_from_this();
+
+    // Small functions compare faster as truth tables than through SAT
+    vector<var_t> vars;
+    if (small_support({self, other}, vars)) {
+        return TruthTable(self, vars) == TruthTable(other, vars);
+    }
+
     auto soln = (self ^ other)->sat();
     return !soln.first;
 }
 
+boost::optional<bool> BoolExpr::equiv_limited(
+    bx_t const& other, SatOptions const& options) const {
+    auto self = shared_from_this();
+    auto soln = (self ^ other)->sat_limited(options);
+    if (soln.first == SatStatus::UNKNOWN) {
+        return boost::none;
+    }
+    return soln.first == SatStatus::UNSAT;
+}
+
+bool BoolExpr::equiv(bx_t const& other, point_t const& point) const {
+    return AssumptionCache(shared_from_this()).equiv(other, point);
+}
+
+vector<bool> equiv_many(vector<pair<bx_t, bx_t>> const& pairs) {
+    vector<bool> results(pairs.size(), false);
+
+    // Simplified sides, in pair order
+    vector<bx_t> keep;
+    for (auto const& pair : pairs) {
+        keep.push_back(pair.first->simplify());
+        keep.push_back(pair.second->simplify());
+    }
+
+    // One pass of random simulation over every pair at once
+    // tells most inequivalent pairs apart without the solver.
+    Simulator sim(keep);
+    vector<bool> differ(pairs.size(), false);
+    if (sim.okay()) {
+        std::mt19937_64 rng;
+        sim.randomize(rng);
+        sim.run();
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            auto x = sim.output(2 * i);
+            auto y = sim.output(2 * i + 1);
+            for (size_t k = 0; k < Simulator::WORDS; ++k) {
+                if (x[k] != y[k]) {
+                    differ[i] = true;
+                }
+            }
+        }
+    }
+
+    CnfEncoder encoder;
+    Glucose::Solver solver;
+    size_t loaded = 0;
+
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        auto const& f = keep[2 * i];
+        auto const& g = keep[2 * i + 1];
+
+        if (differ[i]) {
+            continue;
+        }
+
+        // Unknown constants have no CNF encoding
+        if (IS_UNKNOWN(f) || IS_UNKNOWN(g)) {
+            results[i] = f->equiv(g);
+            continue;
+        }
+
+        auto x = encoder.encode(f);
+        auto y = encoder.encode(g);
+
+        if (x == y || x == -y) {
+            results[i] = x == y;
+            continue;
+        }
+
+        // One-sided miter: m implies x != y
+        auto m = encoder.new_var();
+        encoder.cnf.add_clause({-m, x, y});
+        encoder.cnf.add_clause({-m, -x, -y});
+        encoder.cnf.load(solver, loaded);
+        loaded = encoder.cnf.nclauses();
+
+        results[i] = !solver.solve(to_lit(m));
+
+        // An equivalent pair helps every later pair that shares its logic
+        if (results[i]) {
+            solver.addClause(to_lit(-x), to_lit(y));
+            solver.addClause(to_lit(x), to_lit(-y));
+        }
+    }
+
+    return results;
+}
+
 }  // namespace boolexpr
@@ -0,0 +1,136 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // find, min
+#include <chrono>
+
+#include "boolexpr/boolexpr.h"
+#include "limiter.h"
+
+using std::vector;
+
+namespace boolexpr {
+
+SatInterrupt::SatInterrupt() : flag{false} {}
+
+void SatInterrupt::interrupt() {
+    std::lock_guard<std::mutex> guard(mutex);
+    flag = true;
+    for (auto solver : solvers) {
+        solver->interrupt();
+    }
+}
+
+void SatInterrupt::reset() {
+    std::lock_guard<std::mutex> guard(mutex);
+    flag = false;
+}
+
+bool SatInterrupt::interrupted() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return flag;
+}
+
+SatLimiter::SatLimiter(SatOptions const &options,
+                       vector<Glucose::Solver *> const &solvers)
+    : options{options}, solvers{solvers}, expired{false}, done{false} {
+    for (auto solver : solvers) {
+        conflicts.push_back(solver->conflicts);
+        propagations.push_back(solver->propagations);
+    }
+
+    if (options.interrupt) {
+        auto &handle = *options.interrupt;
+        std::lock_guard<std::mutex> guard(handle.mutex);
+        for (auto solver : solvers) {
+            handle.solvers.push_back(solver);
+            if (handle.flag) {
+                solver->interrupt();
+            }
+        }
+    }
+
+    if (options.time_limit > 0) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<
+                            std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(options.time_limit));
+        watchdog = std::thread([this, deadline] {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            if (!cv.wait_until(lock, deadline, [this] { return done; })) {
+                expired = true;
+                for (auto solver : this->solvers) {
+                    solver->interrupt();
+                }
+            }
+        });
+    }
+}
+
+SatLimiter::~SatLimiter() {
+    if (watchdog.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            done = true;
+        }
+        cv.notify_one();
+        watchdog.join();
+    }
+
+    if (options.interrupt) {
+        auto &handle = *options.interrupt;
+        std::lock_guard<std::mutex> guard(handle.mutex);
+        for (auto solver : solvers) {
+            auto it = std::find(handle.solvers.begin(), handle.solvers.end(),
+                                solver);
+            if (it != handle.solvers.end()) {
+                handle.solvers.erase(it);
+            }
+        }
+    }
+}
+
+bool SatLimiter::set_budget(size_t i, int64_t round) {
+    auto &solver = *solvers[i];
+    solver.budgetOff();
+
+    if (options.conflict_limit >= 0) {
+        int64_t left = options.conflict_limit -
+                       static_cast<int64_t>(solver.conflicts - conflicts[i]);
+        if (left <= 0) {
+            return false;
+        }
+        solver.setConfBudget(round < 0 ? left : std::min(round, left));
+    } else if (round >= 0) {
+        solver.setConfBudget(round);
+    }
+
+    if (options.propagation_limit >= 0) {
+        int64_t left =
+            options.propagation_limit -
+            static_cast<int64_t>(solver.propagations - propagations[i]);
+        if (left <= 0) {
+            return false;
+        }
+        solver.setPropBudget(left);
+    }
+
+    return true;
+}
+
+bool SatLimiter::stopped() const {
+    return expired.load() ||
+           (options.interrupt && options.interrupt->interrupted());
+}
+
+}  // namespace boolexpr
@@ -0,0 +1,64 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// WARNING:
+//     The contents of this file are implementation details.
+//     Do not use these declarations for anything,
+//     because they may change without notice.
+
+#ifndef BOOLEXPR_LIMITER_H_
+#define BOOLEXPR_LIMITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
+#include "boolexpr/boolexpr.h"
+
+namespace boolexpr {
+
+// Enforce the limits of some options on a set of solvers,
+// for the lifetime of the limiter.
+//
+// The time limit and the interrupt handle call interrupt() on the solvers.
+// Callers must clear the interrupts after the limiter is gone.
+class SatLimiter {
+public:
+    SatLimiter(SatOptions const &, std::vector<Glucose::Solver *> const &);
+    ~SatLimiter();
+
+    // Set the conflict and propagation budgets of solver i for one call,
+    // at most the given round budget, or no round budget if negative.
+    // Return false if the solver has spent its limit.
+    bool set_budget(size_t i, int64_t round = -1);
+
+    // Return true if the time limit or the interrupt handle has fired
+    bool stopped() const;
+
+private:
+    SatOptions options;
+    std::vector<Glucose::Solver *> solvers;
+    std::vector<uint64_t> conflicts;
+    std::vector<uint64_t> propagations;
+
+    std::atomic<bool> expired;
+    bool done;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread watchdog;
+};
+
+}  // namespace boolexpr
+
+#endif  // BOOLEXPR_LIMITER_H_
@@ -0,0 +1,570 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // sort, unique
+#include <cassert>
+#include <cmath>    // ceil, log2, pow
+#include <cstdlib>  // abs
+#include <random>
+
+#include <boost/functional/hash.hpp>
+
+#include "boolexpr/boolexpr.h"
+
+using std::unordered_map;
+using std::vector;
+
+using boost::multiprecision::cpp_int;
+
+using Glucose::Lit;
+using Glucose::lbool;  // l_True
+using Glucose::mkLit;
+
+namespace boolexpr {
+
+using clauses_t = vector<vector<int32_t>>;
+
+struct KeyHash {
+    size_t operator()(vector<uint32_t> const &key) const {
+        return boost::hash_range(key.begin(), key.end());
+    }
+};
+
+// DPLL model counter with component decomposition and component caching
+//
+// Assignments go on a trail, and backtracking undoes them.
+// A component is known by its free variables and its clauses,
+// which together fix its reduced clauses.
+//
+// Only projected variables tell models apart. The counter branches on
+// them first, so a component without any has one model if it is
+// satisfiable, and none otherwise.
+class ModelCounter {
+public:
+    ModelCounter(clauses_t const &clauses, uint32_t nvars,
+                 vector<bool> const &projected);
+
+    cpp_int count();
+
+private:
+    // Drop the cache when it grows past this many components
+    static size_t const CACHE_LIMIT = 1 << 20;
+
+    clauses_t const &clauses;
+    uint32_t nvars;
+    vector<bool> const &projected;
+
+    // Clause indices by literal: 2 * v for +v, 2 * v + 1 for -v
+    vector<vector<uint32_t>> occ;
+    vector<int8_t> vals;
+    vector<int32_t> trail;
+
+    // Scratch space, by variable
+    vector<uint32_t> parent;
+    vector<uint32_t> occurs;
+
+    unordered_map<vector<uint32_t>, cpp_int, KeyHash> cache;
+
+    static size_t index(int32_t lit) { return 2 * std::abs(lit) + (lit < 0); }
+
+    int8_t value(int32_t lit) const;
+    bool satisfied(uint32_t c) const;
+
+    // Assign a literal and propagate. Return false on conflict.
+    bool assign(int32_t lit);
+    void undo(size_t mark);
+
+    uint32_t find_root(uint32_t v);
+
+    cpp_int split(vector<uint32_t> const &vars, vector<uint32_t> const &cls);
+    cpp_int count_component(vector<uint32_t> const &vars,
+                            vector<uint32_t> const &cls);
+};
+
+ModelCounter::ModelCounter(clauses_t const &clauses, uint32_t nvars,
+                           vector<bool> const &projected)
+    : clauses{clauses},
+      nvars{nvars},
+      projected{projected},
+      occ(2 * (nvars + 1)),
+      vals(nvars + 1, 0),
+      parent(nvars + 1),
+      occurs(nvars + 1, 0) {
+    for (uint32_t c = 0; c < clauses.size(); ++c) {
+        for (int32_t x : clauses[c]) {
+            occ[index(x)].push_back(c);
+        }
+    }
+}
+
+int8_t ModelCounter::value(int32_t lit) const {
+    auto val = vals[std::abs(lit)];
+    return lit < 0 ? -val : val;
+}
+
+bool ModelCounter::satisfied(uint32_t c) const {
+    for (int32_t x : clauses[c]) {
+        if (value(x) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ModelCounter::assign(int32_t lit) {
+    auto head = trail.size();
+    vals[std::abs(lit)] = lit < 0 ? -1 : 1;
+    trail.push_back(lit);
+
+    while (head < trail.size()) {
+        auto x = trail[head++];
+        // Only clauses that contain the complement can become unit
+        for (auto c : occ[index(-x)]) {
+            int32_t unit = 0;
+            size_t nfree = 0;
+            bool sat = false;
+            for (int32_t y : clauses[c]) {
+                auto val = value(y);
+                if (val > 0) {
+                    sat = true;
+                    break;
+                }
+                if (val == 0) {
+                    unit = y;
+                    ++nfree;
+                }
+            }
+            if (sat || nfree > 1) {
+                continue;
+            }
+            if (nfree == 0) {
+                return false;
+            }
+            vals[std::abs(unit)] = unit < 0 ? -1 : 1;
+            trail.push_back(unit);
+        }
+    }
+
+    return true;
+}
+
+void ModelCounter::undo(size_t mark) {
+    while (trail.size() > mark) {
+        vals[std::abs(trail.back())] = 0;
+        trail.pop_back();
+    }
+}
+
+uint32_t ModelCounter::find_root(uint32_t v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+cpp_int ModelCounter::count() {
+    for (auto const &clause : clauses) {
+        if (clause.empty()) {
+            return 0;
+        }
+    }
+
+    auto mark = trail.size();
+    for (auto const &clause : clauses) {
+        if (clause.size() == 1) {
+            auto x = clause[0];
+            if (value(x) < 0 || (value(x) == 0 && !assign(x))) {
+                undo(mark);
+                return 0;
+            }
+        }
+    }
+
+    vector<uint32_t> vars;
+    for (uint32_t v = 1; v <= nvars; ++v) {
+        vars.push_back(v);
+    }
+    vector<uint32_t> cls;
+    for (uint32_t c = 0; c < clauses.size(); ++c) {
+        cls.push_back(c);
+    }
+
+    auto result = split(vars, cls);
+    undo(mark);
+    return result;
+}
+
+// Count the models of the unsatisfied clauses of a component,
+// after an assignment, over its free variables
+cpp_int ModelCounter::split(vector<uint32_t> const &vars,
+                            vector<uint32_t> const &cls) {
+    for (auto v : vars) {
+        parent[v] = v;
+        occurs[v] = 0;
+    }
+
+    // Partition the clauses into variable-disjoint components
+    vector<uint32_t> active;
+    for (auto c : cls) {
+        if (satisfied(c)) {
+            continue;
+        }
+        active.push_back(c);
+        uint32_t r0 = 0;
+        for (int32_t x : clauses[c]) {
+            if (value(x) == 0) {
+                uint32_t v = std::abs(x);
+                ++occurs[v];
+                auto r = find_root(v);
+                if (r0 == 0) {
+                    r0 = r;
+                } else if (r != r0) {
+                    parent[r] = r0;
+                }
+            }
+        }
+    }
+
+    // Free variables that appear in no clause are don't-cares
+    uint32_t ndontcares = 0;
+    unordered_map<uint32_t, size_t> root2comp;
+    vector<std::pair<vector<uint32_t>, vector<uint32_t>>> comps;
+    for (auto v : vars) {
+        if (vals[v] != 0) {
+            continue;
+        }
+        if (occurs[v] == 0) {
+            ndontcares += projected[v];
+            continue;
+        }
+        auto r = find_root(v);
+        auto search = root2comp.find(r);
+        if (search == root2comp.end()) {
+            search = root2comp.insert({r, comps.size()}).first;
+            comps.emplace_back();
+        }
+        comps[search->second].first.push_back(v);
+    }
+    for (auto c : active) {
+        for (int32_t x : clauses[c]) {
+            if (value(x) == 0) {
+                auto r = find_root(std::abs(x));
+                comps[root2comp[r]].second.push_back(c);
+                break;
+            }
+        }
+    }
+
+    cpp_int result = cpp_int(1) << ndontcares;
+    for (auto const &comp : comps) {
+        result *= count_component(comp.first, comp.second);
+        if (result == 0) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+cpp_int ModelCounter::count_component(vector<uint32_t> const &vars,
+                                      vector<uint32_t> const &cls) {
+    // Both lists are sorted, and zero separates them
+    vector<uint32_t> key(vars);
+    key.push_back(0);
+    key.insert(key.end(), cls.begin(), cls.end());
+
+    auto search = cache.find(key);
+    if (search != cache.end()) {
+        return search->second;
+    }
+
+    // Branch on the projected variable with the most occurrences
+    for (auto u : vars) {
+        occurs[u] = 0;
+    }
+    for (auto c : cls) {
+        for (int32_t x : clauses[c]) {
+            if (value(x) == 0) {
+                ++occurs[std::abs(x)];
+            }
+        }
+    }
+    uint32_t v = 0;
+    for (auto u : vars) {
+        if (v == 0 || projected[u] > projected[v] ||
+            (projected[u] == projected[v] && occurs[u] > occurs[v])) {
+            v = u;
+        }
+    }
+
+    cpp_int result = 0;
+    for (int32_t lit : {static_cast<int32_t>(v), -static_cast<int32_t>(v)}) {
+        auto mark = trail.size();
+        if (assign(lit)) {
+            auto n = split(vars, cls);
+            if (projected[v]) {
+                result += n;
+            } else if (n > 0) {
+                // One model is enough
+                result = 1;
+            }
+        }
+        undo(mark);
+        if (!projected[v] && result > 0) {
+            break;
+        }
+    }
+
+    if (cache.size() >= CACHE_LIMIT) {
+        cache.clear();
+    }
+    cache.insert({std::move(key), result});
+
+    return result;
+}
+
+// Normalize the clauses of a CNF, and count its models
+static cpp_int count_projected(Cnf const &cnf, vector<bool> const &projected) {
+    clauses_t clauses;
+    for (size_t i = 0; i < cnf.nclauses(); ++i) {
+        vector<int32_t> clause(cnf.lits.begin() + cnf.offsets[i],
+                               cnf.lits.begin() + cnf.offsets[i + 1]);
+        std::sort(clause.begin(), clause.end());
+        clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+
+        if (clause.empty()) {
+            return 0;
+        }
+
+        // Drop tautologies
+        bool taut = false;
+        for (int32_t x : clause) {
+            taut = taut || std::binary_search(clause.begin(), clause.end(), -x);
+        }
+        if (!taut) {
+            clauses.push_back(std::move(clause));
+        }
+    }
+
+    ModelCounter counter(clauses, cnf.nvars, projected);
+    return counter.count();
+}
+
+cpp_int count_sat(Cnf const &cnf) {
+    return count_projected(cnf, vector<bool>(cnf.nvars + 1, true));
+}
+
+cpp_int BoolExpr::count_sat() const {
+    auto f = simplify();
+
+    // Unknown constants are not satisfiable
+    if (IS_UNKNOWN(f)) {
+        return 0;
+    }
+
+    CnfEncoder encoder;
+    encoder.add(f);
+    auto const &cnf = encoder.cnf;
+
+    // Anonymous inputs, like the auxiliaries of card and PB encodings,
+    // are projected away. Tseytin variables are functions of every input,
+    // so without anonymous inputs they may join the count.
+    vector<bool> named(cnf.nvars + 1, false);
+    bool anon = false;
+    uint32_t ninputs = 0;
+    for (uint32_t v = 1; v <= cnf.nvars; ++v) {
+        auto const &x = encoder.idx2var[v];
+        if (x && x->ctx->is_anon(x->id)) {
+            anon = true;
+        } else if (x) {
+            named[v] = true;
+            ++ninputs;
+        }
+    }
+    auto result = anon ? count_projected(cnf, named) : boolexpr::count_sat(cnf);
+
+    // Inputs that simplify removed are don't-cares
+    uint32_t nsupport = 0;
+    for (auto const &x : support()) {
+        nsupport += !x->ctx->is_anon(x->id);
+    }
+    return result << (nsupport - ninputs);
+}
+
+// Hashing-based counter, after ApproxMC
+//
+// One incremental solver serves every query. Each XOR row and each
+// enumeration is guarded by an activation literal, which the query
+// passes as an assumption.
+class ApproxCounter {
+public:
+    uint32_t const threshold;
+
+    // CNF variables of the inputs
+    vector<int32_t> inputs;
+
+    ApproxCounter(bx_t const &f, uint32_t threshold, uint32_t seed);
+
+    // Draw a fresh hash function
+    void new_hash();
+
+    // Count the solutions in the cell of the first m rows, up to threshold
+    uint32_t bounded_count(uint32_t m);
+
+private:
+    CnfEncoder encoder;
+    Glucose::Solver solver;
+    size_t loaded;
+
+    std::mt19937 rng;
+
+    // Activation literals of the current hash rows
+    vector<int32_t> rows;
+
+    void add_row();
+};
+
+static Lit to_lit(int32_t x) { return mkLit(std::abs(x) - 1, x < 0); }
+
+ApproxCounter::ApproxCounter(bx_t const &f, uint32_t threshold, uint32_t seed)
+    : threshold{threshold}, loaded{0}, rng(seed) {
+    encoder.add(f);
+    // Anonymous inputs are projected away
+    for (uint32_t v = 1; v <= encoder.cnf.nvars; ++v) {
+        auto const &x = encoder.idx2var[v];
+        if (x && !x->ctx->is_anon(x->id)) {
+            inputs.push_back(v);
+        }
+    }
+}
+
+void ApproxCounter::new_hash() { rows.clear(); }
+
+void ApproxCounter::add_row() {
+    // Each input is in the row with probability 1/2
+    vector<bx_t> xs;
+    for (int32_t v : inputs) {
+        if (rng() & 1) {
+            xs.push_back(encoder.idx2var[v]);
+        }
+    }
+    auto y = encoder.encode(xor_(xs));
+    auto a = encoder.new_var();
+    encoder.cnf.add_clause({-a, (rng() & 1) ? y : -y});
+    rows.push_back(a);
+}
+
+uint32_t ApproxCounter::bounded_count(uint32_t m) {
+    while (rows.size() < m) {
+        add_row();
+    }
+
+    // Guards the blocking clauses of this enumeration
+    auto b = encoder.new_var();
+
+    encoder.cnf.load(solver, loaded);
+    loaded = encoder.cnf.nclauses();
+
+    Glucose::vec<Lit> assumps;
+    for (uint32_t i = 0; i < m; ++i) {
+        assumps.push(to_lit(rows[i]));
+    }
+    assumps.push(to_lit(b));
+
+    uint32_t n = 0;
+    Glucose::vec<Lit> clause;
+    while (n < threshold && solver.solve(assumps)) {
+        ++n;
+        clause.clear();
+        clause.push(to_lit(-b));
+        for (int32_t v : inputs) {
+            clause.push(mkLit(v - 1, solver.modelValue(v - 1) == l_True));
+        }
+        solver.addClause(clause);
+    }
+
+    // Retire this enumeration's blocking clauses
+    solver.addClause(to_lit(-b));
+
+    return n;
+}
+
+cpp_int BoolExpr::approx_count_sat(double epsilon, double delta,
+                                   uint32_t seed) const {
+    assert(epsilon > 0);
+    assert(0 < delta && delta < 1);
+
+    auto f = simplify();
+
+    // Unknown constants are not satisfiable
+    if (IS_UNKNOWN(f)) {
+        return 0;
+    }
+
+    auto threshold = static_cast<uint32_t>(
+        std::ceil(1 + 9.84 * (1 + epsilon / (1 + epsilon)) *
+                          std::pow(1 + 1 / epsilon, 2)));
+    auto iters = static_cast<uint32_t>(std::ceil(17 * std::log2(3 / delta)));
+
+    ApproxCounter counter(f, threshold, seed);
+    uint32_t ninputs = counter.inputs.size();
+    uint32_t nsupport = 0;
+    for (auto const &x : support()) {
+        nsupport += !x->ctx->is_anon(x->id);
+    }
+    auto dontcares = nsupport - ninputs;
+
+    // Small counts are exact
+    auto n = counter.bounded_count(0);
+    if (n < threshold) {
+        return cpp_int(n) << dontcares;
+    }
+
+    vector<cpp_int> estimates;
+
+    // Search for the fewest rows that make the cell small,
+    // starting from the previous answer
+    uint32_t m = 1;
+    for (uint32_t i = 0; i < iters; ++i) {
+        counter.new_hash();
+
+        unordered_map<uint32_t, uint32_t> counts;
+        auto count = [&](uint32_t k) -> uint32_t {
+            auto search = counts.find(k);
+            if (search != counts.end()) {
+                return search->second;
+            }
+            auto c = counter.bounded_count(k);
+            counts.insert({k, c});
+            return c;
+        };
+
+        if (count(m) < threshold) {
+            while (m > 1 && count(m - 1) < threshold) {
+                --m;
+            }
+        } else {
+            while (m < ninputs && count(m) >= threshold) {
+                ++m;
+            }
+        }
+
+        estimates.push_back(cpp_int(count(m)) << m);
+    }
+
+    std::sort(estimates.begin(), estimates.end());
+    return estimates[estimates.size() / 2] << dontcares;
+}
+
+}  // namespace boolexpr
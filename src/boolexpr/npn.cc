@@ -0,0 +1,234 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // swap
+#include <cassert>
+
+#include "boolexpr/boolexpr.h"
+#include "truthtable.h"
+
+using std::make_pair;
+using std::pair;
+using std::vector;
+
+namespace boolexpr {
+
+// Transform built up one flip or swap at a time.
+// The current table is t(x) = f(y), where y[k] = x[perm[k]] ^ (negs >> k).
+class Tracker {
+public:
+    explicit Tracker(uint32_t n) : perm(n), inv(n), negs{0} {
+        for (uint32_t i = 0; i < n; ++i) {
+            perm[i] = inv[i] = i;
+        }
+    }
+
+    void flip(uint32_t i) { negs ^= 1u << inv[i]; }
+
+    void swap(uint32_t i, uint32_t j) {
+        perm[inv[i]] = j;
+        perm[inv[j]] = i;
+        std::swap(inv[i], inv[j]);
+    }
+
+    NpnTransform transform(bool out) const { return {perm, negs, out}; }
+
+private:
+    vector<uint32_t> perm;
+    vector<uint32_t> inv;
+    uint32_t negs;
+};
+
+static uint32_t lowest_bit(uint64_t x) {
+    uint32_t i = 0;
+    while (!((x >> i) & 1)) {
+        ++i;
+    }
+    return i;
+}
+
+// Try every transform of a table of at most six inputs, in one word.
+// Heap's algorithm visits each input order with one swap,
+// and a Gray code visits each input polarity with one flip.
+static NpnTransform npn_exact(TruthTable const &f) {
+    auto n = f.nvars();
+    auto word = f.words()[0];
+
+    Tracker tracker(n);
+    auto best = word;
+    auto transform = tracker.transform(false);
+
+    auto polarities = [&]() {
+        auto count = uint64_t(1) << n;
+        for (uint64_t k = 1; k <= count; ++k) {
+            if (word < best) {
+                best = word;
+                transform = tracker.transform(false);
+            }
+            if (~word < best) {
+                best = ~word;
+                transform = tracker.transform(true);
+            }
+            if (k < count) {
+                auto i = lowest_bit(k);
+                word = flip_word(word, i);
+                tracker.flip(i);
+            }
+        }
+    };
+
+    polarities();
+
+    vector<uint32_t> c(n, 0);
+    for (uint32_t i = 1; i < n;) {
+        if (c[i] < i) {
+            auto j = (i % 2 == 0) ? 0 : c[i];
+            word = swap_word(word, j, i);
+            tracker.swap(j, i);
+            polarities();
+            ++c[i];
+            i = 1;
+        } else {
+            c[i] = 0;
+            ++i;
+        }
+    }
+
+    return transform;
+}
+
+// Number of minterms in the positive cofactor of input i
+static uint64_t positive_count(TruthTable const &t, uint32_t i) {
+    return (t & TruthTable::var(t.nvars(), i)).count();
+}
+
+// Normalize a larger table by its cofactor counts,
+// then take any single flip or swap that makes it smaller.
+static NpnTransform npn_heuristic(TruthTable const &f) {
+    auto n = f.nvars();
+    Tracker tracker(n);
+
+    auto t = f;
+    bool out = false;
+
+    // At most half the minterms are one
+    auto half = uint64_t(1) << (n - 1);
+    if (t.count() > half) {
+        t = ~t;
+        out = true;
+    }
+
+    // Each input has at most half the onset in its positive cofactor
+    auto onset = t.count();
+    for (uint32_t i = 0; i < n; ++i) {
+        if (2 * positive_count(t, i) > onset) {
+            t = t.flip(i);
+            tracker.flip(i);
+        }
+    }
+
+    // Inputs with fewer positive minterms come first
+    for (uint32_t i = 0; i < n; ++i) {
+        auto min = i;
+        auto min_count = positive_count(t, i);
+        for (auto j = i + 1; j < n; ++j) {
+            auto count = positive_count(t, j);
+            if (count < min_count) {
+                min = j;
+                min_count = count;
+            }
+        }
+        if (min != i) {
+            t = t.swap(i, min);
+            tracker.swap(i, min);
+        }
+    }
+
+    for (uint32_t round = 0; round < n; ++round) {
+        bool improved = false;
+
+        if (2 * t.count() == uint64_t(1) << n && ~t < t) {
+            t = ~t;
+            out = !out;
+            improved = true;
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            auto u = t.flip(i);
+            if (u < t) {
+                t = u;
+                tracker.flip(i);
+                improved = true;
+            }
+            for (auto j = i + 1; j < n; ++j) {
+                auto v = t.swap(i, j);
+                if (v < t) {
+                    t = v;
+                    tracker.swap(i, j);
+                    improved = true;
+                }
+            }
+        }
+
+        if (!improved) {
+            break;
+        }
+    }
+
+    return tracker.transform(out);
+}
+
+TruthTable npn_apply(TruthTable const &f, NpnTransform const &transform) {
+    auto n = f.nvars();
+    assert(transform.perm.size() == n);
+
+    TruthTable g(n);
+    for (uint64_t x = 0; x < (uint64_t(1) << n); ++x) {
+        uint64_t y = 0;
+        for (uint32_t k = 0; k < n; ++k) {
+            auto bit = ((x >> transform.perm[k]) ^ (transform.negs >> k)) & 1;
+            y |= bit << k;
+        }
+        g.set(x, f.get(y) != transform.out);
+    }
+    return g;
+}
+
+pair<TruthTable, NpnTransform> npn_canon(TruthTable const &f) {
+    auto transform = f.nvars() <= 6 ? npn_exact(f) : npn_heuristic(f);
+    return make_pair(npn_apply(f, transform), transform);
+}
+
+boost::optional<TruthTable> BoolExpr::npn_class() const {
+    auto self = shared_from_this();
+
+    vector<var_t> vars;
+    if (!small_support({self}, vars)) {
+        return boost::none;
+    }
+    TruthTable tt(self, vars);
+
+    // Move the inputs the function depends on to the front,
+    // and drop the rest.
+    auto support = tt.support();
+    for (uint32_t k = 0; k < support.size(); ++k) {
+        tt = tt.swap(k, support[k]);
+    }
+    TruthTable small(support.size());
+    for (uint64_t m = 0; m < (uint64_t(1) << support.size()); ++m) {
+        small.set(m, tt.get(m));
+    }
+
+    return npn_canon(small).first;
+}
+
+}  // namespace boolexpr
@@ -0,0 +1,359 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // max, min, sort
+#include <cassert>
+#include <deque>
+#include <map>
+
+#include "boolexpr/boolexpr.h"
+
+using std::deque;
+using std::map;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace boolexpr {
+
+// Above this many potential BDD nodes, AUTO prefers another encoding
+static size_t const BDD_LIMIT = 1 << 16;
+
+// Above this many distinct weights, AUTO prefers ADDER over GTE
+static size_t const GTE_LIMIT = 8;
+
+// Largest sum of absolute weights.
+// With k clamped to it, no partial sum below can overflow.
+static int64_t const PB_MAX_SUM = int64_t(1) << 61;
+
+// Eén-Sörensson BDD: node(i, k) means "sum of terms i.. is at most k".
+// Since the root is asserted, each node only needs the clauses that
+// imply its children.
+static bx_t pb_bdd(Context &ctx, string const &auxvarname,
+                   vector<bx_t> const &xs, vector<int64_t> const &ws,
+                   vector<int64_t> const &suffix, size_t i, int64_t k,
+                   map<pair<size_t, int64_t>, bx_t> &memo,
+                   vector<bx_t> &clauses) {
+    if (k < 0) {
+        return zero();
+    }
+    if (k >= suffix[i]) {
+        return one();
+    }
+
+    auto search = memo.find({i, k});
+    if (search != memo.end()) {
+        return search->second;
+    }
+
+    auto hi = pb_bdd(ctx, auxvarname, xs, ws, suffix, i + 1, k - ws[i], memo,
+                     clauses);
+    auto lo =
+        pb_bdd(ctx, auxvarname, xs, ws, suffix, i + 1, k, memo, clauses);
+
+    bx_t node = ctx.get_anon_var(auxvarname);
+    if (IS_ZERO(hi)) {
+        clauses.push_back(or_({~node, ~xs[i]}));
+    } else {
+        clauses.push_back(or_({~node, ~xs[i], hi}));
+    }
+    if (!IS_ONE(lo)) {
+        clauses.push_back(or_({~node, lo}));
+    }
+
+    memo.insert({{i, k}, node});
+    return node;
+}
+
+// Append clauses for y = xs[0] ^ xs[1] ^ ...
+static void eq_parity(bx_t const &y, vector<bx_t> const &xs,
+                      vector<bx_t> &clauses) {
+    size_t n = xs.size();
+    for (size_t i = 0; i < (1u << n); ++i) {
+        vector<bx_t> lits;
+        bool parity = false;
+        for (size_t j = 0; j < n; ++j) {
+            bool val = (i >> j) & 1u;
+            lits.push_back(val ? ~xs[j] : xs[j]);
+            parity ^= val;
+        }
+        lits.push_back(parity ? y : ~y);
+        clauses.push_back(or_(std::move(lits)));
+    }
+}
+
+// Append clauses for y = "at least two of xs[0..n)", for n = 2 or 3
+static void eq_carry(bx_t const &y, vector<bx_t> const &xs,
+                     vector<bx_t> &clauses) {
+    size_t n = xs.size();
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            clauses.push_back(or_({~xs[i], ~xs[j], y}));
+        }
+    }
+    if (n == 2) {
+        clauses.push_back(or_({xs[0], ~y}));
+        clauses.push_back(or_({xs[1], ~y}));
+    } else {
+        clauses.push_back(or_({xs[0], xs[1], ~y}));
+        clauses.push_back(or_({xs[0], xs[2], ~y}));
+        clauses.push_back(or_({xs[1], xs[2], ~y}));
+    }
+}
+
+// Eén-Sörensson adder network: sum the weight bits column by column with
+// full and half adders, then compare the binary sum against k.
+static bx_t pb_adder(Context &ctx, string const &auxvarname,
+                     vector<bx_t> const &xs, vector<int64_t> const &ws,
+                     int64_t k, vector<bx_t> &clauses) {
+    vector<deque<bx_t>> columns;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        for (size_t b = 0; (ws[i] >> b) != 0; ++b) {
+            if ((ws[i] >> b) & 1) {
+                if (columns.size() <= b) {
+                    columns.resize(b + 1);
+                }
+                columns[b].push_back(xs[i]);
+            }
+        }
+    }
+
+    vector<bx_t> bits;
+    for (size_t b = 0; b < columns.size(); ++b) {
+        if (columns[b].size() > 1 && columns.size() == b + 1) {
+            columns.resize(b + 2);
+        }
+
+        auto &column = columns[b];
+        while (column.size() > 1) {
+            size_t n = column.size() == 2 ? 2 : 3;
+            vector<bx_t> ins(column.begin(), column.begin() + n);
+            column.erase(column.begin(), column.begin() + n);
+
+            bx_t sum = ctx.get_anon_var(auxvarname);
+            bx_t carry = ctx.get_anon_var(auxvarname);
+            eq_parity(sum, ins, clauses);
+            eq_carry(carry, ins, clauses);
+
+            column.push_back(sum);
+            columns[b + 1].push_back(carry);
+        }
+        bits.push_back(column.empty() ? bx_t(zero()) : column.front());
+    }
+
+    // Compare from the LSB up: le means "bits[0..b] <= k[0..b]"
+    bx_t le = one();
+    for (size_t b = 0; b < bits.size(); ++b) {
+        if ((k >> b) & 1) {
+            le = or_s({~bits[b], le});
+        } else {
+            le = and_s({~bits[b], le});
+        }
+    }
+
+    return le->tseytin(ctx, auxvarname);
+}
+
+// Joshi-Martins-Manquinho generalized totalizer over xs[lo..hi).
+// Each node maps every reachable partial sum (capped at k+1) to a variable.
+static map<int64_t, bx_t> pb_gte(Context &ctx, string const &auxvarname,
+                                 vector<bx_t> const &xs,
+                                 vector<int64_t> const &ws, size_t lo,
+                                 size_t hi, int64_t k, vector<bx_t> &clauses) {
+    if (hi - lo == 1) {
+        return map<int64_t, bx_t>{{ws[lo], xs[lo]}};
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    auto as = pb_gte(ctx, auxvarname, xs, ws, lo, mid, k, clauses);
+    auto bs = pb_gte(ctx, auxvarname, xs, ws, mid, hi, k, clauses);
+
+    map<int64_t, bx_t> rs;
+    auto get = [&](int64_t sum) {
+        sum = std::min(sum, k + 1);
+        auto search = rs.find(sum);
+        if (search == rs.end()) {
+            bx_t r = ctx.get_anon_var(auxvarname);
+            search = rs.insert({sum, r}).first;
+        }
+        return search->second;
+    };
+
+    for (auto const &a : as) {
+        clauses.push_back(or_({~a.second, get(a.first)}));
+    }
+    for (auto const &b : bs) {
+        clauses.push_back(or_({~b.second, get(b.first)}));
+    }
+    for (auto const &a : as) {
+        for (auto const &b : bs) {
+            clauses.push_back(
+                or_({~a.second, ~b.second, get(a.first + b.first)}));
+        }
+    }
+
+    return rs;
+}
+
+boost::optional<bx_t> pb_leq(Context &ctx, vector<bx_t> const &args,
+                             vector<int64_t> const &weights, int64_t k,
+                             PBEncoding encoding, string const &auxvarname) {
+    assert(args.size() == weights.size());
+
+    // The sum lies in [-neg, pos]
+    int64_t pos = 0, neg = 0;
+    for (int64_t w : weights) {
+        if (w < -PB_MAX_SUM || w > PB_MAX_SUM) {
+            return boost::none;
+        }
+        if (w > 0) {
+            pos += w;
+        } else {
+            neg -= w;
+        }
+        if (pos + neg > PB_MAX_SUM) {
+            return boost::none;
+        }
+    }
+
+    if (k >= pos) {
+        return bx_t(one());
+    }
+    if (k < -neg) {
+        return bx_t(zero());
+    }
+
+    // Normalize to positive weights: w*x = w + (-w)*~x
+    k += neg;
+    vector<bx_t> terms;
+    vector<int64_t> ws;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (weights[i] > 0) {
+            terms.push_back(args[i]);
+            ws.push_back(weights[i]);
+        } else if (weights[i] < 0) {
+            terms.push_back(~args[i]);
+            ws.push_back(-weights[i]);
+        }
+    }
+
+    // Terms that exceed k on their own must be false
+    vector<bx_t> clauses;
+    vector<bx_t> xs;
+    vector<int64_t> _ws;
+    int64_t total = 0;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        if (ws[i] > k) {
+            clauses.push_back(~terms[i]);
+        } else {
+            xs.push_back(terms[i]);
+            _ws.push_back(ws[i]);
+            total += ws[i];
+        }
+    }
+
+    if (total <= k) {
+        return bx_t(and_s(std::move(clauses)));
+    }
+
+    // Heaviest terms first make smaller BDDs and adder networks
+    vector<size_t> order(xs.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&_ws](size_t i, size_t j) { return _ws[i] > _ws[j]; });
+    vector<bx_t> sorted_xs;
+    ws.clear();
+    for (size_t i : order) {
+        sorted_xs.push_back(xs[i]);
+        ws.push_back(_ws[i]);
+    }
+    xs = std::move(sorted_xs);
+
+    if (encoding == PBEncoding::AUTO) {
+        if (ws.front() == ws.back()) {
+            clauses.push_back(at_most_k(ctx, xs, k / ws.front(),
+                                        CardEncoding::TOTALIZER, auxvarname));
+            return bx_t(and_s(std::move(clauses)));
+        }
+
+        size_t distinct = 1;
+        for (size_t i = 1; i < ws.size(); ++i) {
+            distinct += ws[i] != ws[i - 1];
+        }
+
+        if (static_cast<uint64_t>(k) < BDD_LIMIT / xs.size()) {
+            encoding = PBEncoding::BDD;
+        } else if (distinct <= GTE_LIMIT) {
+            encoding = PBEncoding::GTE;
+        } else {
+            encoding = PBEncoding::ADDER;
+        }
+    }
+
+    switch (encoding) {
+        case PBEncoding::BDD: {
+            vector<int64_t> suffix(xs.size() + 1, 0);
+            for (size_t i = xs.size(); i-- > 0;) {
+                suffix[i] = suffix[i + 1] + ws[i];
+            }
+            map<pair<size_t, int64_t>, bx_t> memo;
+            clauses.push_back(pb_bdd(ctx, auxvarname, xs, ws, suffix, 0, k,
+                                     memo, clauses));
+            break;
+        }
+        case PBEncoding::ADDER:
+            clauses.push_back(pb_adder(ctx, auxvarname, xs, ws, k, clauses));
+            break;
+        case PBEncoding::GTE:
+        default: {
+            auto rs = pb_gte(ctx, auxvarname, xs, ws, 0, xs.size(), k,
+                             clauses);
+            auto search = rs.find(k + 1);
+            if (search != rs.end()) {
+                clauses.push_back(~search->second);
+            }
+            break;
+        }
+    }
+
+    return bx_t(and_s(std::move(clauses)));
+}
+
+boost::optional<bx_t> pb_geq(Context &ctx, vector<bx_t> const &args,
+                             vector<int64_t> const &weights, int64_t k,
+                             PBEncoding encoding, string const &auxvarname) {
+    // sum(w*x) >= k <=> sum(-w*x) <= -k
+    vector<int64_t> negs;
+    for (int64_t w : weights) {
+        if (w < -PB_MAX_SUM) {
+            return boost::none;
+        }
+        negs.push_back(-w);
+    }
+    // Any smaller k is always met, and this one can be negated
+    k = std::max(k, -PB_MAX_SUM - 1);
+    return pb_leq(ctx, args, negs, -k, encoding, auxvarname);
+}
+
+boost::optional<bx_t> pb_eq(Context &ctx, vector<bx_t> const &args,
+                            vector<int64_t> const &weights, int64_t k,
+                            PBEncoding encoding, string const &auxvarname) {
+    auto le = pb_leq(ctx, args, weights, k, encoding, auxvarname);
+    auto ge = pb_geq(ctx, args, weights, k, encoding, auxvarname);
+    if (!le || !ge) {
+        return boost::none;
+    }
+    return bx_t(and_s({*le, *ge}));
+}
+
+}  // namespace boolexpr
@@ -0,0 +1,181 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+#include "boolexpr/boolexpr.h"
+#include "limiter.h"
+
+using std::atomic;
+using std::thread;
+using std::unique_ptr;
+using std::vector;
+
+using Glucose::Lit;
+using Glucose::lbool;  // l_False, l_True, l_Undef
+using Glucose::mkLit;
+
+namespace boolexpr {
+
+// Conflicts in the first round; each round doubles it
+static int64_t const FIRST_BUDGET = 1000;
+
+// Glucose restarts when recent LBDs, scaled by K, exceed the average.
+// The default is 0.8; a larger K restarts more eagerly.
+static double const RESTART_K[] = {0.8, 0.7, 0.9, 0.75, 0.85};
+
+SatOptions::SatOptions()
+    : nthreads{1},
+      cube_depth{0},
+      conflict_limit{-1},
+      propagation_limit{-1},
+      time_limit{0.0} {}
+
+Portfolio::Portfolio(uint32_t nthreads) : win{0} {
+    assert(nthreads > 0);
+
+    for (uint32_t i = 0; i < nthreads; ++i) {
+        unique_ptr<Glucose::Solver> solver(new Glucose::Solver());
+        // The first solver keeps the defaults
+        if (i > 0) {
+            solver->random_seed += 7919.0 * i;
+            solver->random_var_freq = 0.01 * (i % 4);
+            solver->rnd_init_act = i & 1;
+            solver->K = RESTART_K[i % 5];
+        }
+        solvers.push_back(std::move(solver));
+    }
+}
+
+void Portfolio::load(Cnf const &cnf, size_t first) {
+    for (size_t i = 0; i < solvers.size(); ++i) {
+        auto &solver = *solvers[i];
+        auto nvars = solver.nVars();
+        cnf.load(solver, first);
+        // Half of the solvers try the positive phase first
+        if (i & 2) {
+            for (int v = nvars; v < solver.nVars(); ++v) {
+                solver.setPolarity(v, false);
+            }
+        }
+    }
+}
+
+bool Portfolio::solve() { return solve(Glucose::vec<Lit>()); }
+
+bool Portfolio::solve(Glucose::vec<Lit> const &assumps) {
+    return solve_limited(assumps, SatOptions()) == l_True;
+}
+
+lbool Portfolio::solve_limited(Glucose::vec<Lit> const &assumps,
+                               SatOptions const &options) {
+    vector<Glucose::Solver *> ptrs;
+    for (auto &solver : solvers) {
+        ptrs.push_back(solver.get());
+    }
+
+    lbool result = l_Undef;
+
+    // The limiter must be gone before the interrupts are cleared
+    {
+        SatLimiter limiter(options, ptrs);
+        if (solvers.size() == 1) {
+            win = 0;
+            if (limiter.set_budget(0)) {
+                result = solvers[0]->solveLimited(assumps);
+            }
+        } else {
+            result = race(assumps, limiter);
+        }
+    }
+
+    for (auto &solver : solvers) {
+        solver->clearInterrupt();
+        solver->budgetOff();
+    }
+
+    return result;
+}
+
+lbool Portfolio::race(Glucose::vec<Lit> const &assumps, SatLimiter &limiter) {
+    int nvars = solvers[0]->nVars();
+
+    // Units learned at level zero: 0 unknown, 1 true, 2 false.
+    // Any solver may publish a unit, since they all load the same clauses.
+    // These are the only learned clauses that are exchanged.
+    unique_ptr<atomic<uint8_t>[]> units(new atomic<uint8_t>[nvars]);
+    for (int v = 0; v < nvars; ++v) {
+        units[v].store(0);
+    }
+
+    atomic<bool> done(false);
+    lbool result = l_Undef;
+
+    auto run = [&](size_t i) {
+        auto &solver = *solvers[i];
+
+        for (int64_t budget = FIRST_BUDGET;; budget *= 2) {
+            for (int v = 0; v < nvars; ++v) {
+                auto unit = units[v].load(std::memory_order_relaxed);
+                if (unit != 0 && solver.value(v) == l_Undef) {
+                    solver.addClause(mkLit(v, unit == 2));
+                }
+            }
+
+            if (!limiter.set_budget(i, budget)) {
+                return;
+            }
+            auto r = solver.solveLimited(assumps);
+
+            if (r != l_Undef) {
+                if (!done.exchange(true)) {
+                    win = i;
+                    result = r;
+                    for (auto &other : solvers) {
+                        other->interrupt();
+                    }
+                }
+                return;
+            }
+
+            if (done.load() || limiter.stopped()) {
+                return;
+            }
+
+            for (int v = 0; v < nvars; ++v) {
+                auto val = solver.value(v);
+                if (val == l_True) {
+                    units[v].store(1, std::memory_order_relaxed);
+                } else if (val == l_False) {
+                    units[v].store(2, std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (size_t i = 0; i < solvers.size(); ++i) {
+        threads.emplace_back(run, i);
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    return result;
+}
+
+Glucose::Solver const &Portfolio::winner() const { return *solvers[win]; }
+
+}  // namespace boolexpr
@@ -0,0 +1,616 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <cassert>
+#include <chrono>
+#include <cstdlib>  // abs
+#include <deque>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "boolexpr/boolexpr.h"
+#include "cube.h"
+
+using std::deque;
+using std::make_pair;
+using std::string;
+using std::thread;
+using std::vector;
+
+using Glucose::Lit;
+using Glucose::lbool;  // l_False, l_True, l_Undef
+using Glucose::mkLit;
+
+namespace boolexpr {
+
+#ifndef _WIN32
+
+// Wire protocol.
+//
+// Every message is a one-byte type, a 32-bit payload size, and the payload.
+// Integers are little-endian.
+//
+// The coordinator sends one CNF, in the binary CNF format,
+// then one CUBE at a time to each worker: id, size, and literals.
+// The worker answers each cube with a RESULT: id, status, conflicts,
+// and the model literals if the status is SAT.
+// STOP, or closing the socket, interrupts the worker and ends the session.
+enum MsgType : uint8_t {
+    MSG_CNF = 1,
+    MSG_CUBE = 2,
+    MSG_RESULT = 3,
+    MSG_STOP = 4,
+};
+
+// Refuse anything larger, rather than trusting the peer
+static uint32_t const MAX_PAYLOAD = 1u << 30;
+
+// A worker may still be starting when the coordinator connects
+static int const CONNECT_TRIES = 500;
+static int const CONNECT_WAIT_MS = 10;
+
+#ifdef MSG_NOSIGNAL
+static int const SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static int const SEND_FLAGS = 0;
+#endif
+
+static Lit to_lit(int32_t x) { return mkLit(std::abs(x) - 1, x < 0); }
+
+class Message {
+public:
+    MsgType type;
+    string payload;
+
+    explicit Message(MsgType type) : type{type}, pos{0} {}
+
+    void put_u32(uint32_t x) {
+        for (int i = 0; i < 4; ++i) {
+            payload.push_back(static_cast<char>((x >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void put_u64(uint64_t x) {
+        put_u32(static_cast<uint32_t>(x));
+        put_u32(static_cast<uint32_t>(x >> 32));
+    }
+
+    bool get_u8(uint8_t &x) {
+        if (payload.size() - pos < 1) {
+            return false;
+        }
+        x = static_cast<uint8_t>(payload[pos++]);
+        return true;
+    }
+
+    bool get_u32(uint32_t &x) {
+        if (payload.size() - pos < 4) {
+            return false;
+        }
+        x = 0;
+        for (int i = 0; i < 4; ++i) {
+            x |= static_cast<uint32_t>(static_cast<uint8_t>(payload[pos++]))
+                 << (8 * i);
+        }
+        return true;
+    }
+
+    bool get_u64(uint64_t &x) {
+        uint32_t lo, hi;
+        if (!get_u32(lo) || !get_u32(hi)) {
+            return false;
+        }
+        x = (static_cast<uint64_t>(hi) << 32) | lo;
+        return true;
+    }
+
+    bool get_lits(vector<int32_t> &lits) {
+        uint32_t n;
+        if (!get_u32(n) || (payload.size() - pos) / 4 < n) {
+            return false;
+        }
+        lits.resize(n);
+        for (auto &lit : lits) {
+            uint32_t x = 0;
+            get_u32(x);
+            lit = static_cast<int32_t>(x);
+            if (lit == 0 || lit == INT32_MIN) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    size_t pos;
+};
+
+static bool send_all(int fd, char const *buf, size_t n) {
+    while (n > 0) {
+        auto k = send(fd, buf, n, SEND_FLAGS);
+        if (k <= 0) {
+            return false;
+        }
+        buf += k;
+        n -= k;
+    }
+    return true;
+}
+
+static bool recv_all(int fd, char *buf, size_t n) {
+    while (n > 0) {
+        auto k = recv(fd, buf, n, 0);
+        if (k <= 0) {
+            return false;
+        }
+        buf += k;
+        n -= k;
+    }
+    return true;
+}
+
+static bool send_msg(int fd, Message const &msg) {
+    char header[5];
+    uint32_t size = msg.payload.size();
+    header[0] = static_cast<char>(msg.type);
+    for (int i = 0; i < 4; ++i) {
+        header[1 + i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+    }
+    return send_all(fd, header, sizeof(header)) &&
+           send_all(fd, msg.payload.data(), msg.payload.size());
+}
+
+static bool recv_msg(int fd, Message &msg) {
+    char header[5];
+    if (!recv_all(fd, header, sizeof(header))) {
+        return false;
+    }
+    uint32_t size = 0;
+    for (int i = 0; i < 4; ++i) {
+        size |= static_cast<uint32_t>(static_cast<uint8_t>(header[1 + i]))
+                << (8 * i);
+    }
+    if (size > MAX_PAYLOAD) {
+        return false;
+    }
+    msg = Message(static_cast<MsgType>(header[0]));
+    msg.payload.resize(size);
+    return recv_all(fd, &msg.payload[0], size);
+}
+
+// Unix socket paths contain a '/', and anything else is host:port.
+static int open_socket(string const &address, bool listening) {
+    if (address.find('/') != string::npos) {
+        struct sockaddr_un addr = {};
+        if (address.size() >= sizeof(addr.sun_path)) {
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        address.copy(addr.sun_path, address.size());
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        if (listening) {
+            unlink(address.c_str());
+            if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+                    0 &&
+                listen(fd, 1) == 0) {
+                return fd;
+            }
+        } else if (connect(fd, reinterpret_cast<sockaddr *>(&addr),
+                           sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        return -1;
+    }
+
+    auto colon = address.rfind(':');
+    if (colon == string::npos) {
+        return -1;
+    }
+    auto host = address.substr(0, colon);
+    auto port = address.substr(colon + 1);
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (listening) {
+        hints.ai_flags = AI_PASSIVE;
+    }
+
+    struct addrinfo *res;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(),
+                    &hints, &res) != 0) {
+        return -1;
+    }
+
+    int fd = -1;
+    for (auto ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (listening) {
+            int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 &&
+                listen(fd, 1) == 0) {
+                break;
+            }
+        } else if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(res);
+    return fd;
+}
+
+bool serve_cubes(int fd) {
+    Message msg(MSG_STOP);
+    if (!recv_msg(fd, msg) || msg.type != MSG_CNF) {
+        return false;
+    }
+
+    Cnf cnf;
+    auto first = msg.payload.data();
+    if (!read_binary_cnf(first, first + msg.payload.size(), cnf)) {
+        return false;
+    }
+
+    Glucose::Solver solver;
+    cnf.load(solver);
+
+    // Solve on a second thread, so that a STOP can interrupt it
+    thread busy;
+
+    auto solve = [&solver, &cnf, fd](uint32_t id, vector<int32_t> cube) {
+        Glucose::vec<Lit> assumps;
+        for (auto lit : cube) {
+            assumps.push(to_lit(lit));
+        }
+
+        auto conflicts = solver.conflicts;
+        solver.budgetOff();
+        auto r = solver.solveLimited(assumps);
+
+        Message result(MSG_RESULT);
+        result.put_u32(id);
+        if (r == l_True) {
+            result.payload.push_back(static_cast<char>(CubeStat::SAT));
+        } else if (r == l_False) {
+            result.payload.push_back(static_cast<char>(CubeStat::UNSAT));
+        } else {
+            result.payload.push_back(static_cast<char>(CubeStat::SKIPPED));
+        }
+        result.put_u64(solver.conflicts - conflicts);
+        if (r == l_True) {
+            result.put_u32(cnf.nvars);
+            for (uint32_t v = 1; v <= cnf.nvars; ++v) {
+                auto val = solver.modelValue(static_cast<int>(v - 1));
+                result.put_u32(val == l_False ? -v : v);
+            }
+        }
+        send_msg(fd, result);
+    };
+
+    bool ok = true;
+    for (;;) {
+        if (!recv_msg(fd, msg) || msg.type == MSG_STOP) {
+            break;
+        }
+
+        uint32_t id;
+        vector<int32_t> cube;
+        if (msg.type != MSG_CUBE || !msg.get_u32(id) || !msg.get_lits(cube)) {
+            ok = false;
+            break;
+        }
+        for (auto lit : cube) {
+            if (static_cast<uint32_t>(std::abs(lit)) > cnf.nvars) {
+                ok = false;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+
+        // The coordinator waits for each result before the next cube
+        if (busy.joinable()) {
+            busy.join();
+        }
+        busy = thread(solve, id, std::move(cube));
+    }
+
+    solver.interrupt();
+    if (busy.joinable()) {
+        busy.join();
+    }
+
+    return ok;
+}
+
+bool serve_cubes(string const &address) {
+    int lfd = open_socket(address, true);
+    if (lfd < 0) {
+        return false;
+    }
+
+    int fd = accept(lfd, nullptr, nullptr);
+    close(lfd);
+    if (address.find('/') != string::npos) {
+        unlink(address.c_str());
+    }
+    if (fd < 0) {
+        return false;
+    }
+
+    auto ok = serve_cubes(fd);
+    close(fd);
+    return ok;
+}
+
+soln_t remote_sat(bx_t const &self, vector<int> const &fds,
+                  SatOptions const &options, vector<CubeStat> *stats) {
+    auto f = self->simplify();
+
+    if (stats) {
+        stats->clear();
+    }
+
+    if (!IS_OP(f)) {
+        return f->sat();
+    }
+
+    CnfEncoder encoder;
+    encoder.add(f);
+
+    vector<CubeStat> results;
+    auto cubes = split_cubes(encoder, f, options.cube_depth, results);
+
+    std::ostringstream oss;
+    write_binary_cnf(oss, encoder.cnf);
+    Message cnf_msg(MSG_CNF);
+    cnf_msg.payload = oss.str();
+
+    using clock = std::chrono::steady_clock;
+
+    struct Peer {
+        int fd;
+        bool alive;
+        // Index of the cube in flight, or -1 if idle
+        int64_t cube;
+        clock::time_point start;
+    };
+
+    vector<Peer> peers;
+    for (auto fd : fds) {
+        peers.push_back({fd, send_msg(fd, cnf_msg), -1, clock::now()});
+    }
+
+    deque<size_t> pending;
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        pending.push_back(i);
+    }
+
+    // Give an idle worker the next cube
+    auto dispatch = [&](size_t w) {
+        auto &peer = peers[w];
+        while (peer.alive && peer.cube < 0 && !pending.empty()) {
+            auto i = pending.front();
+            Message msg(MSG_CUBE);
+            msg.put_u32(i);
+            msg.put_u32(cubes[i].size());
+            for (auto lit : cubes[i]) {
+                msg.put_u32(static_cast<uint32_t>(lit));
+            }
+            if (send_msg(peer.fd, msg)) {
+                pending.pop_front();
+                peer.cube = i;
+                peer.start = clock::now();
+            } else {
+                peer.alive = false;
+            }
+        }
+    };
+
+    // A lost worker gives its cube back to the queue
+    auto drop = [&](size_t w) {
+        auto &peer = peers[w];
+        peer.alive = false;
+        if (peer.cube >= 0) {
+            pending.push_front(peer.cube);
+            peer.cube = -1;
+        }
+    };
+
+    bool found = false;
+    point_t point;
+
+    // Read one result, and return false if the worker is lost
+    auto receive = [&](size_t w) {
+        auto &peer = peers[w];
+
+        Message msg(MSG_STOP);
+        uint32_t id;
+        uint8_t status;
+        uint64_t conflicts;
+        if (!recv_msg(peer.fd, msg) || msg.type != MSG_RESULT ||
+            !msg.get_u32(id) || id != peer.cube || !msg.get_u8(status) ||
+            !msg.get_u64(conflicts)) {
+            return false;
+        }
+
+        vector<int32_t> model;
+        if (status == CubeStat::SAT) {
+            if (!msg.get_lits(model)) {
+                return false;
+            }
+        } else if (status != CubeStat::UNSAT) {
+            return false;
+        }
+
+        std::chrono::duration<double> elapsed = clock::now() - peer.start;
+        auto &result = results[id];
+        result.status = static_cast<CubeStat::Status>(status);
+        result.worker = w;
+        result.conflicts = conflicts;
+        result.seconds = elapsed.count();
+        peer.cube = -1;
+
+        if (status == CubeStat::SAT) {
+            point = encoder.model(model);
+            found = true;
+        }
+
+        return true;
+    };
+
+    for (size_t w = 0; w < peers.size(); ++w) {
+        dispatch(w);
+    }
+
+    while (!found) {
+        vector<struct pollfd> pfds;
+        vector<size_t> ws;
+        for (size_t w = 0; w < peers.size(); ++w) {
+            if (peers[w].alive && peers[w].cube >= 0) {
+                pfds.push_back({peers[w].fd, POLLIN, 0});
+                ws.push_back(w);
+            }
+        }
+        if (pfds.empty() || poll(pfds.data(), pfds.size(), -1) < 0) {
+            break;
+        }
+
+        for (size_t k = 0; k < pfds.size() && !found; ++k) {
+            if (pfds[k].revents == 0) {
+                continue;
+            }
+            auto w = ws[k];
+            if (receive(w)) {
+                dispatch(w);
+            } else {
+                drop(w);
+                for (size_t v = 0; v < peers.size(); ++v) {
+                    dispatch(v);
+                }
+            }
+        }
+    }
+
+    for (auto const &peer : peers) {
+        if (peer.alive) {
+            send_msg(peer.fd, Message(MSG_STOP));
+        }
+    }
+
+    // If every worker is lost, finish the remaining cubes here
+    if (!found && !pending.empty()) {
+        Glucose::Solver solver;
+        encoder.cnf.load(solver);
+        for (auto i : pending) {
+            Glucose::vec<Lit> assumps;
+            for (auto lit : cubes[i]) {
+                assumps.push(to_lit(lit));
+            }
+            auto conflicts = solver.conflicts;
+            auto start = clock::now();
+            auto sat = solver.solve(assumps);
+            std::chrono::duration<double> elapsed = clock::now() - start;
+
+            auto &result = results[i];
+            result.worker = peers.size();
+            result.conflicts = solver.conflicts - conflicts;
+            result.seconds = elapsed.count();
+            if (sat) {
+                result.status = CubeStat::SAT;
+                point = encoder.model(solver);
+                found = true;
+                break;
+            }
+            result.status = CubeStat::UNSAT;
+        }
+    }
+
+    if (stats) {
+        *stats = std::move(results);
+    }
+
+    if (found) {
+        return make_pair(true, std::move(point));
+    } else {
+        return make_pair(false, boost::none);
+    }
+}
+
+soln_t remote_sat(bx_t const &self, vector<string> const &addresses,
+                  SatOptions const &options, vector<CubeStat> *stats) {
+    vector<int> fds;
+    for (auto const &address : addresses) {
+        for (int i = 0; i < CONNECT_TRIES; ++i) {
+            int fd = open_socket(address, false);
+            if (fd >= 0) {
+                fds.push_back(fd);
+                break;
+            }
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(CONNECT_WAIT_MS));
+        }
+    }
+
+    auto soln = remote_sat(self, fds, options, stats);
+
+    for (auto fd : fds) {
+        close(fd);
+    }
+
+    return soln;
+}
+
+#else
+
+bool serve_cubes(int) { return false; }
+
+bool serve_cubes(string const &) { return false; }
+
+// Without sockets, every cube runs locally
+soln_t remote_sat(bx_t const &self, vector<int> const &,
+                  SatOptions const &options, vector<CubeStat> *stats) {
+    auto local = options;
+    local.nthreads = 1;
+    auto soln = cube_and_conquer(self, local, stats);
+    return make_pair(soln.first == SatStatus::SAT, std::move(soln.second));
+}
+
+soln_t remote_sat(bx_t const &self, vector<string> const &,
+                  SatOptions const &options, vector<CubeStat> *stats) {
+    return remote_sat(self, vector<int>(), options, stats);
+}
+
+#endif  // _WIN32
+
+}  // namespace boolexpr
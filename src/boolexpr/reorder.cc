@@ -0,0 +1,453 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // fill, max, min, sort, stable_sort, swap
+#include <cassert>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "boolexpr/boolexpr.h"
+#include "bdd.h"
+
+using std::unordered_map;
+using std::unordered_set;
+using std::vector;
+
+namespace boolexpr {
+
+// Give up on a direction when the BDDs grow past this factor of the best
+static double const MAX_GROWTH = 1.2;
+
+// Group sifting stops after this many passes
+static size_t const MAX_PASSES = 8;
+
+// Exchange the variables at levels l and l + 1.
+// Nodes keep their indices and functions, so handles stay valid.
+void BddManager::swap_levels(uint32_t l) {
+    auto x = level2var[l];
+    auto y = level2var[l + 1];
+
+    vector<uint32_t> nodes;
+    for (auto &head : subtables[x].buckets) {
+        for (auto i = head.load(std::memory_order_relaxed); i;
+             i = table[i].next) {
+            nodes.push_back(i);
+        }
+        head.store(0, std::memory_order_relaxed);
+    }
+    subtables[x].keys = 0;
+
+    level2var[l] = y;
+    level2var[l + 1] = x;
+    var2level[x] = l + 1;
+    var2level[y] = l;
+
+    // Nodes that do not depend on y stay as they are
+    auto on_y = [this, y](uint32_t e) {
+        return (e >> 1) && table[e >> 1].var == y;
+    };
+    vector<uint32_t> moved;
+    for (auto i : nodes) {
+        if (on_y(table[i].lo) || on_y(table[i].hi)) {
+            moved.push_back(i);
+        } else {
+            link(i);
+        }
+    }
+
+    // f = ite(x, ite(y, f11, f10), ite(y, f01, f00))
+    //   = ite(y, ite(x, f11, f01), ite(x, f10, f00))
+    for (auto i : moved) {
+        auto f0 = table[i].lo;
+        auto f1 = table[i].hi;
+
+        auto lo = mk(x, cofactor(f0, y, false), cofactor(f1, y, false));
+        ref(lo);
+        // The high edge of f1 is regular, so this one is too
+        auto hi = mk(x, cofactor(f0, y, true), cofactor(f1, y, true));
+        ref(hi);
+        assert(!(hi & 1));
+
+        table[i].var = y;
+        table[i].lo = lo;
+        table[i].hi = hi;
+        link(i);
+
+        release(f0);
+        release(f1);
+    }
+}
+
+// Move the variable at one level to another, one swap at a time
+void BddManager::move_var(uint32_t from, uint32_t to) {
+    for (; from < to; ++from) {
+        swap_levels(from);
+    }
+    for (; from > to; --from) {
+        swap_levels(from - 1);
+    }
+}
+
+// Variables x and y at levels l and l + 1 are symmetric if every function
+// swaps its x=0, y=1 and x=1, y=0 cofactors, and nothing but x nodes
+// refers to y nodes.
+bool BddManager::symmetric(uint32_t l) const {
+    auto x = level2var[l];
+    auto y = level2var[l + 1];
+
+    size_t from_x = 0;
+    for (auto const &head : subtables[x].buckets) {
+        for (auto i = head.load(std::memory_order_relaxed); i;
+             i = table[i].next) {
+            auto f0 = table[i].lo;
+            auto f1 = table[i].hi;
+            if (cofactor(f0, y, true) != cofactor(f1, y, false)) {
+                return false;
+            }
+            for (auto e : {f0, f1}) {
+                if ((e >> 1) && table[e >> 1].var == y) {
+                    ++from_x;
+                }
+            }
+        }
+    }
+
+    size_t refs = 0;
+    for (auto const &head : subtables[y].buckets) {
+        for (auto i = head.load(std::memory_order_relaxed); i;
+             i = table[i].next) {
+            refs += table[i].refs;
+        }
+    }
+
+    return from_x > 0 && refs == from_x;
+}
+
+vector<uint32_t> BddManager::blocks(bool merge_symmetric) const {
+    vector<uint32_t> sizes;
+    for (uint32_t l = 0; l < level2var.size(); ++l) {
+        auto g = var2group[level2var[l]];
+        bool joined = false;
+        if (l > 0) {
+            auto prev = var2group[level2var[l - 1]];
+            joined = (g != NO_GROUP && g == prev) ||
+                     (merge_symmetric && symmetric(l - 1));
+        }
+        if (joined) {
+            ++sizes.back();
+        } else {
+            sizes.push_back(1);
+        }
+    }
+    return sizes;
+}
+
+// Exchange blocks j and j + 1, moving each variable of the lower block up
+void BddManager::swap_blocks(vector<uint32_t> &sizes, size_t j) {
+    uint32_t start = 0;
+    for (size_t k = 0; k < j; ++k) {
+        start += sizes[k];
+    }
+    auto n = sizes[j];
+    auto m = sizes[j + 1];
+    for (uint32_t t = 0; t < m; ++t) {
+        for (auto l = start + n + t; l > start + t; --l) {
+            swap_levels(l - 1);
+        }
+    }
+    std::swap(sizes[j], sizes[j + 1]);
+}
+
+// Rudell's sifting, one block at a time, from the most nodes to the fewest.
+// Each block tries every position, nearer end first, and keeps the best.
+void BddManager::sift(vector<uint32_t> &sizes) {
+    auto nblocks = sizes.size();
+
+    // Blocks are known by their top variable
+    vector<uint32_t> tops;
+    vector<size_t> counts;
+    uint32_t level = 0;
+    for (auto size : sizes) {
+        tops.push_back(level2var[level]);
+        size_t count = 0;
+        for (uint32_t k = 0; k < size; ++k) {
+            count += subtables[level2var[level + k]].keys;
+        }
+        counts.push_back(count);
+        level += size;
+    }
+    vector<size_t> order(nblocks);
+    for (size_t k = 0; k < nblocks; ++k) {
+        order[k] = k;
+    }
+    std::stable_sort(order.begin(), order.end(), [&counts](size_t a, size_t b) {
+        return counts[a] > counts[b];
+    });
+
+    for (auto k : order) {
+        size_t j = 0;
+        for (uint32_t l = 0; level2var[l] != tops[k]; l += sizes[j++]) {
+        }
+
+        auto best = nlive;
+        auto best_j = j;
+        auto down = [&]() {
+            while (j + 1 < nblocks) {
+                swap_blocks(sizes, j++);
+                if (nlive < best) {
+                    best = nlive;
+                    best_j = j;
+                } else if (nlive > MAX_GROWTH * best) {
+                    break;
+                }
+            }
+        };
+        auto up = [&]() {
+            while (j > 0) {
+                swap_blocks(sizes, --j);
+                if (nlive < best) {
+                    best = nlive;
+                    best_j = j;
+                } else if (nlive > MAX_GROWTH * best) {
+                    break;
+                }
+            }
+        };
+
+        if (2 * j >= nblocks) {
+            down();
+            up();
+        } else {
+            up();
+            down();
+        }
+
+        while (j < best_j) {
+            swap_blocks(sizes, j++);
+        }
+        while (j > best_j) {
+            swap_blocks(sizes, --j);
+        }
+    }
+}
+
+void BddManager::reorder(BddReorder method) {
+    gc();
+
+    if (method == BddReorder::SIFT) {
+        auto sizes = blocks(false);
+        sift(sizes);
+    } else if (method == BddReorder::GROUP_SIFT) {
+        for (size_t pass = 0; pass < MAX_PASSES; ++pass) {
+            auto before = nlive;
+            auto sizes = blocks(true);
+            sift(sizes);
+            if (nlive >= before) {
+                break;
+            }
+        }
+    }
+
+    // Entries may name freed nodes
+    clear_cache();
+}
+
+void BddManager::set_auto_reorder(BddReorder method) { auto_reorder = method; }
+
+void BddManager::group(vector<var_t> const &xs) {
+    if (xs.empty()) {
+        return;
+    }
+    gc();
+
+    vector<uint32_t> vs;
+    for (auto const &x : xs) {
+        vs.push_back(index(x));
+    }
+    std::sort(vs.begin(), vs.end(), [this](uint32_t a, uint32_t b) {
+        return var2level[a] < var2level[b];
+    });
+
+    auto top = var2level[vs[0]];
+    for (uint32_t k = 0; k < vs.size(); ++k) {
+        move_var(var2level[vs[k]], top + k);
+        var2group[vs[k]] = ngroups;
+    }
+    ++ngroups;
+
+    clear_cache();
+}
+
+void BddManager::set_order(vector<var_t> const &xs) {
+    gc();
+
+    for (uint32_t k = 0; k < xs.size(); ++k) {
+        auto v = index(xs[k]);
+        assert(var2level[v] >= k);
+        move_var(var2level[v], k);
+    }
+    std::fill(var2group.begin(), var2group.end(), NO_GROUP);
+
+    clear_cache();
+}
+
+vector<var_t> dfs_order(vector<bx_t> const &bxs) {
+    vector<var_t> order;
+    unordered_set<var_t> seen;
+    for (auto const &bx : bxs) {
+        // Post-order reaches the leaves in depth-first order
+        for (auto it = dfs_iter(bx); it != dfs_iter(); ++it) {
+            auto const &node = *it;
+            if (IS_LIT(node)) {
+                auto x = std::static_pointer_cast<Variable const>(
+                    abs(std::static_pointer_cast<Literal const>(node)));
+                if (seen.insert(x).second) {
+                    order.push_back(x);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+vector<var_t> force_order(vector<bx_t> const &bxs, uint32_t rounds) {
+    // Cells are variables and operators.
+    // A literal is the cell of its variable, and constants have none.
+    vector<var_t> cell2var;
+    unordered_map<BoolExpr const *, size_t> cells;
+    unordered_map<var_t, size_t> var2cell;
+    vector<vector<size_t>> edges;
+
+    for (auto const &bx : bxs) {
+        for (auto it = dfs_iter(bx); it != dfs_iter(); ++it) {
+            auto const &node = *it;
+            if (cells.find(node.get()) != cells.end()) {
+                continue;
+            }
+            if (IS_LIT(node)) {
+                auto x = std::static_pointer_cast<Variable const>(
+                    abs(std::static_pointer_cast<Literal const>(node)));
+                auto search = var2cell.find(x);
+                if (search == var2cell.end()) {
+                    search = var2cell.insert({x, cell2var.size()}).first;
+                    cell2var.push_back(x);
+                }
+                cells.insert({node.get(), search->second});
+            } else if (IS_OP(node)) {
+                auto cell = cell2var.size();
+                cell2var.push_back(nullptr);
+                cells.insert({node.get(), cell});
+
+                auto op = std::static_pointer_cast<Operator const>(node);
+                vector<size_t> edge = {cell};
+                for (auto const &arg : op->args) {
+                    auto search = cells.find(arg.get());
+                    if (search != cells.end()) {
+                        edge.push_back(search->second);
+                    }
+                }
+                edges.push_back(std::move(edge));
+            }
+        }
+    }
+
+    auto ncells = cell2var.size();
+    vector<vector<size_t>> cell2edges(ncells);
+    for (size_t e = 0; e < edges.size(); ++e) {
+        for (auto c : edges[e]) {
+            cell2edges[c].push_back(e);
+        }
+    }
+
+    // Start from the depth-first placement
+    vector<double> pos(ncells);
+    for (size_t c = 0; c < ncells; ++c) {
+        pos[c] = c;
+    }
+
+    auto span = [&]() {
+        double total = 0;
+        for (auto const &edge : edges) {
+            double lo = pos[edge[0]], hi = pos[edge[0]];
+            for (auto c : edge) {
+                lo = std::min(lo, pos[c]);
+                hi = std::max(hi, pos[c]);
+            }
+            total += hi - lo;
+        }
+        return total;
+    };
+
+    auto best = pos;
+    auto best_span = span();
+
+    vector<double> cog(edges.size());
+    vector<size_t> rank(ncells);
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (size_t e = 0; e < edges.size(); ++e) {
+            double sum = 0;
+            for (auto c : edges[e]) {
+                sum += pos[c];
+            }
+            cog[e] = sum / edges[e].size();
+        }
+        vector<double> target(ncells);
+        for (size_t c = 0; c < ncells; ++c) {
+            if (cell2edges[c].empty()) {
+                target[c] = pos[c];
+            } else {
+                double sum = 0;
+                for (auto e : cell2edges[c]) {
+                    sum += cog[e];
+                }
+                target[c] = sum / cell2edges[c].size();
+            }
+        }
+
+        // Spread the cells back out to one per position
+        for (size_t c = 0; c < ncells; ++c) {
+            rank[c] = c;
+        }
+        std::stable_sort(rank.begin(), rank.end(),
+                         [&target](size_t a, size_t b) {
+                             return target[a] < target[b];
+                         });
+        for (size_t k = 0; k < ncells; ++k) {
+            pos[rank[k]] = k;
+        }
+
+        auto s = span();
+        if (s >= best_span) {
+            break;
+        }
+        best = pos;
+        best_span = s;
+    }
+
+    vector<size_t> vcells;
+    for (size_t c = 0; c < ncells; ++c) {
+        if (cell2var[c]) {
+            vcells.push_back(c);
+        }
+    }
+    std::sort(vcells.begin(), vcells.end(),
+              [&best](size_t a, size_t b) { return best[a] < best[b]; });
+
+    vector<var_t> order;
+    for (auto c : vcells) {
+        order.push_back(cell2var[c]);
+    }
+    return order;
+}
+
+}  // namespace boolexpr
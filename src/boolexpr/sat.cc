@@ -12,66 +12,174 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdlib>  // abs
+
 #include "boolexpr/boolexpr.h"
+#include "simulate.h"
 
 using std::make_pair;
 using std::static_pointer_cast;
-using std::unordered_map;
+using std::unordered_set;
+using std::vector;
 
 using Glucose::Lit;
-using Glucose::lbool;  // l_False, l_True
+using Glucose::lbool;  // l_False, l_True, l_Undef
 using Glucose::mkLit;
 
 namespace boolexpr {
 
-static void encode_cmsat(std::unordered_map<uint32_t, var_t> &idx2var,
-                         Glucose::Solver &solver, bx_t bx) {
-    auto xs = bx->support();
-    unordered_map<lit_t, uint32_t> lit2idx;
+static Lit to_lit(int32_t x) { return mkLit(std::abs(x) - 1, x < 0); }
+
+soln_t BoolExpr::sat() const { return simplify()->_sat(); }
+
+soln_t BoolExpr::sat(SatOptions const &options) const {
+    auto unlimited = options;
+    unlimited.conflict_limit = -1;
+    unlimited.propagation_limit = -1;
+    unlimited.time_limit = 0.0;
+    unlimited.interrupt = nullptr;
 
-    uint32_t index = 0;
-    for (var_t const &x : xs) {
-        auto xn_lit = static_pointer_cast<Literal const>(~x);
-        auto x_lit = static_pointer_cast<Literal const>(x);
-        lit2idx.insert({xn_lit, (index << 1) | 0u});
-        lit2idx.insert({x_lit, (index << 1) | 1u});
-        idx2var.insert({index, x});
-        ++index;
+    auto soln = sat_limited(unlimited);
+    return make_pair(soln.first == SatStatus::SAT, std::move(soln.second));
+}
+
+limited_soln_t BoolExpr::sat_limited(SatOptions const &options) const {
+    if (options.cube_depth > 0) {
+        return cube_and_conquer(shared_from_this(), options);
     }
 
-    for (size_t i = 0; i < xs.size(); ++i) solver.newVar();
+    auto f = simplify();
 
-    if (IS_OR(bx)) {
-        Glucose::vec<Lit> clause;
-        auto or_op = static_pointer_cast<Or const>(bx);
-        for (bx_t const &arg : or_op->args) {
-            auto lit = static_pointer_cast<Literal const>(arg);
-            auto index = lit2idx.find(lit)->second;
-            clause.push_back(mkLit(index >> 1, !(index & 1u)));
+    if (!IS_OP(f)) {
+        auto soln = f->_sat();
+        if (soln.first) {
+            return make_pair(SatStatus::SAT, std::move(soln.second));
+        } else {
+            return make_pair(SatStatus::UNSAT, boost::none);
         }
-        solver.addClause(std::move(clause));
+    }
+
+    // Random simulation is much cheaper than encoding
+    if (auto point = sim_sat(f)) {
+        return make_pair(SatStatus::SAT, std::move(point));
+    }
+
+    CnfEncoder encoder;
+    encoder.add(f);
+
+    Portfolio solver(options.nthreads);
+    solver.load(encoder.cnf);
+
+    auto r = solver.solve_limited(Glucose::vec<Lit>(), options);
+    if (r == l_True) {
+        return make_pair(SatStatus::SAT, encoder.model(solver.winner()));
+    } else if (r == l_False) {
+        return make_pair(SatStatus::UNSAT, boost::none);
     } else {
-        auto and_op = static_pointer_cast<And const>(bx);
-        for (bx_t const &arg : and_op->args) {
-            Glucose::vec<Lit> clause;
-            if (IS_OR(arg)) {
-                auto or_op = static_pointer_cast<Or const>(arg);
-                for (bx_t const &_arg : or_op->args) {
-                    auto lit = static_pointer_cast<Literal const>(_arg);
-                    auto index = lit2idx.find(lit)->second;
-                    clause.push_back(mkLit(index >> 1, !(index & 1u)));
-                }
-            } else {
-                auto lit = static_pointer_cast<Literal const>(arg);
-                auto index = lit2idx.find(lit)->second;
-                clause.push_back(mkLit(index >> 1, !(index & 1u)));
-            }
-            solver.addClause(std::move(clause));
+        return make_pair(SatStatus::UNKNOWN, boost::none);
+    }
+}
+
+soln_t BoolExpr::sat(point_t const &point) const {
+    return AssumptionCache(shared_from_this()).sat(point);
+}
+
+AssumptionCache::AssumptionCache(bx_t const &bx) : f{bx->simplify()} {
+    reset();
+}
+
+void AssumptionCache::reset() {
+    encoder = CnfEncoder();
+    solver.reset(new Glucose::Solver());
+    loaded = 0;
+    others.clear();
+
+    root = 0;
+    nvars = 0;
+    if (IS_OP(f)) {
+        root = encoder.encode(f);
+        nvars = encoder.cnf.nvars;
+    }
+}
+
+void AssumptionCache::assume(point_t const &point,
+                             Glucose::vec<Lit> &assumps) {
+    for (auto const &pair : point) {
+        auto v = encoder.encode(pair.first);
+        assumps.push(mkLit(v - 1, IS_ZERO(pair.second)));
+    }
+}
+
+bool AssumptionCache::solve(Glucose::vec<Lit> const &assumps) {
+    // Assumptions might have introduced new variables
+    encoder.cnf.load(*solver, loaded);
+    loaded = encoder.cnf.nclauses();
+    return solver->solve(assumps);
+}
+
+// Unknown values have no assumption literal
+static bool is_known(point_t const &point) {
+    for (auto const &pair : point) {
+        if (!IS_KNOWN(pair.second)) {
+            return false;
         }
     }
+    return true;
 }
 
-soln_t BoolExpr::sat() const { return simplify()->_sat(); }
+soln_t AssumptionCache::sat(point_t const &point) {
+    if (!IS_OP(f) || !is_known(point)) {
+        return f->restrict_(point)->sat();
+    }
+
+    Glucose::vec<Lit> assumps;
+    assumps.push(to_lit(root));
+    assume(point, assumps);
+
+    if (solve(assumps)) {
+        auto point_ = encoder.model(*solver, nvars);
+        for (auto const &pair : point) {
+            point_.erase(pair.first);
+        }
+        return make_pair(true, point_);
+    } else {
+        return make_pair(false, boost::none);
+    }
+}
+
+bool AssumptionCache::equiv(bx_t const &other, point_t const &point) {
+    auto g = other->simplify();
+
+    // Unknown constants have no CNF encoding
+    if (!IS_OP(f) || IS_UNKNOWN(g) || !is_known(point)) {
+        return !(f ^ g)->restrict_(point)->sat().first;
+    }
+
+    int32_t y;
+    auto search = others.find(g);
+    if (search != others.end()) {
+        y = search->second;
+    } else {
+        if (others.size() == MAX_OTHERS) {
+            reset();
+        }
+        y = encoder.encode(g);
+        others.insert({g, y});
+    }
+
+    // f != g <=> (f & ~g) | (~f & g)
+    for (int32_t sign : {1, -1}) {
+        Glucose::vec<Lit> assumps;
+        assumps.push(to_lit(sign * root));
+        assumps.push(to_lit(-sign * y));
+        assume(point, assumps);
+        if (solve(assumps)) {
+            return false;
+        }
+    }
+
+    return true;
+}
 
 soln_t Zero::_sat() const { return make_pair(false, boost::none); }
 
@@ -94,28 +202,19 @@ soln_t Variable::_sat() const {
 }
 
 soln_t Operator::_sat() const {
-    std::unordered_map<uint32_t, var_t> idx2var;
-    Glucose::Solver solver;
+    // Random simulation is much cheaper than encoding
+    if (auto point = sim_sat(shared_from_this())) {
+        return make_pair(true, std::move(point));
+    }
 
-    auto ctx = Context();
-    auto cnf = tseytin(ctx);
-    encode_cmsat(idx2var, solver, cnf);
+    CnfEncoder encoder;
+    encoder.add(shared_from_this());
 
-    auto sat = solver.solve();
+    Glucose::Solver solver;
+    encoder.cnf.load(solver);
 
-    if (sat) {
-        point_t point;
-        for (size_t i = 0; i < solver.nVars(); ++i) {
-            auto x = idx2var.find(i)->second;
-            if (x->ctx != &ctx) {
-                if (solver.modelValue(i) == l_False) {
-                    point.insert({x, zero()});
-                } else if (solver.modelValue(i) == l_True) {
-                    point.insert({x, one()});
-                }
-            }
-        }
-        return make_pair(true, std::move(point));
+    if (solver.solve()) {
+        return make_pair(true, encoder.model(solver));
     } else {
         return make_pair(false, boost::none);
     }
@@ -152,14 +251,51 @@ void Variable::sat_iter_init(sat_iter *it) const {
 
 void Operator::sat_iter_init(sat_iter *it) const {
     it->one_soln = false;
-    auto cnf = tseytin(it->ctx);
-    encode_cmsat(it->idx2var, it->solver, cnf);
+    it->encoder.add(shared_from_this());
+    it->encoder.cnf.load(it->solver);
     it->get_soln();
 }
 
-sat_iter::sat_iter() : sat{false} {}
+sat_iter::sat_iter() : sat{false}, project{false} {}
 
-sat_iter::sat_iter(bx_t const &bx) { bx->sat_iter_init(this); }
+sat_iter::sat_iter(bx_t const &bx) : project{false} {
+    bx->sat_iter_init(this);
+}
+
+sat_iter::sat_iter(bx_t const &bx, vector<var_t> const &vars)
+    : one_soln{false}, project{true} {
+    auto f = bx->simplify();
+
+    // Unknown constants have no CNF encoding
+    if (IS_UNKNOWN(f)) {
+        sat = false;
+        return;
+    }
+
+    root = encoder.encode(f);
+
+    // Auxiliary variables, such as those of a cardinality constraint,
+    // are fixed with the other inputs. Left free, the lifter would need f
+    // to hold for every value of them, and fewer cubes would shrink.
+    unordered_set<var_t> projection(vars.begin(), vars.end());
+    for (uint32_t v = 1; v <= encoder.cnf.nvars; ++v) {
+        auto const &x = encoder.idx2var[v];
+        if (x) {
+            if (!x->ctx->is_anon(x->id) &&
+                projection.find(x) != projection.end()) {
+                proj.push_back(v);
+            } else {
+                fixed.push_back(v);
+            }
+        }
+    }
+
+    encoder.cnf.load(lifter);
+    encoder.cnf.load(solver);
+    solver.addClause(to_lit(root));
+
+    get_cube();
+}
 
 void sat_iter::get_soln() {
     point.clear();
@@ -167,20 +303,64 @@ void sat_iter::get_soln() {
     sat = solver.solve();
 
     if (sat) {
+        point = encoder.model(solver);
+
+        // Block this solution
         Glucose::vec<Lit> clause;
-        for (size_t i = 0; i < solver.nVars(); ++i) {
-            auto x = idx2var.find(i)->second;
-            if (x->ctx != &ctx) {
-                if (solver.modelValue(i) == l_False) {
-                    point.insert({x, zero()});
-                    clause.push_back(mkLit(i, false));
-                } else if (solver.modelValue(i) == l_True) {
-                    point.insert({x, one()});
-                    clause.push_back(mkLit(i, true));
+        for (auto const &pair : point) {
+            auto v = encoder.encode(pair.first);
+            clause.push(mkLit(v - 1, IS_ONE(pair.second)));
+        }
+        solver.addClause(clause);
+    }
+}
+
+void sat_iter::get_cube() {
+    point.clear();
+
+    sat = solver.solve();
+
+    if (sat) {
+        // The lifter refutes ~f under the fixed inputs and the cube
+        vector<Lit> prefix{to_lit(-root)};
+        for (int32_t v : fixed) {
+            prefix.push_back(mkLit(v - 1, solver.modelValue(v - 1) == l_False));
+        }
+        vector<Lit> cube;
+        for (int32_t v : proj) {
+            cube.push_back(mkLit(v - 1, solver.modelValue(v - 1) == l_False));
+        }
+
+        // Drop one literal at a time, while ~f remains unsatisfiable
+        Glucose::vec<Lit> assumps;
+        for (size_t i = 0; i < cube.size();) {
+            assumps.clear();
+            for (Lit const &lit : prefix) {
+                assumps.push(lit);
+            }
+            for (size_t j = 0; j < cube.size(); ++j) {
+                if (j != i) {
+                    assumps.push(cube[j]);
                 }
             }
+            if (lifter.solve(assumps)) {
+                ++i;
+            } else {
+                cube.erase(cube.begin() + i);
+            }
+        }
+
+        // Block this cube
+        Glucose::vec<Lit> clause;
+        for (Lit const &lit : cube) {
+            auto const &x = encoder.idx2var[var(lit) + 1];
+            if (sign(lit)) {
+                point.insert({x, zero()});
+            } else {
+                point.insert({x, one()});
+            }
+            clause.push(~lit);
         }
-        // Block this solution
         solver.addClause(clause);
     }
 }
@@ -195,6 +375,8 @@ sat_iter const &sat_iter::operator++() {
     if (one_soln) {
         sat = false;
         point.clear();
+    } else if (project) {
+        get_cube();
     } else {
         get_soln();
     }
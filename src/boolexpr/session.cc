@@ -0,0 +1,58 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <cstdlib>  // abs
+
+#include "boolexpr/boolexpr.h"
+
+using std::make_pair;
+using std::vector;
+
+using Glucose::Lit;
+using Glucose::mkLit;
+
+namespace boolexpr {
+
+SatSession::SatSession(SatOptions const &options)
+    : solver(options.nthreads), loaded{0} {}
+
+void SatSession::load() {
+    solver.load(encoder.cnf, loaded);
+    loaded = encoder.cnf.nclauses();
+}
+
+void SatSession::add(bx_t const &bx) {
+    encoder.add(bx->simplify());
+    load();
+}
+
+soln_t SatSession::solve() { return solve(vector<lit_t>{}); }
+
+soln_t SatSession::solve(vector<lit_t> const &assumptions) {
+    Glucose::vec<Lit> assumps;
+    for (lit_t const &lit : assumptions) {
+        auto x = encoder.encode(lit);
+        assumps.push(mkLit(std::abs(x) - 1, x < 0));
+    }
+
+    // Assumptions might have introduced new variables
+    load();
+
+    if (solver.solve(assumps)) {
+        return make_pair(true, encoder.model(solver.winner()));
+    } else {
+        return make_pair(false, boost::none);
+    }
+}
+
+}  // namespace boolexpr
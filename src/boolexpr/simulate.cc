@@ -0,0 +1,277 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // min
+#include <cassert>
+#include <unordered_map>
+
+#include "boolexpr/boolexpr.h"
+#include "simulate.h"
+
+using std::static_pointer_cast;
+using std::unordered_map;
+using std::vector;
+
+namespace boolexpr {
+
+static uint64_t const ONES = ~uint64_t(0);
+
+size_t const Simulator::WORDS;
+
+Simulator::Simulator(vector<bx_t> const &exprs) : ok{true} {
+    unordered_map<BoolExpr const *, uint32_t> index;
+    unordered_map<Variable const *, uint32_t> input;
+
+    auto input_of = [&](var_t const &x) {
+        auto it = input.find(x.get());
+        if (it != input.end()) {
+            return it->second;
+        }
+        uint32_t i = vars.size();
+        input.insert({x.get(), i});
+        vars.push_back(x);
+        return i;
+    };
+
+    for (auto const &expr : exprs) {
+        // Post-order visits arguments before their operators
+        for (auto it = dfs_iter(expr); it != dfs_iter(); ++it) {
+            auto const &bx = *it;
+            if (index.find(bx.get()) != index.end()) {
+                continue;
+            }
+
+            Node node{bx->kind, 0, 0};
+            if (IS_UNKNOWN(bx)) {
+                ok = false;
+            } else if (IS_VAR(bx)) {
+                node.begin = input_of(static_pointer_cast<Variable const>(bx));
+            } else if (IS_COMP(bx)) {
+                auto x = static_pointer_cast<Variable const>(~bx);
+                node.begin = input_of(x);
+            } else if (IS_OP(bx)) {
+                auto op = static_pointer_cast<Operator const>(bx);
+                node.begin = args.size();
+                for (auto const &arg : op->args) {
+                    args.push_back(index.find(arg.get())->second);
+                }
+                node.end = args.size();
+            }
+
+            index.insert({bx.get(), nodes.size()});
+            nodes.push_back(node);
+        }
+        roots.push_back(index.find(expr.get())->second);
+    }
+
+    ins.assign(vars.size() * WORDS, 0);
+    vals.assign(nodes.size() * WORDS, 0);
+}
+
+void Simulator::randomize(std::mt19937_64 &rng) {
+    for (size_t i = 0; i < vars.size(); ++i) {
+        auto words = input(i);
+        for (size_t k = 0; k < WORDS; ++k) {
+            words[k] = rng();
+        }
+        words[0] = (words[0] & ~uint64_t(3)) | 2;
+    }
+}
+
+void Simulator::run() {
+    assert(ok);
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        auto const &node = nodes[i];
+        auto out = &vals[i * WORDS];
+
+        auto arg = [&](uint32_t j) { return &vals[args[j] * WORDS]; };
+
+        switch (node.kind) {
+            case BoolExpr::ZERO:
+                for (size_t k = 0; k < WORDS; ++k) out[k] = 0;
+                break;
+
+            case BoolExpr::ONE:
+                for (size_t k = 0; k < WORDS; ++k) out[k] = ONES;
+                break;
+
+            case BoolExpr::COMP: {
+                auto x = input(node.begin);
+                for (size_t k = 0; k < WORDS; ++k) out[k] = ~x[k];
+                break;
+            }
+
+            case BoolExpr::VAR: {
+                auto x = input(node.begin);
+                for (size_t k = 0; k < WORDS; ++k) out[k] = x[k];
+                break;
+            }
+
+            case BoolExpr::NOR:
+            case BoolExpr::OR:
+                for (size_t k = 0; k < WORDS; ++k) out[k] = 0;
+                for (auto j = node.begin; j < node.end; ++j) {
+                    auto a = arg(j);
+                    for (size_t k = 0; k < WORDS; ++k) out[k] |= a[k];
+                }
+                break;
+
+            case BoolExpr::NAND:
+            case BoolExpr::AND:
+                for (size_t k = 0; k < WORDS; ++k) out[k] = ONES;
+                for (auto j = node.begin; j < node.end; ++j) {
+                    auto a = arg(j);
+                    for (size_t k = 0; k < WORDS; ++k) out[k] &= a[k];
+                }
+                break;
+
+            case BoolExpr::XNOR:
+            case BoolExpr::XOR:
+                for (size_t k = 0; k < WORDS; ++k) out[k] = 0;
+                for (auto j = node.begin; j < node.end; ++j) {
+                    auto a = arg(j);
+                    for (size_t k = 0; k < WORDS; ++k) out[k] ^= a[k];
+                }
+                break;
+
+            case BoolExpr::NEQ:
+            case BoolExpr::EQ: {
+                // Equal where the arguments are all ones or all zeros
+                uint64_t ones[WORDS], zeros[WORDS];
+                for (size_t k = 0; k < WORDS; ++k) ones[k] = zeros[k] = ONES;
+                for (auto j = node.begin; j < node.end; ++j) {
+                    auto a = arg(j);
+                    for (size_t k = 0; k < WORDS; ++k) {
+                        ones[k] &= a[k];
+                        zeros[k] &= ~a[k];
+                    }
+                }
+                for (size_t k = 0; k < WORDS; ++k) out[k] = ones[k] | zeros[k];
+                break;
+            }
+
+            case BoolExpr::NIMPL:
+            case BoolExpr::IMPL: {
+                auto p = arg(node.begin);
+                auto q = arg(node.begin + 1);
+                for (size_t k = 0; k < WORDS; ++k) out[k] = ~p[k] | q[k];
+                break;
+            }
+
+            case BoolExpr::NITE:
+            case BoolExpr::ITE: {
+                auto s = arg(node.begin);
+                auto d1 = arg(node.begin + 1);
+                auto d0 = arg(node.begin + 2);
+                for (size_t k = 0; k < WORDS; ++k) {
+                    out[k] = (s[k] & d1[k]) | (~s[k] & d0[k]);
+                }
+                break;
+            }
+
+            default:
+                assert(false);  // LCOV_EXCL_LINE
+        }
+
+        // Negative operators have even kinds
+        if (node.kind >> 4 == 1 && !(node.kind & 1)) {
+            for (size_t k = 0; k < WORDS; ++k) out[k] = ~out[k];
+        }
+    }
+}
+
+uint64_t const *Simulator::output(size_t root) const {
+    return &vals[roots[root] * WORDS];
+}
+
+point_t Simulator::point(size_t bit) const {
+    point_t point;
+    for (size_t i = 0; i < vars.size(); ++i) {
+        // Auxiliary variables are projected away, like CnfEncoder::model
+        if (vars[i]->ctx->is_anon(vars[i]->id)) {
+            continue;
+        }
+        auto word = ins[i * WORDS + bit / 64];
+        if ((word >> (bit % 64)) & 1) {
+            point.insert({vars[i], one()});
+        } else {
+            point.insert({vars[i], zero()});
+        }
+    }
+    return point;
+}
+
+boost::optional<point_t> sim_sat(bx_t const &f) {
+    Simulator sim({f});
+    if (!sim.okay()) {
+        return boost::none;
+    }
+
+    // The default seed keeps results repeatable
+    std::mt19937_64 rng;
+    sim.randomize(rng);
+    sim.run();
+
+    auto out = sim.output(0);
+    for (size_t bit = 0; bit < 64 * Simulator::WORDS; ++bit) {
+        if ((out[bit / 64] >> (bit % 64)) & 1) {
+            return sim.point(bit);
+        }
+    }
+    return boost::none;
+}
+
+boost::optional<vector<uint64_t>> simulate(bx_t const &f,
+                                           var2words_t const &patterns) {
+    Simulator sim({f});
+    if (!sim.okay()) {
+        return boost::none;
+    }
+
+    size_t nwords = 0;
+    vector<vector<uint64_t> const *> words;
+    for (auto const &x : sim.inputs()) {
+        auto it = patterns.find(x);
+        if (it == patterns.end()) {
+            return boost::none;
+        }
+        if (!words.empty() && it->second.size() != nwords) {
+            return boost::none;
+        }
+        nwords = it->second.size();
+        words.push_back(&it->second);
+    }
+    if (words.empty()) {
+        nwords = patterns.empty() ? 0 : patterns.begin()->second.size();
+    }
+
+    vector<uint64_t> result(nwords);
+    for (size_t first = 0; first < nwords; first += Simulator::WORDS) {
+        auto n = std::min(Simulator::WORDS, nwords - first);
+        for (size_t i = 0; i < words.size(); ++i) {
+            auto in = sim.input(i);
+            for (size_t k = 0; k < n; ++k) {
+                in[k] = (*words[i])[first + k];
+            }
+        }
+        sim.run();
+        auto out = sim.output(0);
+        for (size_t k = 0; k < n; ++k) {
+            result[first + k] = out[k];
+        }
+    }
+    return result;
+}
+
+}  // namespace boolexpr
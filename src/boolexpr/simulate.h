@@ -0,0 +1,86 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// WARNING:
+//     The contents of this file are implementation details.
+//     Do not use these declarations for anything,
+//     because they may change without notice.
+
+#ifndef BOOLEXPR_SIMULATE_H_
+#define BOOLEXPR_SIMULATE_H_
+
+#include <random>
+
+#include "boolexpr/boolexpr.h"
+
+namespace boolexpr {
+
+// Bit-parallel simulator over the DAG of one or more expressions.
+// Each pass evaluates every node on WORDS * 64 input patterns,
+// with one word-wide bitwise operation per argument and word.
+class Simulator {
+public:
+    static size_t const WORDS = 4;
+
+    struct Node {
+        BoolExpr::Kind kind;
+        // Argument indices, or the input index of a literal
+        uint32_t begin, end;
+    };
+
+    explicit Simulator(std::vector<bx_t> const &roots);
+
+    // Return false if the DAG contains an unknown constant
+    bool okay() const { return ok; }
+
+    // Variables in input order
+    std::vector<var_t> const &inputs() const { return vars; }
+
+    // Words of an input, to be set before each pass
+    uint64_t *input(size_t i) { return &ins[i * WORDS]; }
+
+    // Fill every input with random patterns.
+    // The first pattern is all zeros, and the second is all ones.
+    void randomize(std::mt19937_64 &);
+
+    void run();
+
+    // Words of a root after a pass
+    uint64_t const *output(size_t root) const;
+
+    // Return the input point of one pattern, without anonymous variables
+    point_t point(size_t bit) const;
+
+    // Nodes in post-order, and their flattened argument indices
+    std::vector<Node> const &program() const { return nodes; }
+    std::vector<uint32_t> const &arguments() const { return args; }
+
+private:
+    bool ok;
+    std::vector<var_t> vars;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> args;
+    std::vector<uint32_t> roots;
+
+    std::vector<uint64_t> ins;
+    std::vector<uint64_t> vals;
+};
+
+// Return a point that satisfies an expression,
+// if a pass of random simulation finds one.
+boost::optional<point_t> sim_sat(bx_t const &);
+
+}  // namespace boolexpr
+
+#endif  // BOOLEXPR_SIMULATE_H_
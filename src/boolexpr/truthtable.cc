@@ -0,0 +1,453 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // min, swap
+#include <bitset>
+#include <cassert>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "boolexpr/boolexpr.h"
+#include "simulate.h"
+#include "truthtable.h"
+
+using std::static_pointer_cast;
+using std::unordered_map;
+using std::unordered_set;
+using std::vector;
+
+namespace boolexpr {
+
+static uint64_t const ONES = ~uint64_t(0);
+
+// Minterms where variable i < 6 is one, within a word
+static uint64_t const MASKS[6] = {
+    0xAAAAAAAAAAAAAAAAu, 0xCCCCCCCCCCCCCCCCu, 0xF0F0F0F0F0F0F0F0u,
+    0xFF00FF00FF00FF00u, 0xFFFF0000FFFF0000u, 0xFFFFFFFF00000000u,
+};
+
+static size_t nwords(uint32_t n) { return n <= 6 ? 1 : size_t(1) << (n - 6); }
+
+// Word k of the projection function of variable i
+static uint64_t var_word(uint32_t i, size_t k) {
+    if (i < 6) {
+        return MASKS[i];
+    }
+    return ((k >> (i - 6)) & 1) ? ONES : 0;
+}
+
+uint32_t const TruthTable::MAX_VARS;
+
+TruthTable::TruthTable(uint32_t n, bool val)
+    : n{n}, w(nwords(n), val ? ONES : 0) {
+    assert(n <= MAX_VARS);
+}
+
+TruthTable::TruthTable(bx_t const &f, vector<var_t> const &vars)
+    : n(vars.size()), w(nwords(vars.size())) {
+    assert(n <= MAX_VARS);
+
+    Simulator sim({f});
+    assert(sim.okay());
+
+    unordered_map<var_t, uint32_t> index;
+    for (uint32_t i = 0; i < n; ++i) {
+        index.insert({vars[i], i});
+    }
+
+    vector<uint32_t> inputs;
+    for (auto const &x : sim.inputs()) {
+        auto it = index.find(x);
+        assert(it != index.end());
+        inputs.push_back(it->second);
+    }
+
+    // Each pass simulates the next few words of minterms
+    for (size_t first = 0; first < w.size(); first += Simulator::WORDS) {
+        for (size_t j = 0; j < inputs.size(); ++j) {
+            auto words = sim.input(j);
+            for (size_t k = 0; k < Simulator::WORDS; ++k) {
+                words[k] = var_word(inputs[j], first + k);
+            }
+        }
+        sim.run();
+        auto out = sim.output(0);
+        auto count = std::min(Simulator::WORDS, w.size() - first);
+        for (size_t k = 0; k < count; ++k) {
+            w[first + k] = out[k];
+        }
+    }
+}
+
+TruthTable TruthTable::var(uint32_t n, uint32_t i) {
+    assert(i < n);
+    TruthTable tt(n);
+    for (size_t k = 0; k < tt.w.size(); ++k) {
+        tt.w[k] = var_word(i, k);
+    }
+    return tt;
+}
+
+bool TruthTable::get(uint64_t minterm) const {
+    return (w[minterm / 64] >> (minterm % 64)) & 1;
+}
+
+void TruthTable::set(uint64_t minterm, bool val) {
+    // A small table keeps every copy of a minterm in step
+    auto step = n < 6 ? uint64_t(1) << n : 64 * w.size();
+    for (auto m = minterm; m < 64 * w.size(); m += step) {
+        auto bit = uint64_t(1) << (m % 64);
+        if (val) {
+            w[m / 64] |= bit;
+        } else {
+            w[m / 64] &= ~bit;
+        }
+    }
+}
+
+bool TruthTable::is_zero() const {
+    for (auto word : w) {
+        if (word != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TruthTable::is_one() const {
+    for (auto word : w) {
+        if (word != ONES) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t TruthTable::count() const {
+    if (n < 6) {
+        auto mask = (uint64_t(1) << (1 << n)) - 1;
+        return std::bitset<64>(w[0] & mask).count();
+    }
+    uint64_t total = 0;
+    for (auto word : w) {
+        total += std::bitset<64>(word).count();
+    }
+    return total;
+}
+
+TruthTable TruthTable::operator~() const {
+    TruthTable tt(n);
+    for (size_t k = 0; k < w.size(); ++k) {
+        tt.w[k] = ~w[k];
+    }
+    return tt;
+}
+
+TruthTable &TruthTable::operator&=(TruthTable const &other) {
+    assert(n == other.n);
+    for (size_t k = 0; k < w.size(); ++k) {
+        w[k] &= other.w[k];
+    }
+    return *this;
+}
+
+TruthTable &TruthTable::operator|=(TruthTable const &other) {
+    assert(n == other.n);
+    for (size_t k = 0; k < w.size(); ++k) {
+        w[k] |= other.w[k];
+    }
+    return *this;
+}
+
+TruthTable &TruthTable::operator^=(TruthTable const &other) {
+    assert(n == other.n);
+    for (size_t k = 0; k < w.size(); ++k) {
+        w[k] ^= other.w[k];
+    }
+    return *this;
+}
+
+TruthTable TruthTable::operator&(TruthTable const &other) const {
+    auto tt = *this;
+    return tt &= other;
+}
+
+TruthTable TruthTable::operator|(TruthTable const &other) const {
+    auto tt = *this;
+    return tt |= other;
+}
+
+TruthTable TruthTable::operator^(TruthTable const &other) const {
+    auto tt = *this;
+    return tt ^= other;
+}
+
+bool TruthTable::operator==(TruthTable const &other) const {
+    return n == other.n && w == other.w;
+}
+
+bool TruthTable::operator!=(TruthTable const &other) const {
+    return !(*this == other);
+}
+
+bool TruthTable::operator<(TruthTable const &other) const {
+    if (n != other.n) {
+        return n < other.n;
+    }
+    return w < other.w;
+}
+
+TruthTable TruthTable::cofactor(uint32_t i, bool val) const {
+    assert(i < n);
+    TruthTable tt(n);
+
+    if (i < 6) {
+        // Copy the chosen half of each pair of bit groups over the other
+        auto mask = MASKS[i];
+        auto shift = 1u << i;
+        for (size_t k = 0; k < w.size(); ++k) {
+            if (val) {
+                auto hi = w[k] & mask;
+                tt.w[k] = hi | (hi >> shift);
+            } else {
+                auto lo = w[k] & ~mask;
+                tt.w[k] = lo | (lo << shift);
+            }
+        }
+    } else {
+        // Copy the chosen half of each pair of word blocks over the other
+        size_t step = size_t(1) << (i - 6);
+        for (size_t k = 0; k < w.size(); k += 2 * step) {
+            for (size_t j = 0; j < step; ++j) {
+                auto word = val ? w[k + step + j] : w[k + j];
+                tt.w[k + j] = word;
+                tt.w[k + step + j] = word;
+            }
+        }
+    }
+
+    return tt;
+}
+
+TruthTable TruthTable::exists(uint32_t i) const {
+    return cofactor(i, false) | cofactor(i, true);
+}
+
+TruthTable TruthTable::forall(uint32_t i) const {
+    return cofactor(i, false) & cofactor(i, true);
+}
+
+TruthTable TruthTable::difference(uint32_t i) const {
+    return cofactor(i, false) ^ cofactor(i, true);
+}
+
+bool TruthTable::depends_on(uint32_t i) const {
+    return cofactor(i, false) != cofactor(i, true);
+}
+
+vector<uint32_t> TruthTable::support() const {
+    vector<uint32_t> vs;
+    for (uint32_t i = 0; i < n; ++i) {
+        if (depends_on(i)) {
+            vs.push_back(i);
+        }
+    }
+    return vs;
+}
+
+uint64_t flip_word(uint64_t word, uint32_t i) {
+    auto mask = MASKS[i];
+    auto shift = 1u << i;
+    return ((word & mask) >> shift) | ((word & ~mask) << shift);
+}
+
+uint64_t swap_word(uint64_t word, uint32_t i, uint32_t j) {
+    if (i > j) {
+        std::swap(i, j);
+    }
+    // Minterms with xi=1, xj=0 trade places with xi=0, xj=1
+    auto up = MASKS[i] & ~MASKS[j];
+    auto down = ~MASKS[i] & MASKS[j];
+    auto shift = (1u << j) - (1u << i);
+    return (word & ~(up | down)) | ((word & up) << shift) |
+           ((word & down) >> shift);
+}
+
+TruthTable TruthTable::flip(uint32_t i) const {
+    assert(i < n);
+    TruthTable tt(n);
+
+    if (i < 6) {
+        for (size_t k = 0; k < w.size(); ++k) {
+            tt.w[k] = flip_word(w[k], i);
+        }
+    } else {
+        size_t step = size_t(1) << (i - 6);
+        for (size_t k = 0; k < w.size(); ++k) {
+            tt.w[k] = w[k ^ step];
+        }
+    }
+
+    return tt;
+}
+
+TruthTable TruthTable::swap(uint32_t i, uint32_t j) const {
+    assert(i < n && j < n);
+    if (i > j) {
+        std::swap(i, j);
+    }
+    if (i == j) {
+        return *this;
+    }
+
+    TruthTable tt(n);
+
+    if (j < 6) {
+        for (size_t k = 0; k < w.size(); ++k) {
+            tt.w[k] = swap_word(w[k], i, j);
+        }
+    } else if (i < 6) {
+        // Words with xj=0 trade their xi=1 bits
+        // for the xi=0 bits of their partners with xj=1.
+        auto mask = MASKS[i];
+        auto shift = 1u << i;
+        size_t step = size_t(1) << (j - 6);
+        for (size_t k = 0; k < w.size(); ++k) {
+            if (k & step) {
+                continue;
+            }
+            auto lo = w[k];
+            auto hi = w[k | step];
+            tt.w[k] = (lo & ~mask) | ((hi & ~mask) << shift);
+            tt.w[k | step] = (hi & mask) | ((lo & mask) >> shift);
+        }
+    } else {
+        // Swap two bits of the word index
+        auto bi = size_t(1) << (i - 6);
+        auto bj = size_t(1) << (j - 6);
+        for (size_t k = 0; k < w.size(); ++k) {
+            auto other = k & ~(bi | bj);
+            if (k & bi) {
+                other |= bj;
+            }
+            if (k & bj) {
+                other |= bi;
+            }
+            tt.w[k] = w[other];
+        }
+    }
+
+    return tt;
+}
+
+// Cube of literals, as masks of positive and negative variables
+struct Cube {
+    uint32_t pos, neg;
+};
+
+// Minato-Morreale irredundant sum of products.
+// Cover every minterm of lo with cubes inside hi,
+// using variables below limit, and return the cover's function.
+static TruthTable isop(TruthTable const &lo, TruthTable const &hi,
+                       uint32_t limit, vector<Cube> &cubes) {
+    auto n = lo.nvars();
+
+    if (lo.is_zero()) {
+        return TruthTable(n, false);
+    }
+    if (hi.is_one()) {
+        cubes.push_back({0, 0});
+        return TruthTable(n, true);
+    }
+
+    // Split on the highest variable either bound depends on
+    auto i = limit;
+    while (i-- > 0) {
+        if (lo.depends_on(i) || hi.depends_on(i)) {
+            break;
+        }
+    }
+    assert(i < limit);
+
+    auto lo0 = lo.cofactor(i, false);
+    auto lo1 = lo.cofactor(i, true);
+    auto hi0 = hi.cofactor(i, false);
+    auto hi1 = hi.cofactor(i, true);
+
+    // Cubes that need the literal ~x or x
+    auto first = cubes.size();
+    auto r0 = isop(lo0 & ~hi1, hi0, i, cubes);
+    for (auto k = first; k < cubes.size(); ++k) {
+        cubes[k].neg |= 1u << i;
+    }
+    first = cubes.size();
+    auto r1 = isop(lo1 & ~hi0, hi1, i, cubes);
+    for (auto k = first; k < cubes.size(); ++k) {
+        cubes[k].pos |= 1u << i;
+    }
+
+    // Cubes that need neither
+    auto r2 = isop((lo0 & ~r0) | (lo1 & ~r1), hi0 & hi1, i, cubes);
+
+    auto x = TruthTable::var(n, i);
+    return (r0 & ~x) | (r1 & x) | r2;
+}
+
+bx_t TruthTable::to_bx(vector<var_t> const &vars) const {
+    assert(vars.size() == n);
+
+    vector<Cube> cubes;
+    isop(*this, *this, n, cubes);
+
+    vector<bx_t> terms;
+    for (auto const &cube : cubes) {
+        vector<bx_t> lits;
+        for (uint32_t i = 0; i < n; ++i) {
+            if (cube.pos & (1u << i)) {
+                lits.push_back(vars[i]);
+            } else if (cube.neg & (1u << i)) {
+                lits.push_back(~vars[i]);
+            }
+        }
+        terms.push_back(and_(std::move(lits)));
+    }
+    return or_s(std::move(terms));
+}
+
+bool small_support(vector<bx_t> const &exprs, vector<var_t> &vars) {
+    unordered_set<var_t> seen;
+    vars.clear();
+
+    for (auto const &expr : exprs) {
+        for (auto it = dfs_iter(expr); it != dfs_iter(); ++it) {
+            auto const &bx = *it;
+            if (IS_UNKNOWN(bx)) {
+                return false;
+            }
+            if (IS_LIT(bx)) {
+                auto x = IS_VAR(bx) ? static_pointer_cast<Variable const>(bx)
+                                    : static_pointer_cast<Variable const>(~bx);
+                if (seen.insert(x).second) {
+                    if (seen.size() > TruthTable::MAX_VARS) {
+                        return false;
+                    }
+                    vars.push_back(x);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+}  // namespace boolexpr
@@ -0,0 +1,39 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// WARNING:
+//     The contents of this file are implementation details.
+//     Do not use these declarations for anything,
+//     because they may change without notice.
+
+#ifndef BOOLEXPR_TRUTHTABLE_H_
+#define BOOLEXPR_TRUTHTABLE_H_
+
+#include "boolexpr/boolexpr.h"
+
+namespace boolexpr {
+
+// Collect the support of some expressions,
+// and return false if it is too big for a truth table,
+// or if an expression contains an unknown constant.
+bool small_support(std::vector<bx_t> const &, std::vector<var_t> &vars);
+
+// Negate input i, or exchange inputs i and j, within one word of a table.
+// Every input must be less than six.
+uint64_t flip_word(uint64_t, uint32_t i);
+uint64_t swap_word(uint64_t, uint32_t i, uint32_t j);
+
+}  // namespace boolexpr
+
+#endif  // BOOLEXPR_TRUTHTABLE_H_
@@ -20,29 +20,29 @@ using std::vector;
 
 namespace boolexpr {
 
-bx_t Atom::find_subop(bool &, Context &, std::string const &, uint32_t &,
+bx_t Atom::find_subop(bool &, Context &, std::string const &,
                       var2op_t &) const {
     return shared_from_this();
 }
 
 bx_t Operator::find_subop(bool &found, Context &ctx,
-                          std::string const &auxvarname, uint32_t &index,
+                          std::string const &auxvarname,
                           var2op_t &constraints) const {
     found = true;
-    return to_con1(ctx, auxvarname, index, constraints);
+    return to_con1(ctx, auxvarname, constraints);
 }
 
-var_t Operator::to_con1(Context &ctx, string const &auxvarname, uint32_t &index,
+var_t Operator::to_con1(Context &ctx, string const &auxvarname,
                         var2op_t &constraints) const {
-    auto key = ctx.get_var(auxvarname + "_" + std::to_string(index++));
-    auto val = to_con2(ctx, auxvarname, index, constraints);
+    auto key = ctx.get_anon_var(auxvarname);
+    auto val = to_con2(ctx, auxvarname, constraints);
 
     constraints.insert({key, val});
 
     return key;
 }
 
-op_t Operator::to_con2(Context &ctx, string const &auxvarname, uint32_t &index,
+op_t Operator::to_con2(Context &ctx, string const &auxvarname,
                        var2op_t &constraints) const {
     bool found = false;
 
@@ -51,8 +51,7 @@ op_t Operator::to_con2(Context &ctx, string const &auxvarname, uint32_t &index,
 
     // NOTE: do not use transform, b/c there's mutable state
     for (size_t i = 0; i < n; ++i) {
-        _args[i] =
-            args[i]->find_subop(found, ctx, auxvarname, index, constraints);
+        _args[i] = args[i]->find_subop(found, ctx, auxvarname, constraints);
     }
 
     if (found) {
@@ -71,10 +70,9 @@ bx_t Operator::tseytin(Context &ctx, string const &auxvarname) const {
         return shared_from_this();
     }
 
-    uint32_t index{0};
     var2op_t constraints;
 
-    auto top = to_con1(ctx, auxvarname, index, constraints);
+    auto top = to_con1(ctx, auxvarname, constraints);
 
     vector<bx_t> cnfs{top};
     for (auto const &constraint : constraints) {
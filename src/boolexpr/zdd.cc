@@ -0,0 +1,742 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <algorithm>  // fill, min, sort, swap
+#include <cassert>
+#include <unordered_map>
+
+#include "boolexpr/boolexpr.h"
+#include "bdd.h"
+
+using std::pair;
+using std::unordered_map;
+using std::vector;
+
+using boost::multiprecision::cpp_int;
+
+namespace boolexpr {
+
+static size_t const MIN_BUCKETS = 1 << 10;
+static size_t const MIN_GC_LIMIT = 1 << 16;
+static size_t const CACHE_SIZE = 1 << 18;
+
+// Literal x has id 2 * i + 1 and ~x has id 2 * i, so each ZDD variable
+// is its literal's id ^ 1.
+
+// The terminals: no cubes, and only the empty cube
+static uint32_t const ZDD_EMPTY = 0;
+static uint32_t const ZDD_BASE = 1;
+
+// Computed table operations. Zero marks an empty entry.
+enum : uint32_t {
+    OP_UNION = 1,
+    OP_INTERSECT,
+    OP_DIFF,
+    OP_PRODUCT,
+    OP_NONSUPERSETS,
+    OP_MINIMAL,
+};
+
+Zdd::Zdd() : mgr{nullptr}, e{ZDD_EMPTY} {}
+
+Zdd::Zdd(ZddManager *mgr, uint32_t e) : mgr{mgr}, e{e} { mgr->ref(e); }
+
+Zdd::Zdd(Zdd const &f) : mgr{f.mgr}, e{f.e} {
+    if (mgr) {
+        mgr->ref(e);
+    }
+}
+
+Zdd::Zdd(Zdd &&f) : mgr{f.mgr}, e{f.e} { f.mgr = nullptr; }
+
+Zdd::~Zdd() {
+    if (mgr) {
+        mgr->deref(e);
+    }
+}
+
+Zdd &Zdd::operator=(Zdd const &f) {
+    if (f.mgr) {
+        f.mgr->ref(f.e);
+    }
+    if (mgr) {
+        mgr->deref(e);
+    }
+    mgr = f.mgr;
+    e = f.e;
+    return *this;
+}
+
+Zdd &Zdd::operator=(Zdd &&f) {
+    if (this != &f) {
+        if (mgr) {
+            mgr->deref(e);
+        }
+        mgr = f.mgr;
+        e = f.e;
+        f.mgr = nullptr;
+    }
+    return *this;
+}
+
+bool Zdd::is_empty() const { return e == ZDD_EMPTY; }
+
+bool Zdd::is_base() const { return e == ZDD_BASE; }
+
+Zdd Zdd::operator|(Zdd const &g) const {
+    assert(mgr && mgr == g.mgr);
+    mgr->maybe_gc();
+    return Zdd(mgr, mgr->union_(e, g.e));
+}
+
+Zdd Zdd::operator&(Zdd const &g) const {
+    assert(mgr && mgr == g.mgr);
+    mgr->maybe_gc();
+    return Zdd(mgr, mgr->intersect(e, g.e));
+}
+
+Zdd Zdd::operator-(Zdd const &g) const {
+    assert(mgr && mgr == g.mgr);
+    mgr->maybe_gc();
+    return Zdd(mgr, mgr->diff(e, g.e));
+}
+
+Zdd Zdd::operator*(Zdd const &g) const {
+    assert(mgr && mgr == g.mgr);
+    mgr->maybe_gc();
+    return Zdd(mgr, mgr->product(e, g.e));
+}
+
+bool Zdd::operator==(Zdd const &g) const { return mgr == g.mgr && e == g.e; }
+
+bool Zdd::operator!=(Zdd const &g) const { return !(*this == g); }
+
+ZddManager::ZddManager(Context &ctx)
+    : ctx(ctx),
+      table(2),
+      free_list{0},
+      nlive{0},
+      gc_limit{MIN_GC_LIMIT},
+      buckets(MIN_BUCKETS, 0),
+      keys{0},
+      cache(CACHE_SIZE) {
+    table[ZDD_EMPTY] = {NO_LEVEL, ZDD_EMPTY, ZDD_EMPTY, 0, 0};
+    table[ZDD_BASE] = {NO_LEVEL, ZDD_BASE, ZDD_BASE, 0, 0};
+}
+
+void ZddManager::ref(uint32_t e) {
+    if (e > ZDD_BASE) {
+        ++table[e].refs;
+    }
+}
+
+void ZddManager::deref(uint32_t e) {
+    if (e > ZDD_BASE) {
+        assert(table[e].refs > 0);
+        --table[e].refs;
+    }
+}
+
+// Intermediate results hold no references,
+// so only collect at the start of a top-level operation.
+void ZddManager::maybe_gc() {
+    if (nlive >= gc_limit) {
+        gc();
+        // Most nodes are live, so collect less often
+        if (2 * nlive > gc_limit) {
+            gc_limit *= 2;
+        }
+    }
+}
+
+void ZddManager::gc() {
+    // A node holds a reference to each of its children,
+    // so dead nodes release their children in turn.
+    vector<bool> dead(table.size(), false);
+    vector<uint32_t> stack;
+    for (uint32_t i = ZDD_BASE + 1; i < table.size(); ++i) {
+        if (table[i].var != FREE && table[i].refs == 0) {
+            dead[i] = true;
+            stack.push_back(i);
+        }
+    }
+    vector<uint32_t> freed;
+    while (!stack.empty()) {
+        auto i = stack.back();
+        stack.pop_back();
+        freed.push_back(i);
+        for (auto j : {table[i].lo, table[i].hi}) {
+            if (j > ZDD_BASE && --table[j].refs == 0) {
+                dead[j] = true;
+                stack.push_back(j);
+            }
+        }
+    }
+
+    if (freed.empty()) {
+        return;
+    }
+
+    for (auto &bucket : buckets) {
+        auto *p = &bucket;
+        while (*p) {
+            if (dead[*p]) {
+                *p = table[*p].next;
+                --keys;
+            } else {
+                p = &table[*p].next;
+            }
+        }
+    }
+
+    for (auto i : freed) {
+        table[i].var = FREE;
+        table[i].next = free_list;
+        free_list = i;
+    }
+    nlive -= freed.size();
+
+    // Entries may name freed nodes
+    std::fill(cache.begin(), cache.end(), CacheEntry{0, 0, 0, 0});
+}
+
+void ZddManager::index(var_t const &x) {
+    assert(x->ctx == &ctx);
+
+    uint32_t v = x->id >> 1;
+    if (v >= index2var.size()) {
+        index2var.resize(v + 1);
+    }
+    index2var[v] = x;
+}
+
+uint32_t ZddManager::top(uint32_t e) const { return table[e].var; }
+
+uint32_t ZddManager::mk(uint32_t z, uint32_t lo, uint32_t hi) {
+    // Zero suppression
+    if (hi == ZDD_EMPTY) {
+        return lo;
+    }
+
+    auto b = hash4(z, lo, hi, 0) & (buckets.size() - 1);
+    for (auto i = buckets[b]; i; i = table[i].next) {
+        if (table[i].var == z && table[i].lo == lo && table[i].hi == hi) {
+            return i;
+        }
+    }
+
+    uint32_t i;
+    if (free_list) {
+        i = free_list;
+        free_list = table[i].next;
+    } else {
+        i = table.size();
+        table.push_back(Node());
+    }
+    table[i] = {z, lo, hi, buckets[b], 0};
+    buckets[b] = i;
+    ++nlive;
+    ref(lo);
+    ref(hi);
+
+    if (++keys > 2 * buckets.size()) {
+        resize();
+    }
+
+    return i;
+}
+
+void ZddManager::resize() {
+    vector<uint32_t> bigger(2 * buckets.size(), 0);
+    auto mask = bigger.size() - 1;
+    for (auto head : buckets) {
+        for (auto i = head; i;) {
+            auto next = table[i].next;
+            auto b = hash4(table[i].var, table[i].lo, table[i].hi, 0) & mask;
+            table[i].next = bigger[b];
+            bigger[b] = i;
+            i = next;
+        }
+    }
+    buckets.swap(bigger);
+}
+
+bool ZddManager::lookup(uint32_t op, uint32_t f, uint32_t g, uint32_t &r) {
+    auto const &entry = cache[hash4(op, f, g, 0) & (cache.size() - 1)];
+    if (entry.op == op && entry.f == f && entry.g == g) {
+        r = entry.r;
+        return true;
+    }
+    return false;
+}
+
+void ZddManager::insert(uint32_t op, uint32_t f, uint32_t g, uint32_t r) {
+    cache[hash4(op, f, g, 0) & (cache.size() - 1)] = {op, f, g, r};
+}
+
+uint32_t ZddManager::union_(uint32_t f, uint32_t g) {
+    if (f == ZDD_EMPTY || f == g) {
+        return g;
+    }
+    if (g == ZDD_EMPTY) {
+        return f;
+    }
+    if (f > g) {
+        std::swap(f, g);
+    }
+
+    uint32_t r;
+    if (lookup(OP_UNION, f, g, r)) {
+        return r;
+    }
+
+    auto zf = top(f);
+    auto zg = top(g);
+    if (zf < zg) {
+        r = mk(zf, union_(table[f].lo, g), table[f].hi);
+    } else if (zf > zg) {
+        r = mk(zg, union_(f, table[g].lo), table[g].hi);
+    } else {
+        r = mk(zf, union_(table[f].lo, table[g].lo),
+               union_(table[f].hi, table[g].hi));
+    }
+
+    insert(OP_UNION, f, g, r);
+    return r;
+}
+
+uint32_t ZddManager::intersect(uint32_t f, uint32_t g) {
+    if (f == ZDD_EMPTY || g == ZDD_EMPTY) {
+        return ZDD_EMPTY;
+    }
+    if (f == g) {
+        return f;
+    }
+    if (f > g) {
+        std::swap(f, g);
+    }
+
+    uint32_t r;
+    if (lookup(OP_INTERSECT, f, g, r)) {
+        return r;
+    }
+
+    auto zf = top(f);
+    auto zg = top(g);
+    if (zf < zg) {
+        r = intersect(table[f].lo, g);
+    } else if (zf > zg) {
+        r = intersect(f, table[g].lo);
+    } else {
+        r = mk(zf, intersect(table[f].lo, table[g].lo),
+               intersect(table[f].hi, table[g].hi));
+    }
+
+    insert(OP_INTERSECT, f, g, r);
+    return r;
+}
+
+uint32_t ZddManager::diff(uint32_t f, uint32_t g) {
+    if (f == ZDD_EMPTY || f == g) {
+        return ZDD_EMPTY;
+    }
+    if (g == ZDD_EMPTY) {
+        return f;
+    }
+
+    uint32_t r;
+    if (lookup(OP_DIFF, f, g, r)) {
+        return r;
+    }
+
+    auto zf = top(f);
+    auto zg = top(g);
+    if (zf < zg) {
+        r = mk(zf, diff(table[f].lo, g), table[f].hi);
+    } else if (zf > zg) {
+        r = diff(f, table[g].lo);
+    } else {
+        r = mk(zf, diff(table[f].lo, table[g].lo),
+               diff(table[f].hi, table[g].hi));
+    }
+
+    insert(OP_DIFF, f, g, r);
+    return r;
+}
+
+// Literals x and ~x are adjacent, so split both at once:
+// f = x * f1 | ~x * f0 | fd, and drop the cubes with x * ~x.
+uint32_t ZddManager::product(uint32_t f, uint32_t g) {
+    if (f == ZDD_EMPTY || g == ZDD_EMPTY) {
+        return ZDD_EMPTY;
+    }
+    if (f == ZDD_BASE) {
+        return g;
+    }
+    if (g == ZDD_BASE) {
+        return f;
+    }
+    if (f > g) {
+        std::swap(f, g);
+    }
+
+    uint32_t r;
+    if (lookup(OP_PRODUCT, f, g, r)) {
+        return r;
+    }
+
+    auto x = std::min(top(f), top(g)) & ~1u;
+    auto split = [this, x](uint32_t e, uint32_t &e1, uint32_t &e0,
+                           uint32_t &ed) {
+        e1 = e0 = ZDD_EMPTY;
+        ed = e;
+        if (top(ed) == x) {
+            e1 = table[ed].hi;
+            ed = table[ed].lo;
+        }
+        if (top(ed) == (x | 1)) {
+            e0 = table[ed].hi;
+            ed = table[ed].lo;
+        }
+    };
+    uint32_t f1, f0, fd, g1, g0, gd;
+    split(f, f1, f0, fd);
+    split(g, g1, g0, gd);
+
+    auto pos = union_(product(f1, union_(g1, gd)), product(fd, g1));
+    auto neg = union_(product(f0, union_(g0, gd)), product(fd, g0));
+    auto rest = product(fd, gd);
+    r = mk(x, mk(x | 1, rest, neg), pos);
+
+    insert(OP_PRODUCT, f, g, r);
+    return r;
+}
+
+// The cubes of f that contain no cube of g
+uint32_t ZddManager::nonsupersets(uint32_t f, uint32_t g) {
+    if (g == ZDD_EMPTY) {
+        return f;
+    }
+    // Every cube contains the empty cube
+    if (f == ZDD_EMPTY || g == ZDD_BASE || f == g) {
+        return ZDD_EMPTY;
+    }
+
+    uint32_t r;
+    if (lookup(OP_NONSUPERSETS, f, g, r)) {
+        return r;
+    }
+
+    auto zf = top(f);
+    auto zg = top(g);
+    if (zf < zg) {
+        r = mk(zf, nonsupersets(table[f].lo, g),
+               nonsupersets(table[f].hi, g));
+    } else if (zf > zg) {
+        // No cube of f has the top literal of g
+        r = nonsupersets(f, table[g].lo);
+    } else {
+        auto hi = intersect(nonsupersets(table[f].hi, table[g].lo),
+                            nonsupersets(table[f].hi, table[g].hi));
+        r = mk(zf, nonsupersets(table[f].lo, table[g].lo), hi);
+    }
+
+    insert(OP_NONSUPERSETS, f, g, r);
+    return r;
+}
+
+uint32_t ZddManager::minimal(uint32_t f) {
+    if (f <= ZDD_BASE) {
+        return f;
+    }
+
+    uint32_t r;
+    if (lookup(OP_MINIMAL, f, 0, r)) {
+        return r;
+    }
+
+    // A cube with the top literal goes if the rest contains a cube without it
+    auto lo = minimal(table[f].lo);
+    auto hi = nonsupersets(minimal(table[f].hi), lo);
+    r = mk(top(f), lo, hi);
+
+    insert(OP_MINIMAL, f, 0, r);
+    return r;
+}
+
+pair<uint32_t, uint32_t> ZddManager::isop(
+    BddManager &bdd, uint32_t lower, uint32_t upper,
+    unordered_map<uint64_t, pair<uint32_t, uint32_t>> &memo) {
+    if (lower == BDD_ZERO) {
+        return {ZDD_EMPTY, BDD_ZERO};
+    }
+    if (upper == BDD_ONE) {
+        return {ZDD_BASE, BDD_ONE};
+    }
+
+    auto key = uint64_t(lower) << 32 | upper;
+    auto it = memo.find(key);
+    if (it != memo.end()) {
+        return it->second;
+    }
+
+    auto v = bdd.level2var[std::min(bdd.level(lower), bdd.level(upper))];
+    auto l0 = bdd.cofactor(lower, v, false);
+    auto l1 = bdd.cofactor(lower, v, true);
+    auto u0 = bdd.cofactor(upper, v, false);
+    auto u1 = bdd.cofactor(upper, v, true);
+
+    // Cubes with ~x cover what only the x=0 side needs, and so on
+    auto c0 = isop(bdd, bdd.apply_and(l0, u1 ^ 1), u0, memo);
+    auto c1 = isop(bdd, bdd.apply_and(l1, u0 ^ 1), u1, memo);
+
+    // Cubes without x cover the rest, within both sides
+    auto ld = bdd.apply_and(bdd.apply_and(l0, c0.second ^ 1) ^ 1,
+                            bdd.apply_and(l1, c1.second ^ 1) ^ 1) ^
+              1;
+    auto cd = isop(bdd, ld, bdd.apply_and(u0, u1), memo);
+
+    index(bdd.index2var[v]);
+    auto x = mk(2 * v, ZDD_EMPTY, ZDD_BASE);
+    auto xn = mk(2 * v + 1, ZDD_EMPTY, ZDD_BASE);
+    auto cover =
+        union_(union_(product(x, c1.first), product(xn, c0.first)), cd.first);
+
+    auto lo = bdd.apply_and(c0.second ^ 1, cd.second ^ 1) ^ 1;
+    auto hi = bdd.apply_and(c1.second ^ 1, cd.second ^ 1) ^ 1;
+    pair<uint32_t, uint32_t> result{cover, bdd.mk(v, lo, hi)};
+
+    memo.insert({key, result});
+    return result;
+}
+
+uint32_t ZddManager::two_level(bx_t const &bx, bool cnf) {
+    auto f = bx->to_nnf();
+    unordered_map<BoolExpr const *, uint32_t> memo;
+
+    for (auto it = dfs_iter(f); it != dfs_iter(); ++it) {
+        auto const &node = *it;
+        uint32_t r = ZDD_EMPTY;
+
+        switch (node->kind) {
+            case BoolExpr::ZERO:
+                r = cnf ? ZDD_BASE : ZDD_EMPTY;
+                break;
+
+            case BoolExpr::ONE:
+                r = cnf ? ZDD_EMPTY : ZDD_BASE;
+                break;
+
+            case BoolExpr::COMP:
+            case BoolExpr::VAR: {
+                auto x = std::static_pointer_cast<Literal const>(node);
+                auto v = IS_COMP(x) ? ~node : node;
+                index(std::static_pointer_cast<Variable const>(v));
+                r = mk(x->id ^ 1, ZDD_EMPTY, ZDD_BASE);
+                break;
+            }
+
+            case BoolExpr::OR:
+            case BoolExpr::AND: {
+                auto op = std::static_pointer_cast<Operator const>(node);
+                // Union for the outer operator, product for the inner
+                bool outer = (node->kind == BoolExpr::OR) != cnf;
+                r = outer ? ZDD_EMPTY : ZDD_BASE;
+                for (auto const &arg : op->args) {
+                    auto a = memo[arg.get()];
+                    r = outer ? union_(r, a) : product(r, a);
+                }
+                r = minimal(r);
+                break;
+            }
+
+            default:
+                assert(false);  // LCOV_EXCL_LINE
+        }
+
+        memo.insert({node.get(), r});
+    }
+
+    return memo[f.get()];
+}
+
+bx_t ZddManager::to_two_level(uint32_t e, bool cnf) {
+    vector<bx_t> terms;
+    vector<bx_t> lits;
+
+    // Each item is an edge, and the length of the path to it
+    vector<pair<uint32_t, size_t>> stack{{e, 0}};
+    while (!stack.empty()) {
+        auto item = stack.back();
+        stack.pop_back();
+        lits.resize(item.second);
+        // High edges are never empty, so they end at the base
+        for (auto i = item.first; i > ZDD_BASE; i = table[i].hi) {
+            stack.push_back({table[i].lo, lits.size()});
+            bx_t x = index2var[table[i].var >> 1];
+            lits.push_back((table[i].var & 1) ? ~x : x);
+        }
+        if (item.first != ZDD_EMPTY) {
+            terms.push_back(cnf ? or_(lits) : and_(lits));
+        }
+    }
+
+    return cnf ? and_(terms) : or_(terms);
+}
+
+vector<uint32_t> ZddManager::postorder(uint32_t e) const {
+    vector<uint32_t> order;
+    vector<bool> seen(table.size(), false);
+
+    // Each node is pushed once to expand it, and once to emit it
+    vector<pair<uint32_t, bool>> stack;
+    if (e > ZDD_BASE) {
+        stack.push_back({e, false});
+    }
+    while (!stack.empty()) {
+        auto item = stack.back();
+        stack.pop_back();
+        auto i = item.first;
+        if (item.second) {
+            order.push_back(i);
+            continue;
+        }
+        if (seen[i]) {
+            continue;
+        }
+        seen[i] = true;
+        stack.push_back({i, true});
+        for (auto j : {table[i].hi, table[i].lo}) {
+            if (j > ZDD_BASE && !seen[j]) {
+                stack.push_back({j, false});
+            }
+        }
+    }
+
+    return order;
+}
+
+Zdd ZddManager::empty() { return Zdd(this, ZDD_EMPTY); }
+
+Zdd ZddManager::base() { return Zdd(this, ZDD_BASE); }
+
+Zdd ZddManager::cube(vector<bx_t> const &xs) {
+    maybe_gc();
+
+    vector<uint32_t> zs;
+    for (auto const &bx : xs) {
+        assert(IS_LIT(bx));
+        auto x = std::static_pointer_cast<Literal const>(bx);
+        index(std::static_pointer_cast<Variable const>(IS_COMP(x) ? ~bx : bx));
+        zs.push_back(x->id ^ 1);
+    }
+    // Build from the bottom up
+    std::sort(zs.begin(), zs.end(),
+              [](uint32_t a, uint32_t b) { return a > b; });
+
+    uint32_t r = ZDD_BASE;
+    for (size_t k = 0; k < zs.size(); ++k) {
+        if (k > 0 && zs[k] == zs[k - 1]) {
+            continue;
+        }
+        if (k > 0 && (zs[k] ^ 1) == zs[k - 1]) {
+            return empty();
+        }
+        r = mk(zs[k], ZDD_EMPTY, r);
+    }
+    return Zdd(this, r);
+}
+
+Zdd ZddManager::dnf(bx_t const &bx) {
+    maybe_gc();
+    return Zdd(this, two_level(bx, false));
+}
+
+Zdd ZddManager::cnf(bx_t const &bx) {
+    maybe_gc();
+    return Zdd(this, two_level(bx, true));
+}
+
+Zdd ZddManager::minimal(Zdd const &f) {
+    assert(f.mgr == this);
+    maybe_gc();
+    return Zdd(this, minimal(f.e));
+}
+
+Zdd ZddManager::isop(Bdd const &lower, Bdd const &upper) {
+    assert(lower.mgr && lower.mgr == upper.mgr);
+    auto &bdd = *lower.mgr;
+    assert(&bdd.ctx == &ctx);
+
+    bdd.maybe_gc();
+    maybe_gc();
+    assert(bdd.apply_and(lower.e, upper.e ^ 1) == BDD_ZERO);
+
+    unordered_map<uint64_t, pair<uint32_t, uint32_t>> memo;
+    return Zdd(this, isop(bdd, lower.e, upper.e, memo).first);
+}
+
+Zdd ZddManager::isop(Bdd const &f) { return isop(f, f); }
+
+Bdd ZddManager::to_bdd(Zdd const &f, BddManager &bdd) {
+    assert(f.mgr == this);
+    assert(&bdd.ctx == &ctx);
+    bdd.maybe_gc();
+
+    unordered_map<uint32_t, uint32_t> memo;
+    auto edge = [&memo](uint32_t e) {
+        return e == ZDD_EMPTY ? BDD_ZERO : e == ZDD_BASE ? BDD_ONE : memo[e];
+    };
+
+    for (auto i : postorder(f.e)) {
+        auto z = table[i].var;
+        auto v = bdd.index(index2var[z >> 1]);
+        auto x = bdd.mk(v, BDD_ZERO, BDD_ONE) ^ (z & 1);
+        auto hi = bdd.apply(OP_AND, x, edge(table[i].hi), 0);
+        auto r = bdd.apply(OP_AND, edge(table[i].lo) ^ 1, hi ^ 1, 0) ^ 1;
+        memo.insert({i, r});
+    }
+
+    return Bdd(&bdd, edge(f.e));
+}
+
+bx_t ZddManager::to_dnf(Zdd const &f) {
+    assert(f.mgr == this);
+    return to_two_level(f.e, false);
+}
+
+bx_t ZddManager::to_cnf(Zdd const &f) {
+    assert(f.mgr == this);
+    return to_two_level(f.e, true);
+}
+
+cpp_int ZddManager::count(Zdd const &f) {
+    assert(f.mgr == this);
+
+    unordered_map<uint32_t, cpp_int> counts;
+    auto get = [&counts](uint32_t e) -> cpp_int {
+        return e == ZDD_EMPTY ? cpp_int(0)
+                              : e == ZDD_BASE ? cpp_int(1) : counts[e];
+    };
+    for (auto i : postorder(f.e)) {
+        counts[i] = get(table[i].lo) + get(table[i].hi);
+    }
+    return get(f.e);
+}
+
+size_t ZddManager::size(Zdd const &f) const {
+    assert(f.mgr == this);
+    return postorder(f.e).size();
+}
+
+}  // namespace boolexpr
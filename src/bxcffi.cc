@@ -18,26 +18,44 @@
 #include "boolexpr/boolexpr.h"
 #include "bxcffi.h"
 
+using std::shared_ptr;
 using std::static_pointer_cast;
 using std::string;
 using std::vector;
 
+using boolexpr::AMOEncoding;
 using boolexpr::Array;
+using boolexpr::AssumptionCache;
+using boolexpr::Bdd;
+using boolexpr::BddManager;
+using boolexpr::BddReorder;
 using boolexpr::BoolExpr;
+using boolexpr::CardEncoding;
+using boolexpr::CompiledExpr;
 using boolexpr::Constant;
 using boolexpr::Context;
 using boolexpr::Literal;
 using boolexpr::Operator;
+using boolexpr::PBEncoding;
+using boolexpr::SatInterrupt;
+using boolexpr::SatOptions;
+using boolexpr::SatSession;
 using boolexpr::Variable;
+using boolexpr::Zdd;
+using boolexpr::ZddManager;
 
 using boolexpr::bx_t;
 using boolexpr::const_t;
 using boolexpr::illogical;
+using boolexpr::lit_t;
 using boolexpr::logical;
 using boolexpr::one;
 using boolexpr::point_t;
+using boolexpr::remote_sat;
+using boolexpr::serve_cubes;
 using boolexpr::var_t;
 using boolexpr::var2bx_t;
+using boolexpr::var2words_t;
 using boolexpr::zero;
 
 DllExport CONTEXT boolexpr_Context_new() { return new Context(); }
@@ -56,6 +74,21 @@ DllExport BX boolexpr_Context_get_var(CONTEXT c_self, STRING c_name) {
     return new BoolExprProxy(bx);
 }
 
+DllExport void boolexpr_Context_push_scope(CONTEXT c_self) {
+    auto self = reinterpret_cast<Context* const>(c_self);
+    self->push_scope();
+}
+
+DllExport bool boolexpr_Context_pop_scope(CONTEXT c_self) {
+    auto self = reinterpret_cast<Context* const>(c_self);
+    return self->pop_scope();
+}
+
+DllExport size_t boolexpr_Context_num_scopes(CONTEXT c_self) {
+    auto self = reinterpret_cast<Context const* const>(c_self);
+    return self->num_scopes();
+}
+
 DllExport void boolexpr_String_del(STRING c_str) { delete[] c_str; }
 
 DllExport void boolexpr_Vec_del(VEC c_self) {
@@ -133,12 +166,556 @@ DllExport bool boolexpr_Soln_first(SOLN c_self) {
     return self->soln.first;
 }
 
+DllExport uint8_t boolexpr_Soln_status(SOLN c_self) {
+    auto self = reinterpret_cast<SolnProxy* const>(c_self);
+    return static_cast<uint8_t>(self->status);
+}
+
 DllExport POINT boolexpr_Soln_second(SOLN c_self) {
     auto self = reinterpret_cast<SolnProxy* const>(c_self);
     auto point = *(self->soln.second);
     return new MapProxy<var_t, const_t>(std::move(point));
 }
 
+DllExport SAT_INTERRUPT boolexpr_SatInterrupt_new() {
+    return new shared_ptr<SatInterrupt>(new SatInterrupt());
+}
+
+DllExport void boolexpr_SatInterrupt_del(SAT_INTERRUPT c_self) {
+    auto self = reinterpret_cast<shared_ptr<SatInterrupt>* const>(c_self);
+    delete self;
+}
+
+DllExport void boolexpr_SatInterrupt_interrupt(SAT_INTERRUPT c_self) {
+    auto self = reinterpret_cast<shared_ptr<SatInterrupt>* const>(c_self);
+    (*self)->interrupt();
+}
+
+DllExport void boolexpr_SatInterrupt_reset(SAT_INTERRUPT c_self) {
+    auto self = reinterpret_cast<shared_ptr<SatInterrupt>* const>(c_self);
+    (*self)->reset();
+}
+
+DllExport COMPILED_EXPR boolexpr_CompiledExpr_new(BX c_bxp) {
+    auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxp);
+    auto self = new CompiledExpr(bxp->bx);
+    if (!self->okay()) {
+        delete self;
+        return nullptr;
+    }
+    return self;
+}
+
+DllExport void boolexpr_CompiledExpr_del(COMPILED_EXPR c_self) {
+    auto self = reinterpret_cast<CompiledExpr* const>(c_self);
+    delete self;
+}
+
+DllExport VEC boolexpr_CompiledExpr_inputs(COMPILED_EXPR c_self) {
+    auto self = reinterpret_cast<CompiledExpr* const>(c_self);
+    auto const& xs = self->inputs();
+    return new VecProxy<bx_t>(vector<bx_t>(xs.begin(), xs.end()));
+}
+
+DllExport bool boolexpr_CompiledExpr_eval(COMPILED_EXPR c_self,
+                                          PATTERNS c_point) {
+    auto self = reinterpret_cast<CompiledExpr* const>(c_self);
+    return self->eval(c_point);
+}
+
+DllExport void boolexpr_CompiledExpr_eval_many(COMPILED_EXPR c_self, size_t n,
+                                               PATTERNS c_points,
+                                               uint64_t* c_results) {
+    auto self = reinterpret_cast<CompiledExpr* const>(c_self);
+    self->eval(c_points, n, c_results);
+}
+
+DllExport BDD_MANAGER boolexpr_BddManager_new(CONTEXT c_ctx,
+                                              uint32_t nthreads) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    return new BddManager(*ctx, nthreads);
+}
+
+DllExport void boolexpr_BddManager_del(BDD_MANAGER c_self) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    delete self;
+}
+
+DllExport BDD boolexpr_BddManager_zero(BDD_MANAGER c_self) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    return new Bdd(self->zero());
+}
+
+DllExport BDD boolexpr_BddManager_one(BDD_MANAGER c_self) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    return new Bdd(self->one());
+}
+
+DllExport BDD boolexpr_BddManager_to_bdd(BDD_MANAGER c_self, BX c_bxp) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxp);
+    return new Bdd(self->to_bdd(bxp->bx));
+}
+
+DllExport VEC boolexpr_BddManager_order(BDD_MANAGER c_self) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    auto xs = self->order();
+    return new VecProxy<bx_t>(vector<bx_t>(xs.begin(), xs.end()));
+}
+
+DllExport size_t boolexpr_BddManager_nodes(BDD_MANAGER c_self) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    return self->nodes();
+}
+
+DllExport void boolexpr_BddManager_gc(BDD_MANAGER c_self) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    self->gc();
+}
+
+DllExport void boolexpr_BddManager_reorder(BDD_MANAGER c_self,
+                                           uint8_t method) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    self->reorder(static_cast<BddReorder>(method));
+}
+
+DllExport void boolexpr_BddManager_set_auto_reorder(BDD_MANAGER c_self,
+                                                    uint8_t method) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    self->set_auto_reorder(static_cast<BddReorder>(method));
+}
+
+DllExport void boolexpr_BddManager_group(BDD_MANAGER c_self, size_t n,
+                                         VARS c_varps) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    vector<var_t> vars(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        vars[i] = static_pointer_cast<Variable const>(varp->bx);
+    }
+    self->group(vars);
+}
+
+DllExport void boolexpr_BddManager_set_order(BDD_MANAGER c_self, size_t n,
+                                             VARS c_varps) {
+    auto self = reinterpret_cast<BddManager* const>(c_self);
+    vector<var_t> vars(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        vars[i] = static_pointer_cast<Variable const>(varp->bx);
+    }
+    self->set_order(vars);
+}
+
+DllExport void boolexpr_Bdd_del(BDD c_self) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    delete self;
+}
+
+DllExport BDD boolexpr_Bdd_not(BDD c_self) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    return new Bdd(~*self);
+}
+
+DllExport BDD boolexpr_Bdd_and(BDD c_self, BDD c_other) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    auto other = reinterpret_cast<Bdd* const>(c_other);
+    return new Bdd(*self & *other);
+}
+
+DllExport BDD boolexpr_Bdd_or(BDD c_self, BDD c_other) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    auto other = reinterpret_cast<Bdd* const>(c_other);
+    return new Bdd(*self | *other);
+}
+
+DllExport BDD boolexpr_Bdd_xor(BDD c_self, BDD c_other) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    auto other = reinterpret_cast<Bdd* const>(c_other);
+    return new Bdd(*self ^ *other);
+}
+
+DllExport BDD boolexpr_Bdd_ite(BDD c_self, BDD c_g, BDD c_h) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    auto g = reinterpret_cast<Bdd* const>(c_g);
+    auto h = reinterpret_cast<Bdd* const>(c_h);
+    return new Bdd(self->manager()->ite(*self, *g, *h));
+}
+
+DllExport bool boolexpr_Bdd_equal(BDD c_self, BDD c_other) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    auto other = reinterpret_cast<Bdd* const>(c_other);
+    return *self == *other;
+}
+
+DllExport BDD boolexpr_Bdd_restrict(BDD c_self, size_t n, VARS c_varps,
+                                    CONSTS c_constps) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    auto point = point_t();
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        auto constp =
+            reinterpret_cast<BoolExprProxy const* const>(c_constps[i]);
+        auto var = static_pointer_cast<Variable const>(varp->bx);
+        auto const_ = static_pointer_cast<Constant const>(constp->bx);
+        point.insert({var, const_});
+    }
+    return new Bdd(self->manager()->restrict_(*self, point));
+}
+
+DllExport BDD boolexpr_Bdd_exists(BDD c_self, size_t n, VARS c_varps) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    vector<var_t> vars(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        vars[i] = static_pointer_cast<Variable const>(varp->bx);
+    }
+    return new Bdd(self->manager()->exists(*self, vars));
+}
+
+DllExport BDD boolexpr_Bdd_forall(BDD c_self, size_t n, VARS c_varps) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    vector<var_t> vars(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        vars[i] = static_pointer_cast<Variable const>(varp->bx);
+    }
+    return new Bdd(self->manager()->forall(*self, vars));
+}
+
+DllExport STRING boolexpr_Bdd_sat_count(BDD c_self) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    auto str = self->manager()->sat_count(*self).str();
+    auto c_str = new char[str.length() + 1];
+    std::strcpy(c_str, str.c_str());
+    return c_str;
+}
+
+DllExport VEC boolexpr_Bdd_support(BDD c_self) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    auto xs = self->manager()->support(*self);
+    return new VecProxy<bx_t>(vector<bx_t>(xs.begin(), xs.end()));
+}
+
+DllExport size_t boolexpr_Bdd_size(BDD c_self) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    return self->manager()->size(*self);
+}
+
+DllExport BX boolexpr_Bdd_to_bx(BDD c_self) {
+    auto self = reinterpret_cast<Bdd* const>(c_self);
+    return new BoolExprProxy(self->manager()->from_bdd(*self));
+}
+
+DllExport BDD_SAT_ITER boolexpr_BddSatIter_new(BDD c_bdd) {
+    auto bdd = reinterpret_cast<Bdd* const>(c_bdd);
+    return new BddSatIterProxy(*bdd);
+}
+
+DllExport void boolexpr_BddSatIter_del(BDD_SAT_ITER c_self) {
+    auto self = reinterpret_cast<BddSatIterProxy* const>(c_self);
+    delete self;
+}
+
+DllExport void boolexpr_BddSatIter_next(BDD_SAT_ITER c_self) {
+    auto self = reinterpret_cast<BddSatIterProxy* const>(c_self);
+    self->next();
+}
+
+DllExport POINT boolexpr_BddSatIter_val(BDD_SAT_ITER c_self) {
+    auto self = reinterpret_cast<BddSatIterProxy* const>(c_self);
+    return self->val();
+}
+
+DllExport ZDD_MANAGER boolexpr_ZddManager_new(CONTEXT c_ctx) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    return new ZddManager(*ctx);
+}
+
+DllExport void boolexpr_ZddManager_del(ZDD_MANAGER c_self) {
+    auto self = reinterpret_cast<ZddManager* const>(c_self);
+    delete self;
+}
+
+DllExport ZDD boolexpr_ZddManager_empty(ZDD_MANAGER c_self) {
+    auto self = reinterpret_cast<ZddManager* const>(c_self);
+    return new Zdd(self->empty());
+}
+
+DllExport ZDD boolexpr_ZddManager_base(ZDD_MANAGER c_self) {
+    auto self = reinterpret_cast<ZddManager* const>(c_self);
+    return new Zdd(self->base());
+}
+
+DllExport ZDD boolexpr_ZddManager_cube(ZDD_MANAGER c_self, size_t n,
+                                       BXS c_bxps) {
+    auto self = reinterpret_cast<ZddManager* const>(c_self);
+    vector<bx_t> lits(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxps[i]);
+        lits[i] = bxp->bx;
+    }
+    return new Zdd(self->cube(lits));
+}
+
+DllExport ZDD boolexpr_ZddManager_dnf(ZDD_MANAGER c_self, BX c_bxp) {
+    auto self = reinterpret_cast<ZddManager* const>(c_self);
+    auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxp);
+    return new Zdd(self->dnf(bxp->bx));
+}
+
+DllExport ZDD boolexpr_ZddManager_cnf(ZDD_MANAGER c_self, BX c_bxp) {
+    auto self = reinterpret_cast<ZddManager* const>(c_self);
+    auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxp);
+    return new Zdd(self->cnf(bxp->bx));
+}
+
+DllExport ZDD boolexpr_ZddManager_isop(ZDD_MANAGER c_self, BDD c_lower,
+                                       BDD c_upper) {
+    auto self = reinterpret_cast<ZddManager* const>(c_self);
+    auto lower = reinterpret_cast<Bdd* const>(c_lower);
+    auto upper = reinterpret_cast<Bdd* const>(c_upper);
+    return new Zdd(self->isop(*lower, *upper));
+}
+
+DllExport size_t boolexpr_ZddManager_nodes(ZDD_MANAGER c_self) {
+    auto self = reinterpret_cast<ZddManager* const>(c_self);
+    return self->nodes();
+}
+
+DllExport void boolexpr_ZddManager_gc(ZDD_MANAGER c_self) {
+    auto self = reinterpret_cast<ZddManager* const>(c_self);
+    self->gc();
+}
+
+DllExport void boolexpr_Zdd_del(ZDD c_self) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    delete self;
+}
+
+DllExport ZDD boolexpr_Zdd_or(ZDD c_self, ZDD c_other) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    auto other = reinterpret_cast<Zdd* const>(c_other);
+    return new Zdd(*self | *other);
+}
+
+DllExport ZDD boolexpr_Zdd_and(ZDD c_self, ZDD c_other) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    auto other = reinterpret_cast<Zdd* const>(c_other);
+    return new Zdd(*self & *other);
+}
+
+DllExport ZDD boolexpr_Zdd_sub(ZDD c_self, ZDD c_other) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    auto other = reinterpret_cast<Zdd* const>(c_other);
+    return new Zdd(*self - *other);
+}
+
+DllExport ZDD boolexpr_Zdd_mul(ZDD c_self, ZDD c_other) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    auto other = reinterpret_cast<Zdd* const>(c_other);
+    return new Zdd(*self * *other);
+}
+
+DllExport bool boolexpr_Zdd_equal(ZDD c_self, ZDD c_other) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    auto other = reinterpret_cast<Zdd* const>(c_other);
+    return *self == *other;
+}
+
+DllExport ZDD boolexpr_Zdd_minimal(ZDD c_self) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    return new Zdd(self->manager()->minimal(*self));
+}
+
+DllExport BDD boolexpr_Zdd_to_bdd(ZDD c_self, BDD_MANAGER c_bdd_mgr) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    auto bdd_mgr = reinterpret_cast<BddManager* const>(c_bdd_mgr);
+    return new Bdd(self->manager()->to_bdd(*self, *bdd_mgr));
+}
+
+DllExport BX boolexpr_Zdd_to_dnf(ZDD c_self) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    return new BoolExprProxy(self->manager()->to_dnf(*self));
+}
+
+DllExport BX boolexpr_Zdd_to_cnf(ZDD c_self) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    return new BoolExprProxy(self->manager()->to_cnf(*self));
+}
+
+DllExport STRING boolexpr_Zdd_count(ZDD c_self) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    auto str = self->manager()->count(*self).str();
+    auto c_str = new char[str.length() + 1];
+    std::strcpy(c_str, str.c_str());
+    return c_str;
+}
+
+DllExport size_t boolexpr_Zdd_size(ZDD c_self) {
+    auto self = reinterpret_cast<Zdd* const>(c_self);
+    return self->manager()->size(*self);
+}
+
+// Options for a limited solve; a null interrupt handle means none
+static SatOptions limited_options(uint32_t nthreads, uint32_t depth,
+                                  int64_t conflicts, int64_t propagations,
+                                  double seconds, SAT_INTERRUPT c_interrupt) {
+    auto options = SatOptions();
+    options.nthreads = nthreads;
+    options.cube_depth = depth;
+    options.conflict_limit = conflicts;
+    options.propagation_limit = propagations;
+    options.time_limit = seconds;
+    if (c_interrupt) {
+        options.interrupt =
+            *reinterpret_cast<shared_ptr<SatInterrupt>* const>(c_interrupt);
+    }
+    return options;
+}
+
+DllExport SAT_SESSION boolexpr_SatSession_new(uint32_t nthreads) {
+    auto options = SatOptions();
+    options.nthreads = nthreads;
+    return new SatSession(options);
+}
+
+DllExport void boolexpr_SatSession_del(SAT_SESSION c_self) {
+    auto self = reinterpret_cast<SatSession* const>(c_self);
+    delete self;
+}
+
+DllExport void boolexpr_SatSession_add(SAT_SESSION c_self, BX c_bxp) {
+    auto self = reinterpret_cast<SatSession* const>(c_self);
+    auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxp);
+    self->add(bxp->bx);
+}
+
+DllExport SOLN boolexpr_SatSession_solve(SAT_SESSION c_self, size_t n,
+                                         BXS c_lits) {
+    auto self = reinterpret_cast<SatSession* const>(c_self);
+    vector<lit_t> assumptions(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto litp = reinterpret_cast<BoolExprProxy const* const>(c_lits[i]);
+        assumptions[i] = static_pointer_cast<Literal const>(litp->bx);
+    }
+    return new SolnProxy(self->solve(assumptions));
+}
+
+DllExport ASSUMPTION_CACHE boolexpr_AssumptionCache_new(BX c_bxp) {
+    auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxp);
+    return new AssumptionCache(bxp->bx);
+}
+
+DllExport void boolexpr_AssumptionCache_del(ASSUMPTION_CACHE c_self) {
+    auto self = reinterpret_cast<AssumptionCache* const>(c_self);
+    delete self;
+}
+
+DllExport SOLN boolexpr_AssumptionCache_sat(ASSUMPTION_CACHE c_self, size_t n,
+                                            VARS c_varps, CONSTS c_constps) {
+    auto self = reinterpret_cast<AssumptionCache* const>(c_self);
+    auto point = point_t();
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        auto constp =
+            reinterpret_cast<BoolExprProxy const* const>(c_constps[i]);
+        auto var = static_pointer_cast<Variable const>(varp->bx);
+        auto const_ = static_pointer_cast<Constant const>(constp->bx);
+        point.insert({var, const_});
+    }
+    return new SolnProxy(self->sat(point));
+}
+
+DllExport bool boolexpr_AssumptionCache_equiv(ASSUMPTION_CACHE c_self,
+                                              BX c_other, size_t n,
+                                              VARS c_varps, CONSTS c_constps) {
+    auto self = reinterpret_cast<AssumptionCache* const>(c_self);
+    auto other = reinterpret_cast<BoolExprProxy const* const>(c_other);
+    auto point = point_t();
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        auto constp =
+            reinterpret_cast<BoolExprProxy const* const>(c_constps[i]);
+        auto var = static_pointer_cast<Variable const>(varp->bx);
+        auto const_ = static_pointer_cast<Constant const>(constp->bx);
+        point.insert({var, const_});
+    }
+    return self->equiv(other->bx, point);
+}
+
+DllExport bool boolexpr_serve_cubes(STRING c_address) {
+    return serve_cubes(string(c_address));
+}
+
+DllExport VEC boolexpr_unsat_core(size_t n, BXS c_bxps, bool minimal) {
+    vector<bx_t> constraints(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxps[i]);
+        constraints[i] = bxp->bx;
+    }
+    return new VecProxy<bx_t>(boolexpr::unsat_core(constraints, minimal));
+}
+
+DllExport void boolexpr_equiv_many(size_t n, BXS c_lhs, BXS c_rhs,
+                                   bool* c_results) {
+    vector<std::pair<bx_t, bx_t>> pairs(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto lhs = reinterpret_cast<BoolExprProxy const* const>(c_lhs[i]);
+        auto rhs = reinterpret_cast<BoolExprProxy const* const>(c_rhs[i]);
+        pairs[i] = std::make_pair(lhs->bx, rhs->bx);
+    }
+    auto results = boolexpr::equiv_many(pairs);
+    for (size_t i = 0; i < n; ++i) {
+        c_results[i] = results[i];
+    }
+}
+
+DllExport bool boolexpr_simulate(BX c_self, size_t n, VARS c_varps,
+                                size_t nwords, PATTERNS c_patterns,
+                                uint64_t* c_result) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto patterns = var2words_t();
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        auto var = static_pointer_cast<Variable const>(varp->bx);
+        patterns.insert({var, vector<uint64_t>(c_patterns + i * nwords,
+                                               c_patterns + (i + 1) * nwords)});
+    }
+    auto result = boolexpr::simulate(self->bx, patterns);
+    if (!result) {
+        return false;
+    }
+    // Without patterns, the expression is a constant
+    if (result->size() < nwords) {
+        result->assign(nwords, IS_ONE(self->bx->simplify()) ? ~uint64_t(0) : 0);
+    }
+    for (size_t k = 0; k < nwords; ++k) {
+        c_result[k] = (*result)[k];
+    }
+    return true;
+}
+
+DllExport VEC boolexpr_dfs_order(size_t n, BXS c_bxps) {
+    vector<bx_t> bxs(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxps[i]);
+        bxs[i] = bxp->bx;
+    }
+    auto xs = boolexpr::dfs_order(bxs);
+    return new VecProxy<bx_t>(vector<bx_t>(xs.begin(), xs.end()));
+}
+
+DllExport VEC boolexpr_force_order(size_t n, BXS c_bxps, uint32_t rounds) {
+    vector<bx_t> bxs(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxps[i]);
+        bxs[i] = bxp->bx;
+    }
+    auto xs = boolexpr::force_order(bxs, rounds);
+    return new VecProxy<bx_t>(vector<bx_t>(xs.begin(), xs.end()));
+}
+
 DllExport DFS_ITER boolexpr_DfsIter_new(BX c_bxp) {
     auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxp);
     return new DfsIterProxy(bxp->bx);
@@ -164,6 +741,17 @@ DllExport SAT_ITER boolexpr_SatIter_new(BX c_bxp) {
     return new SatIterProxy(bxp->bx);
 }
 
+DllExport SAT_ITER boolexpr_SatIter_new_projected(BX c_bxp, size_t n,
+                                                  VARS c_varps) {
+    auto bxp = reinterpret_cast<BoolExprProxy const* const>(c_bxp);
+    vector<var_t> vars(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        vars[i] = static_pointer_cast<Variable const>(varp->bx);
+    }
+    return new SatIterProxy(bxp->bx, vars);
+}
+
 DllExport void boolexpr_SatIter_del(SAT_ITER c_self) {
     auto self = reinterpret_cast<SatIterProxy* const>(c_self);
     delete self;
@@ -367,6 +955,93 @@ DllExport BX boolexpr_onehot(size_t n, BXS c_args) {
     return new BoolExprProxy(onehot(_convert_args(n, c_args)));
 }
 
+DllExport BX boolexpr_at_most_one(CONTEXT c_ctx, size_t n, BXS c_args,
+                                  uint8_t encoding, STRING c_auxvarname) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    string auxvarname{c_auxvarname};
+    return new BoolExprProxy(
+        at_most_one(*ctx, _convert_args(n, c_args),
+                    static_cast<AMOEncoding>(encoding), auxvarname));
+}
+
+DllExport BX boolexpr_exactly_one(CONTEXT c_ctx, size_t n, BXS c_args,
+                                  uint8_t encoding, STRING c_auxvarname) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    string auxvarname{c_auxvarname};
+    return new BoolExprProxy(
+        exactly_one(*ctx, _convert_args(n, c_args),
+                    static_cast<AMOEncoding>(encoding), auxvarname));
+}
+
+DllExport BX boolexpr_at_most_k(CONTEXT c_ctx, size_t n, BXS c_args, size_t k,
+                                uint8_t encoding, STRING c_auxvarname) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    string auxvarname{c_auxvarname};
+    return new BoolExprProxy(
+        at_most_k(*ctx, _convert_args(n, c_args), k,
+                  static_cast<CardEncoding>(encoding), auxvarname));
+}
+
+DllExport BX boolexpr_at_least_k(CONTEXT c_ctx, size_t n, BXS c_args, size_t k,
+                                 uint8_t encoding, STRING c_auxvarname) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    string auxvarname{c_auxvarname};
+    return new BoolExprProxy(
+        at_least_k(*ctx, _convert_args(n, c_args), k,
+                   static_cast<CardEncoding>(encoding), auxvarname));
+}
+
+DllExport BX boolexpr_exactly_k(CONTEXT c_ctx, size_t n, BXS c_args, size_t k,
+                                uint8_t encoding, STRING c_auxvarname) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    string auxvarname{c_auxvarname};
+    return new BoolExprProxy(
+        exactly_k(*ctx, _convert_args(n, c_args), k,
+                  static_cast<CardEncoding>(encoding), auxvarname));
+}
+
+DllExport BX boolexpr_pb_leq(CONTEXT c_ctx, size_t n, BXS c_args,
+                             WEIGHTS c_weights, int64_t k, uint8_t encoding,
+                             STRING c_auxvarname) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    vector<int64_t> weights(c_weights, c_weights + n);
+    string auxvarname{c_auxvarname};
+    auto f = pb_leq(*ctx, _convert_args(n, c_args), weights, k,
+                    static_cast<PBEncoding>(encoding), auxvarname);
+    if (!f) {
+        return nullptr;
+    }
+    return new BoolExprProxy(*f);
+}
+
+DllExport BX boolexpr_pb_geq(CONTEXT c_ctx, size_t n, BXS c_args,
+                             WEIGHTS c_weights, int64_t k, uint8_t encoding,
+                             STRING c_auxvarname) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    vector<int64_t> weights(c_weights, c_weights + n);
+    string auxvarname{c_auxvarname};
+    auto f = pb_geq(*ctx, _convert_args(n, c_args), weights, k,
+                    static_cast<PBEncoding>(encoding), auxvarname);
+    if (!f) {
+        return nullptr;
+    }
+    return new BoolExprProxy(*f);
+}
+
+DllExport BX boolexpr_pb_eq(CONTEXT c_ctx, size_t n, BXS c_args,
+                            WEIGHTS c_weights, int64_t k, uint8_t encoding,
+                            STRING c_auxvarname) {
+    auto ctx = reinterpret_cast<Context* const>(c_ctx);
+    vector<int64_t> weights(c_weights, c_weights + n);
+    string auxvarname{c_auxvarname};
+    auto f = pb_eq(*ctx, _convert_args(n, c_args), weights, k,
+                   static_cast<PBEncoding>(encoding), auxvarname);
+    if (!f) {
+        return nullptr;
+    }
+    return new BoolExprProxy(*f);
+}
+
 DllExport BX boolexpr_nor_s(size_t n, BXS c_args) {
     return new BoolExprProxy(nor_s(_convert_args(n, c_args)));
 }
@@ -533,6 +1208,58 @@ DllExport SOLN boolexpr_BoolExpr_sat(BX c_self) {
     return new SolnProxy(self->bx->sat());
 }
 
+DllExport SOLN boolexpr_BoolExpr_sat_portfolio(BX c_self, uint32_t nthreads) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto options = SatOptions();
+    options.nthreads = nthreads;
+    return new SolnProxy(self->bx->sat(options));
+}
+
+DllExport SOLN boolexpr_BoolExpr_sat_cubes(BX c_self, uint32_t nthreads,
+                                           uint32_t depth) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto options = SatOptions();
+    options.nthreads = nthreads;
+    options.cube_depth = depth;
+    return new SolnProxy(self->bx->sat(options));
+}
+
+DllExport SOLN boolexpr_BoolExpr_sat_remote(BX c_self, size_t n,
+                                            STRINGS c_addresses,
+                                            uint32_t depth) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto addresses = vector<string>(c_addresses, c_addresses + n);
+    auto options = SatOptions();
+    options.cube_depth = depth;
+    return new SolnProxy(remote_sat(self->bx, addresses, options));
+}
+
+DllExport SOLN boolexpr_BoolExpr_sat_limited(BX c_self, uint32_t nthreads,
+                                             uint32_t depth, int64_t conflicts,
+                                             int64_t propagations,
+                                             double seconds,
+                                             SAT_INTERRUPT c_interrupt) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto options = limited_options(nthreads, depth, conflicts, propagations,
+                                   seconds, c_interrupt);
+    return new SolnProxy(self->bx->sat_limited(options));
+}
+
+DllExport SOLN boolexpr_BoolExpr_sat_assuming(BX c_self, size_t n,
+                                              VARS c_varps, CONSTS c_constps) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto point = point_t();
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        auto constp =
+            reinterpret_cast<BoolExprProxy const* const>(c_constps[i]);
+        auto var = static_pointer_cast<Variable const>(varp->bx);
+        auto const_ = static_pointer_cast<Constant const>(constp->bx);
+        point.insert({var, const_});
+    }
+    return new SolnProxy(self->bx->sat(point));
+}
+
 DllExport BX boolexpr_BoolExpr_to_cnf(BX c_self) {
     auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
     return new BoolExprProxy(self->bx->to_cnf());
@@ -554,6 +1281,53 @@ DllExport bool boolexpr_BoolExpr_equiv(BX c_self, BX c_other) {
     return self->bx->equiv(other->bx);
 }
 
+DllExport uint8_t boolexpr_BoolExpr_equiv_limited(
+    BX c_self, BX c_other, uint32_t nthreads, int64_t conflicts,
+    int64_t propagations, double seconds, SAT_INTERRUPT c_interrupt) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto other = reinterpret_cast<BoolExprProxy const* const>(c_other);
+    auto options = limited_options(nthreads, 0, conflicts, propagations,
+                                   seconds, c_interrupt);
+    auto result = self->bx->equiv_limited(other->bx, options);
+    // Same values as SatStatus: false, true, unknown
+    return result ? static_cast<uint8_t>(*result) : 2;
+}
+
+DllExport bool boolexpr_BoolExpr_equiv_assuming(BX c_self, BX c_other,
+                                                size_t n, VARS c_varps,
+                                                CONSTS c_constps) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto other = reinterpret_cast<BoolExprProxy const* const>(c_other);
+    auto point = point_t();
+    for (size_t i = 0; i < n; ++i) {
+        auto varp = reinterpret_cast<BoolExprProxy const* const>(c_varps[i]);
+        auto constp =
+            reinterpret_cast<BoolExprProxy const* const>(c_constps[i]);
+        auto var = static_pointer_cast<Variable const>(varp->bx);
+        auto const_ = static_pointer_cast<Constant const>(constp->bx);
+        point.insert({var, const_});
+    }
+    return self->bx->equiv(other->bx, point);
+}
+
+DllExport STRING boolexpr_BoolExpr_count_sat(BX c_self) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto str = self->bx->count_sat().str();
+    auto c_str = new char[str.length() + 1];
+    std::strcpy(c_str, str.c_str());
+    return c_str;
+}
+
+DllExport STRING boolexpr_BoolExpr_approx_count_sat(BX c_self, double epsilon,
+                                                    double delta,
+                                                    uint32_t seed) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto str = self->bx->approx_count_sat(epsilon, delta, seed).str();
+    auto c_str = new char[str.length() + 1];
+    std::strcpy(c_str, str.c_str());
+    return c_str;
+}
+
 DllExport VARSET boolexpr_BoolExpr_support(BX c_self) {
     auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
     return new SetProxy<var_t>(self->bx->support());
@@ -608,6 +1382,21 @@ DllExport BX boolexpr_BoolExpr_derivative(BX c_self, size_t n, VARS c_varps) {
     return new BoolExprProxy(self->bx->derivative(vars));
 }
 
+DllExport bool boolexpr_BoolExpr_npn_class(BX c_self, uint32_t* c_nvars,
+                                           uint64_t* c_words) {
+    auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
+    auto tt = self->bx->npn_class();
+    if (!tt) {
+        return false;
+    }
+    auto const& words = tt->words();
+    for (size_t k = 0; k < words.size(); ++k) {
+        c_words[k] = words[k];
+    }
+    *c_nvars = tt->nvars();
+    return true;
+}
+
 DllExport CONTEXT boolexpr_Literal_ctx(BX c_self) {
     auto self = reinterpret_cast<BoolExprProxy const* const>(c_self);
     auto lit = static_pointer_cast<Literal const>(self->bx);
@@ -20,14 +20,17 @@
 #ifndef BOOLEXPR_BXCFFI_H_
 #define BOOLEXPR_BXCFFI_H_
 
+using boolexpr::bdd_sat_iter;
 using boolexpr::bx_t;
 using boolexpr::cf_iter;
 using boolexpr::const_t;
 using boolexpr::dfs_iter;
 using boolexpr::domain_iter;
+using boolexpr::limited_soln_t;
 using boolexpr::lit_t;
 using boolexpr::points_iter;
 using boolexpr::sat_iter;
+using boolexpr::SatStatus;
 using boolexpr::soln_t;
 using boolexpr::terms_iter;
 using boolexpr::var_t;
@@ -96,8 +99,14 @@ struct MapProxy {
 
 struct SolnProxy {
     soln_t soln;
+    SatStatus status;
 
-    SolnProxy(soln_t const&& soln) : soln{soln} {}
+    SolnProxy(soln_t const&& soln)
+        : soln{soln}, status{soln.first ? SatStatus::SAT : SatStatus::UNSAT} {}
+
+    SolnProxy(limited_soln_t const&& soln)
+        : soln{soln.first == SatStatus::SAT, soln.second},
+          status{soln.first} {}
 };
 
 struct DfsIterProxy {
@@ -116,6 +125,7 @@ struct SatIterProxy {
     sat_iter it;
 
     SatIterProxy(bx_t const& bx) : it{sat_iter(bx)} {}
+    SatIterProxy(bx_t const& bx, std::vector<var_t> const& xs) : it(bx, xs) {}
 
     void next() { ++it; }
 
@@ -124,6 +134,19 @@ struct SatIterProxy {
     }
 };
 
+struct BddSatIterProxy {
+    bdd_sat_iter it;
+
+    BddSatIterProxy(boolexpr::Bdd const& f) : it{f} {}
+
+    void next() { ++it; }
+
+    MapProxy<var_t, const_t>* val() const {
+        return (it == bdd_sat_iter()) ? nullptr
+                                      : new MapProxy<var_t, const_t>(*it);
+    }
+};
+
 struct PointsIterProxy {
     points_iter it;
 
@@ -0,0 +1,192 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+using boost::multiprecision::cpp_int;
+
+class BddTest : public BoolExprTest {};
+
+TEST_F(BddTest, Canonical) {
+    BddManager mgr(ctx);
+
+    auto a = mgr.var(xs[0]);
+    auto b = mgr.var(xs[1]);
+    auto c = mgr.var(xs[2]);
+
+    EXPECT_TRUE(mgr.zero().is_zero());
+    EXPECT_TRUE(mgr.one().is_one());
+    EXPECT_EQ(~mgr.zero(), mgr.one());
+
+    EXPECT_EQ((a & b) | (a & c), a & (b | c));
+    EXPECT_EQ(~(a & b), ~a | ~b);
+    EXPECT_EQ(~~a, a);
+    EXPECT_EQ(a ^ b ^ a, b);
+    EXPECT_TRUE((a ^ a).is_zero());
+    EXPECT_TRUE((a | ~a).is_one());
+    EXPECT_NE(a & b, a | b);
+
+    EXPECT_EQ(mgr.ite(a, b, c), (a & b) | (~a & c));
+    EXPECT_EQ(mgr.ite(a, ~b, b), a ^ b);
+
+    // One node per variable, and the terminal
+    EXPECT_EQ(mgr.size(a ^ b ^ c), 4u);
+    EXPECT_EQ(mgr.size(mgr.one()), 1u);
+}
+
+TEST_F(BddTest, ToFromBdd) {
+    BddManager mgr(ctx);
+
+    vector<bx_t> fs = {
+        _zero,
+        _one,
+        ~xs[3],
+        or_({xs[0], and_({xs[1], ~xs[2]}), xor_({xs[3], xs[4]})}),
+        nor({xs[0], xs[1], xs[2]}),
+        nand({xs[0], ~xs[1]}),
+        xnor({xs[0], xs[1], xs[2], xs[3]}),
+        eq({xs[0], xs[1], xs[2]}),
+        neq({xs[0], xs[1], xs[2]}),
+        impl(xs[0], xs[1]),
+        nimpl(xs[0], xs[1]),
+        ite(xs[0], and_({xs[1], xs[2]}), or_({xs[3], xs[4]})),
+        nite(xs[0], xs[1], xs[2]),
+    };
+
+    for (auto const &f : fs) {
+        auto bdd = mgr.to_bdd(f);
+        auto g = mgr.from_bdd(bdd);
+        EXPECT_TRUE(g->equiv(f));
+        EXPECT_EQ(mgr.to_bdd(g), bdd);
+    }
+}
+
+TEST_F(BddTest, Order) {
+    BddManager mgr(ctx);
+
+    mgr.to_bdd(and_({xs[5], xs[2], xs[7]}));
+    mgr.to_bdd(or_({xs[1], xs[2]}));
+
+    vector<var_t> expected = {xs[2], xs[5], xs[7], xs[1]};
+    EXPECT_EQ(mgr.order(), expected);
+
+    auto f = mgr.to_bdd(xor_({xs[1], xs[7]}));
+    expected = {xs[7], xs[1]};
+    EXPECT_EQ(mgr.support(f), expected);
+}
+
+TEST_F(BddTest, Restrict) {
+    BddManager mgr(ctx);
+
+    auto f = or_({and_({xs[0], xs[1]}), and_({~xs[1], xs[2]}),
+                  xor_({xs[2], xs[3]})});
+    auto bdd = mgr.to_bdd(f);
+
+    vector<point_t> points = {
+        {},
+        {{xs[0], _zero}},
+        {{xs[1], _one}},
+        {{xs[1], _zero}, {xs[3], _one}},
+        {{xs[0], _one}, {xs[2], _zero}, {xs[9], _one}},
+    };
+
+    for (auto const &point : points) {
+        EXPECT_EQ(mgr.restrict_(bdd, point), mgr.to_bdd(f->restrict_(point)));
+    }
+}
+
+TEST_F(BddTest, Quantify) {
+    BddManager mgr(ctx);
+
+    auto f = or_({and_({xs[0], xs[1]}), and_({~xs[1], xs[2]}),
+                  xor_({xs[2], xs[3]})});
+    auto bdd = mgr.to_bdd(f);
+
+    vector<vector<var_t>> xss = {
+        {}, {xs[0]}, {xs[1], xs[3]}, {xs[3], xs[1], xs[9]}, {xs[0], xs[2]},
+    };
+
+    for (auto const &vs : xss) {
+        EXPECT_EQ(mgr.exists(bdd, vs), mgr.to_bdd(f->smoothing(vs)));
+        EXPECT_EQ(mgr.forall(bdd, vs), mgr.to_bdd(f->consensus(vs)));
+    }
+}
+
+TEST_F(BddTest, SatCount) {
+    BddManager mgr(ctx);
+
+    EXPECT_EQ(mgr.sat_count(mgr.zero()), 0);
+    EXPECT_EQ(mgr.sat_count(mgr.one()), 1);
+
+    auto f = or_({and_({xs[0], xs[1]}), and_({~xs[1], xs[2]}),
+                  xor_({xs[2], xs[3]}), and_({xs[4], ~xs[5]})});
+    EXPECT_EQ(mgr.sat_count(mgr.to_bdd(f)), f->count_sat());
+    EXPECT_EQ(mgr.sat_count(mgr.to_bdd(~f)), (~f)->count_sat());
+
+    // Far beyond what enumeration could count
+    vector<bx_t> args(xs.begin(), xs.begin() + 100);
+    auto parity = mgr.to_bdd(xor_(args));
+    EXPECT_EQ(mgr.sat_count(parity), cpp_int(1) << 99);
+    EXPECT_EQ(mgr.size(parity), 101u);
+}
+
+TEST_F(BddTest, IterSat) {
+    BddManager mgr(ctx);
+
+    auto f = or_({and_({xs[0], xs[1]}), and_({~xs[1], xs[2]}),
+                  xor_({xs[2], xs[3]})});
+    auto bdd = mgr.to_bdd(f);
+
+    cpp_int n = 0;
+    for (auto it = bdd_sat_iter(bdd); it != bdd_sat_iter(); ++it) {
+        EXPECT_EQ((*it).size(), 4u);
+        EXPECT_TRUE(IS_ONE(f->restrict_(*it)));
+        ++n;
+    }
+    EXPECT_EQ(n, mgr.sat_count(bdd));
+
+    EXPECT_TRUE(bdd_sat_iter(mgr.zero()) == bdd_sat_iter());
+
+    n = 0;
+    for (auto it = bdd_sat_iter(mgr.one()); it != bdd_sat_iter(); ++it) {
+        EXPECT_TRUE((*it).empty());
+        ++n;
+    }
+    EXPECT_EQ(n, 1);
+}
+
+TEST_F(BddTest, GarbageCollection) {
+    BddManager mgr(ctx);
+
+    auto f = mgr.to_bdd(xor_({xs[0], xs[1], xs[2], xs[3]}));
+    {
+        vector<bx_t> args(xs.begin(), xs.begin() + 64);
+        auto g = mgr.to_bdd(and_(args)) | mgr.to_bdd(or_(args));
+        EXPECT_GT(mgr.nodes(), mgr.size(f) - 1);
+    }
+    mgr.gc();
+
+    // Only the nodes of f survive
+    EXPECT_EQ(mgr.nodes(), mgr.size(f) - 1);
+    EXPECT_EQ(f, mgr.to_bdd(xor_({xs[3], xs[2], xs[1], xs[0]})));
+
+    // Freed nodes are reused
+    auto g = f & mgr.var(xs[4]);
+    EXPECT_EQ(mgr.sat_count(g), 8);
+    f = mgr.zero();
+    mgr.gc();
+    EXPECT_EQ(mgr.nodes(), mgr.size(g) - 1);
+}
@@ -0,0 +1,101 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class BddPoolTest : public BoolExprTest {
+protected:
+    // x[0] & y[0] | ... | x[n-1] & y[n-1], where x[i] = xs[i] and
+    // y[i] = xs[n+i]. Its BDD is exponential in id order.
+    bx_t pairs(size_t n) {
+        vector<bx_t> terms;
+        for (size_t i = 0; i < n; ++i) {
+            terms.push_back(and_({xs[i], xs[n + i]}));
+        }
+        return or_(terms);
+    }
+};
+
+TEST_F(BddPoolTest, Agrees) {
+    BddManager seq(ctx);
+    BddManager par(ctx, 4);
+
+    vector<bx_t> fs = {
+        or_({xs[0], and_({xs[1], ~xs[2]}), xor_({xs[3], xs[4]})}),
+        xnor({xs[0], xs[1], xs[2], xs[3], xs[4], xs[5]}),
+        eq({xs[2], xs[3], xs[4]}),
+        ite(xs[0], and_({xs[1], xs[2]}), or_({xs[3], xs[4]})),
+        impl(xs[5], nand({xs[0], xs[4]})),
+        pairs(4),
+    };
+
+    for (auto const &f : fs) {
+        for (auto const &g : fs) {
+            auto a = seq.to_bdd(f);
+            auto b = seq.to_bdd(g);
+            auto c = par.to_bdd(f);
+            auto d = par.to_bdd(g);
+
+            vector<Bdd> xs1 = {a & b, a | b, a ^ b, seq.ite(a, b, ~a),
+                               seq.exists(a & b, {xs[0], xs[3]}),
+                               seq.forall(a | b, {xs[1], xs[4]})};
+            vector<Bdd> xs2 = {c & d, c | d, c ^ d, par.ite(c, d, ~c),
+                               par.exists(c & d, {xs[0], xs[3]}),
+                               par.forall(c | d, {xs[1], xs[4]})};
+
+            for (size_t i = 0; i < xs1.size(); ++i) {
+                EXPECT_EQ(par.size(xs2[i]), seq.size(xs1[i]));
+                EXPECT_EQ(par.sat_count(xs2[i]), seq.sat_count(xs1[i]));
+                EXPECT_TRUE(par.from_bdd(xs2[i])->equiv(seq.from_bdd(xs1[i])));
+            }
+        }
+    }
+}
+
+TEST_F(BddPoolTest, Grow) {
+    BddManager seq(ctx);
+    BddManager par(ctx, 4);
+
+    // About 2^17 nodes, so the slots run out and the chains get long
+    auto f = pairs(16);
+    auto a = seq.to_bdd(f);
+    auto b = par.to_bdd(f);
+
+    EXPECT_EQ(par.size(b), seq.size(a));
+    par.gc();
+    EXPECT_EQ(par.nodes(), par.size(b) - 1);
+    EXPECT_EQ(par.sat_count(b), seq.sat_count(a));
+
+    // The retries left every node in its unique table
+    EXPECT_EQ(par.to_bdd(f), b);
+    auto g = par.exists(b, {xs[15], xs[31]});
+    EXPECT_EQ(par.sat_count(g), seq.sat_count(seq.exists(a, {xs[15], xs[31]})));
+}
+
+TEST_F(BddPoolTest, GarbageCollection) {
+    BddManager par(ctx, 2);
+    par.set_auto_reorder(BddReorder::SIFT);
+
+    auto bdd = par.zero();
+    for (size_t i = 0; i < 12; ++i) {
+        bdd = bdd | (par.var(xs[i]) & par.var(xs[12 + i]));
+    }
+    par.gc();
+
+    EXPECT_EQ(par.nodes(), par.size(bdd) - 1);
+    EXPECT_EQ(bdd, par.to_bdd(pairs(12)));
+    EXPECT_EQ(par.sat_count(bdd), pairs(12)->count_sat());
+}
@@ -148,3 +148,24 @@ TEST(CFFI, Basic) {
 
     boolexpr_Context_del(ctx);
 }
+
+TEST(CFFI, Simulate) {
+    auto ctx = boolexpr_Context_new();
+    auto a = boolexpr_Context_get_var(ctx, "a");
+    auto b = boolexpr_Context_get_var(ctx, "b");
+    void const* args[] = {a, b};
+    auto y = boolexpr_or(2, args);
+
+    uint64_t patterns[] = {0x3, 0x5};
+    uint64_t result = 0;
+    EXPECT_TRUE(boolexpr_simulate(y, 2, args, 1, patterns, &result));
+    EXPECT_EQ(result, 0x7u);
+
+    // Every variable in the support needs a pattern
+    EXPECT_FALSE(boolexpr_simulate(y, 1, args, 1, patterns, &result));
+
+    boolexpr_BoolExpr_del(a);
+    boolexpr_BoolExpr_del(b);
+    boolexpr_BoolExpr_del(y);
+    boolexpr_Context_del(ctx);
+}
@@ -0,0 +1,94 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <functional>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class CardTest : public BoolExprTest {
+protected:
+    // Check f against pred(count) for every point of xs[0..n)
+    void check(bx_t const &f, size_t n, std::function<bool(size_t)> pred) {
+        EXPECT_TRUE(f->is_cnf() || IS_CONST(f));
+        for (size_t i = 0; i < (1u << n); ++i) {
+            point_t point;
+            size_t count = 0;
+            for (size_t j = 0; j < n; ++j) {
+                bool val = (i >> j) & 1u;
+                if (val) {
+                    point.insert({xs[j], one()});
+                } else {
+                    point.insert({xs[j], zero()});
+                }
+                count += val;
+            }
+            EXPECT_EQ(f->restrict_(point)->sat().first, pred(count));
+        }
+    }
+};
+
+TEST_F(CardTest, AtMostOne) {
+    auto encodings = {AMOEncoding::PAIRWISE, AMOEncoding::SEQCOUNTER,
+                      AMOEncoding::COMMANDER, AMOEncoding::PRODUCT};
+
+    for (size_t n = 1; n <= 7; ++n) {
+        vector<bx_t> args(xs.begin(), xs.begin() + n);
+        for (auto encoding : encodings) {
+            check(at_most_one(ctx, args, encoding), n,
+                  [](size_t c) { return c <= 1; });
+            check(exactly_one(ctx, args, encoding), n,
+                  [](size_t c) { return c == 1; });
+        }
+    }
+}
+
+TEST_F(CardTest, AtMostK) {
+    auto encodings = {CardEncoding::SEQCOUNTER, CardEncoding::TOTALIZER,
+                      CardEncoding::SORTNET};
+
+    size_t const n = 6;
+    vector<bx_t> args(xs.begin(), xs.begin() + n);
+    for (auto encoding : encodings) {
+        for (size_t k = 0; k <= n + 1; ++k) {
+            check(at_most_k(ctx, args, k, encoding), n,
+                  [k](size_t c) { return c <= k; });
+            check(at_least_k(ctx, args, k, encoding), n,
+                  [k](size_t c) { return c >= k; });
+            check(exactly_k(ctx, args, k, encoding), n,
+                  [k](size_t c) { return c == k; });
+        }
+    }
+}
+
+TEST_F(CardTest, Scaling) {
+    vector<bx_t> args(xs.begin(), xs.begin() + 1000);
+
+    auto f = at_most_one(ctx, args, AMOEncoding::PRODUCT);
+    EXPECT_LT(f->size(), 10u * 1000 * 3);
+
+    auto g = exactly_k(ctx, args, 10, CardEncoding::TOTALIZER);
+    EXPECT_TRUE(g->is_cnf());
+
+    // Auxiliary variables do not appear in solutions
+    auto soln = g->sat();
+    EXPECT_TRUE(soln.first);
+    size_t count = 0;
+    for (auto const &pair : *soln.second) {
+        EXPECT_FALSE(ctx.is_anon(pair.first->id));
+        count += IS_ONE(pair.second);
+    }
+    EXPECT_EQ(count, 10u);
+}
@@ -0,0 +1,74 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class CnfTest : public BoolExprTest {};
+
+TEST_F(CnfTest, Basic) {
+    auto cnf = Cnf();
+
+    EXPECT_EQ(cnf.nvars, 0u);
+    EXPECT_EQ(cnf.nclauses(), 0u);
+
+    auto a = cnf.new_var();
+    auto b = cnf.new_var();
+    cnf.add_clause({a, -b});
+    cnf.add_clause({b});
+
+    EXPECT_EQ(cnf.nvars, 2);
+    EXPECT_EQ(cnf.nclauses(), 2);
+    EXPECT_EQ(cnf.lits, (vector<int32_t>{1, -2, 2}));
+    EXPECT_EQ(cnf.offsets, (vector<uint32_t>{0, 2, 3}));
+}
+
+TEST_F(CnfTest, Encoder) {
+    // A CNF input maps to clauses one for one, without auxiliaries
+    auto enc0 = CnfEncoder();
+    enc0.add(onehot({xs[0], xs[1], xs[2]}));
+    EXPECT_EQ(enc0.cnf.nvars, 3);
+    EXPECT_EQ(enc0.cnf.nclauses(), 4);
+
+    // Shared subexpressions are encoded once
+    auto y = xs[0] & xs[1];
+    auto enc1 = CnfEncoder();
+    enc1.add(or_({y, xs[2]}));
+    enc1.add(or_({y, xs[3]}));
+    EXPECT_EQ(enc1.cnf.nvars, 5);
+    EXPECT_EQ(enc1.cnf.nclauses(), 5);
+
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(enc1.idx2var[enc1.encode(xs[i])], xs[i]);
+        EXPECT_EQ(enc1.encode(~xs[i]), -enc1.encode(xs[i]));
+    }
+    EXPECT_EQ(enc1.idx2var[enc1.encode(y)], nullptr);
+}
+
+TEST_F(CnfTest, Xor) {
+    // Linear encoding: one auxiliary per binary XOR
+    vector<bx_t> args(xs.begin(), xs.begin() + 64);
+    auto enc = CnfEncoder();
+    enc.add(xor_(args));
+    EXPECT_EQ(enc.cnf.nvars, 64 + 63);
+
+    auto soln = xor_(args)->sat();
+    EXPECT_TRUE(soln.first);
+    size_t count = 0;
+    for (auto const &pair : *soln.second) {
+        count += IS_ONE(pair.second);
+    }
+    EXPECT_EQ(count % 2, 1);
+}
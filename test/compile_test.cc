@@ -0,0 +1,120 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class CompileTest : public BoolExprTest {
+protected:
+    // Return the value of an expression at a dense point
+    bool expected(CompiledExpr const& prog, bx_t const& f,
+                  vector<uint64_t> const& point) {
+        point_t p;
+        for (size_t i = 0; i < prog.inputs().size(); ++i) {
+            if ((point[i / 64] >> (i % 64)) & 1) {
+                p.insert({prog.inputs()[i], _one});
+            } else {
+                p.insert({prog.inputs()[i], _zero});
+            }
+        }
+        return IS_ONE(f->restrict_(p)->simplify());
+    }
+};
+
+TEST_F(CompileTest, Eval) {
+    auto a = xs[0], b = xs[1], c = xs[2], d = xs[3], e = xs[4];
+
+    vector<bx_t> fs = {
+        or_({a, ~b, c}),
+        nor({a, ~b, c}),
+        and_({~a, b, c}),
+        nand({~a, b, c}),
+        xor_({a, b, ~c}),
+        xnor({a, b, ~c}),
+        eq({a, ~b, c}),
+        neq({a, ~b, c}),
+        impl(a, b & c),
+        nimpl(a, b & c),
+        ite(a, b | d, c ^ e),
+        nite(a, b | d, c ^ e),
+        onehot({a, b, c, d, e}) | (a & b & _one) | (c & _zero),
+    };
+
+    for (auto const& f : fs) {
+        auto prog = compile(f);
+        ASSERT_TRUE(prog.okay());
+        ASSERT_EQ(prog.inputs().size(), f->support().size());
+        ASSERT_EQ(prog.stride(), 1u);
+
+        auto n = 1u << prog.inputs().size();
+        for (uint64_t j = 0; j < n; ++j) {
+            vector<uint64_t> point = {j};
+            EXPECT_EQ(prog.eval(point.data()), expected(prog, f, point));
+        }
+    }
+}
+
+TEST_F(CompileTest, Batch) {
+    // Wider than one word, and more points than one pass holds
+    vector<bx_t> args;
+    for (size_t i = 0; i < 70; ++i) {
+        args.push_back(xs[i]);
+    }
+    auto f = xor_(args) | (xs[0] & xs[69]);
+    auto prog = compile(f);
+    ASSERT_EQ(prog.stride(), 2u);
+
+    size_t n = 600;
+    vector<uint64_t> points(2 * n);
+    uint64_t state = 1;
+    for (auto& word : points) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        word = state;
+    }
+    vector<uint64_t> results((n + 63) / 64, ~uint64_t(0));
+    prog.eval(points.data(), n, results.data());
+
+    for (size_t j = 0; j < n; ++j) {
+        vector<uint64_t> point(&points[2 * j], &points[2 * j + 2]);
+        auto val = (results[j / 64] >> (j % 64)) & 1;
+        EXPECT_EQ(val, prog.eval(point.data()));
+        EXPECT_EQ(val, expected(prog, f, point));
+    }
+    // Bits past the last point are clear
+    EXPECT_EQ(results.back() >> (n % 64), 0u);
+}
+
+TEST_F(CompileTest, Constants) {
+    auto prog = compile(or_({_zero, _one}));
+    EXPECT_EQ(prog.inputs().size(), 0u);
+    EXPECT_TRUE(prog.eval(nullptr));
+
+    uint64_t results[2];
+    prog.eval(nullptr, 100, results);
+    EXPECT_EQ(results[0], ~uint64_t(0));
+    EXPECT_EQ(results[1], (uint64_t(1) << 36) - 1);
+}
+
+TEST_F(CompileTest, Unknown) {
+    auto prog = compile(xs[0] | _log);
+    EXPECT_FALSE(prog.okay());
+
+    uint64_t point = 1;
+    EXPECT_FALSE(prog.eval(&point));
+    uint64_t results[2] = {1, 1};
+    prog.eval(&point, 65, results);
+    EXPECT_EQ(results[0], 0u);
+    EXPECT_EQ(results[1], 0u);
+}
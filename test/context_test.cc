@@ -0,0 +1,74 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class ContextTest : public BoolExprTest {};
+
+TEST_F(ContextTest, AnonVars) {
+    auto ctx = Context();
+
+    auto a = ctx.get_var("a");
+    auto a0 = ctx.get_anon_var();
+    auto a1 = ctx.get_anon_var();
+    auto b0 = ctx.get_anon_var("b");
+    auto a2 = ctx.get_anon_var();
+
+    EXPECT_FALSE(ctx.is_anon(a->id));
+    EXPECT_TRUE(ctx.is_anon(a0->id));
+    EXPECT_NE(a0, a1);
+
+    EXPECT_EQ(a0->to_string(), "a_0");
+    EXPECT_EQ((~a1)->to_string(), "~a_1");
+    EXPECT_EQ(b0->to_string(), "b_0");
+    EXPECT_EQ(a2->to_string(), "a_2");
+}
+
+TEST_F(ContextTest, Scopes) {
+    auto ctx = Context();
+
+    auto a = ctx.get_var("a");
+    auto b = ctx.get_var("b");
+    auto f = (a & b) | (~a & ~b);
+
+    ctx.push_scope();
+    {
+        auto cnf = f->tseytin(ctx);
+        EXPECT_TRUE(cnf->is_cnf());
+        EXPECT_EQ(ctx.get_var("c")->to_string(), "c");
+    }
+    EXPECT_TRUE(ctx.pop_scope());
+
+    // Reclaimed ids and names are reused
+    auto c = ctx.get_var("c");
+    EXPECT_EQ(c->id, b->id + 2);
+    EXPECT_EQ(ctx.get_anon_var()->to_string(), "a_0");
+
+    // Referenced variables keep the scope open, so the caller can retry
+    ctx.push_scope();
+    auto cnf = f->tseytin(ctx);
+    EXPECT_FALSE(ctx.pop_scope());
+    EXPECT_EQ(ctx.num_scopes(), 1u);
+    cnf.reset();
+    EXPECT_TRUE(ctx.pop_scope());
+    EXPECT_EQ(ctx.num_scopes(), 0u);
+
+    EXPECT_EQ(ctx.get_var("c"), c);
+    EXPECT_EQ(ctx.get_anon_var()->to_string(), "a_1");
+
+    // No open scope
+    EXPECT_FALSE(ctx.pop_scope());
+}
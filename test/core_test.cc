@@ -0,0 +1,63 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class CoreTest : public BoolExprTest {};
+
+TEST_F(CoreTest, Sat) {
+    EXPECT_TRUE(unsat_core({}).empty());
+    EXPECT_TRUE(unsat_core({xs[0] | xs[1], ~xs[0], _one}).empty());
+    EXPECT_TRUE(unsat_core({xs[0] | xs[1], ~xs[0]}, true).empty());
+}
+
+TEST_F(CoreTest, Core) {
+    vector<bx_t> cs = {xs[0] | xs[1], xs[2], ~xs[0], xs[3] | xs[4], ~xs[1]};
+
+    auto core = unsat_core(cs);
+    EXPECT_FALSE(core.empty());
+    EXPECT_FALSE(and_(core)->sat().first);
+}
+
+TEST_F(CoreTest, Minimal) {
+    vector<bx_t> cs = {xs[0] | xs[1], xs[2],        ~xs[0],
+                       xs[3] | xs[4], ~xs[1],       ~xs[2] | xs[5],
+                       ~xs[5] | xs[0], xs[6] & xs[7]};
+
+    auto mus = unsat_core(cs, true);
+    EXPECT_FALSE(and_(mus)->sat().first);
+
+    // Every constraint in a MUS is necessary
+    for (size_t i = 0; i < mus.size(); ++i) {
+        auto rest = mus;
+        rest.erase(rest.begin() + i);
+        EXPECT_TRUE(and_(rest)->sat().first);
+    }
+
+    // Either {0, 2, 4} or {1, 2, 5, 6}
+    EXPECT_TRUE(mus.size() == 3 || mus.size() == 4);
+}
+
+TEST_F(CoreTest, Constants) {
+    auto core = unsat_core({xs[0], _zero, xs[1]}, true);
+    ASSERT_EQ(core.size(), 1u);
+    EXPECT_EQ(core[0], _zero);
+
+    // A constraint that conflicts with itself
+    core = unsat_core({xs[0] | xs[1], xs[2] & ~xs[2]}, true);
+    ASSERT_EQ(core.size(), 1u);
+    EXPECT_TRUE(core[0]->equiv(_zero));
+}
@@ -0,0 +1,85 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class CubeTest : public BoolExprTest {
+protected:
+    SatOptions options;
+
+    virtual void SetUp() {
+        BoolExprTest::SetUp();
+        options.nthreads = 3;
+        options.cube_depth = 3;
+    }
+};
+
+TEST_F(CubeTest, Sat) {
+    auto f = onehot({xs[0], xs[1], xs[2], xs[3], xs[4]}) & (xs[3] | xs[4]);
+    auto soln = f->sat(options);
+    EXPECT_TRUE(soln.first);
+    EXPECT_TRUE(f->restrict_(*soln.second)->simplify()->equiv(one()));
+
+    // Atoms do not need a solver
+    EXPECT_TRUE(xs[0]->sat(options).first);
+    EXPECT_FALSE(_zero->sat(options).first);
+}
+
+TEST_F(CubeTest, Unsat) {
+    auto f = xor_({xs[0], xs[1], xs[2], xs[3], xs[4], xs[5]}) &
+             ~xor_({xs[0], xs[1], xs[2]}) & ~xor_({xs[3], xs[4], xs[5]});
+
+    vector<CubeStat> stats;
+    auto soln = cube_and_conquer(f, options, &stats);
+    EXPECT_EQ(soln.first, SatStatus::UNSAT);
+    EXPECT_FALSE(stats.empty());
+
+    // Every cube that reached a worker was refuted
+    for (auto const &stat : stats) {
+        EXPECT_EQ(stat.status, CubeStat::UNSAT);
+        EXPECT_LT(stat.worker, 3u);
+    }
+}
+
+TEST_F(CubeTest, Stats) {
+    auto f = (xs[0] | xs[1]) & (xs[2] | xs[3]) & (xs[4] | xs[5]) &
+             (xs[6] | xs[7]);
+
+    vector<CubeStat> stats;
+    auto soln = cube_and_conquer(f, options, &stats);
+    EXPECT_EQ(soln.first, SatStatus::SAT);
+    EXPECT_TRUE(f->restrict_(*soln.second)->simplify()->equiv(one()));
+
+    // Three splits, and no failed literals
+    EXPECT_EQ(stats.size(), 8u);
+
+    size_t nsat = 0;
+    for (auto const &stat : stats) {
+        EXPECT_EQ(stat.cube.size(), 3u);
+        nsat += stat.status == CubeStat::SAT;
+    }
+    EXPECT_GE(nsat, 1u);
+}
+
+TEST_F(CubeTest, FailedLiteral) {
+    // Lookahead fixes xs[0], and then refutes the rest
+    auto f = xs[0] & (~xs[0] | xs[1]) & (~xs[1] | xs[2]) &
+             (~xs[2] | ~xs[0]) & (xs[3] | xs[4]);
+
+    vector<CubeStat> stats;
+    EXPECT_EQ(cube_and_conquer(f, options, &stats).first, SatStatus::UNSAT);
+    EXPECT_TRUE(stats.empty());
+}
@@ -0,0 +1,111 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class DimacsTest : public BoolExprTest {};
+
+TEST_F(DimacsTest, Write) {
+    auto cnf = Cnf();
+    cnf.nvars = 3;
+    cnf.add_clause({1, -2});
+    cnf.add_clause({-1, 2, 3});
+    cnf.add_clause({});
+
+    std::ostringstream oss;
+    write_dimacs(oss, cnf);
+    EXPECT_EQ(oss.str(), "p cnf 3 3\n1 -2 0\n-1 2 3 0\n0\n");
+
+    std::ostringstream oss2;
+    write_dimacs(oss2, or_({xs[0], ~xs[1]}));
+    EXPECT_EQ(oss2.str(), "c 1 x_0\nc 2 x_1\np cnf 2 1\n1 -2 0\n");
+}
+
+TEST_F(DimacsTest, Read) {
+    std::string text =
+        "c a comment\n"
+        "p  cnf 4 3\n"
+        "1 -2 0\n"
+        "c another comment\n"
+        "-1 2\n 3 0 4 0\n";
+
+    auto cnf = Cnf();
+    EXPECT_TRUE(read_dimacs(text.data(), text.data() + text.size(), cnf));
+    EXPECT_EQ(cnf.nvars, 4u);
+    EXPECT_EQ(cnf.lits, (vector<int32_t>{1, -2, -1, 2, 3, 4}));
+    EXPECT_EQ(cnf.offsets, (vector<uint32_t>{0, 2, 5, 6}));
+
+    auto ctx = Context();
+    auto f = cnf2bx(ctx, cnf, "y");
+    EXPECT_EQ(f->to_string(), "And(Or(y_1, ~y_2), Or(~y_1, y_2, y_3), y_4)");
+}
+
+TEST_F(DimacsTest, ReadErrors) {
+    auto cnf = Cnf();
+
+    std::string bad[] = {"",
+                         "c no problem line\n",
+                         "p dnf 1 1\n1 0\n",
+                         "pcnf 1 1\n1 0\n",
+                         "p cnf1 1\n1 0\n",
+                         "p cnf 1 1\n1 x 0\n",
+                         "p cnf 1 1\n99999999999 0\n"};
+    for (auto const &text : bad) {
+        EXPECT_FALSE(read_dimacs(text.data(), text.data() + text.size(), cnf));
+    }
+
+    EXPECT_FALSE(read_dimacs("/nonexistent/file.cnf", cnf));
+
+    // A bad clause leaves the CNF as it was
+    std::string text = "p cnf 9 2\n1 -2 0\n3 x 0\n";
+    EXPECT_FALSE(read_dimacs(text.data(), text.data() + text.size(), cnf));
+    EXPECT_EQ(cnf.nvars, 0u);
+    EXPECT_TRUE(cnf.lits.empty());
+    EXPECT_EQ(cnf.offsets, (vector<uint32_t>{0}));
+
+    // A huge clause count in the header does not reserve memory for it
+    std::string huge = "p cnf 3 2000000000\n1 0\n";
+    EXPECT_TRUE(read_dimacs(huge.data(), huge.data() + huge.size(), cnf));
+    EXPECT_EQ(cnf.offsets, (vector<uint32_t>{0, 1}));
+}
+
+TEST_F(DimacsTest, RoundTrip) {
+    auto f = (xs[0] ^ xs[1]) | ite(xs[2], xs[3], xs[4] & xs[5]);
+
+    std::string path = "dimacs_test.cnf";
+    {
+        std::ofstream ofs(path);
+        write_dimacs(ofs, f);
+    }
+
+    auto cnf = Cnf();
+    EXPECT_TRUE(read_dimacs(path, cnf));
+    std::remove(path.c_str());
+
+    auto ctx = Context();
+    auto g = cnf2bx(ctx, cnf);
+    EXPECT_TRUE(g->is_cnf());
+
+    // Tseytin variables are determined by the inputs, so models match 1:1
+    size_t f_count = 0, g_count = 0;
+    for (auto it = sat_iter(f); it != sat_iter(); ++it) ++f_count;
+    for (auto it = sat_iter(g); it != sat_iter(); ++it) ++g_count;
+    EXPECT_EQ(f_count, g_count);
+}
@@ -0,0 +1,122 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class LimitsTest : public BoolExprTest {
+protected:
+    SatOptions options;
+
+    // Pigeons i in holes j, with one more pigeon than holes
+    bx_t pigeonhole(size_t nholes) {
+        vector<bx_t> clauses;
+        for (size_t i = 0; i <= nholes; ++i) {
+            vector<bx_t> holes;
+            for (size_t j = 0; j < nholes; ++j) {
+                holes.push_back(xs[i * nholes + j]);
+            }
+            clauses.push_back(or_(holes));
+        }
+        for (size_t j = 0; j < nholes; ++j) {
+            for (size_t i = 0; i <= nholes; ++i) {
+                for (size_t k = i + 1; k <= nholes; ++k) {
+                    clauses.push_back(~xs[i * nholes + j] |
+                                      ~xs[k * nholes + j]);
+                }
+            }
+        }
+        return and_(clauses);
+    }
+};
+
+TEST_F(LimitsTest, Unlimited) {
+    auto f = onehot({xs[0], xs[1], xs[2]}) & (xs[0] | xs[2]);
+    auto soln = f->sat_limited(options);
+    EXPECT_EQ(soln.first, SatStatus::SAT);
+    EXPECT_TRUE(f->restrict_(*soln.second)->simplify()->equiv(one()));
+
+    EXPECT_EQ(pigeonhole(4)->sat_limited(options).first, SatStatus::UNSAT);
+    EXPECT_EQ(xs[0]->sat_limited(options).first, SatStatus::SAT);
+    EXPECT_EQ(_zero->sat_limited(options).first, SatStatus::UNSAT);
+}
+
+TEST_F(LimitsTest, Conflicts) {
+    auto f = pigeonhole(7);
+    options.conflict_limit = 10;
+
+    auto soln = f->sat_limited(options);
+    EXPECT_EQ(soln.first, SatStatus::UNKNOWN);
+    EXPECT_FALSE(soln.second);
+
+    options.nthreads = 3;
+    EXPECT_EQ(f->sat_limited(options).first, SatStatus::UNKNOWN);
+
+    options.cube_depth = 2;
+    EXPECT_EQ(f->sat_limited(options).first, SatStatus::UNKNOWN);
+
+    // Plain sat ignores limits
+    EXPECT_FALSE(pigeonhole(4)->sat(options).first);
+}
+
+TEST_F(LimitsTest, Propagations) {
+    options.propagation_limit = 10;
+    EXPECT_EQ(pigeonhole(7)->sat_limited(options).first, SatStatus::UNKNOWN);
+}
+
+TEST_F(LimitsTest, Timeout) {
+    options.time_limit = 0.05;
+
+    auto start = std::chrono::steady_clock::now();
+    auto soln = pigeonhole(9)->sat_limited(options);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(soln.first, SatStatus::UNKNOWN);
+    EXPECT_LT(elapsed.count(), 5.0);
+}
+
+TEST_F(LimitsTest, Interrupt) {
+    options.interrupt = std::make_shared<SatInterrupt>();
+    options.nthreads = 2;
+
+    std::thread stopper([this] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        options.interrupt->interrupt();
+    });
+    auto soln = pigeonhole(9)->sat_limited(options);
+    stopper.join();
+    EXPECT_EQ(soln.first, SatStatus::UNKNOWN);
+
+    // The handle stays set until reset
+    EXPECT_TRUE(options.interrupt->interrupted());
+    EXPECT_EQ(pigeonhole(3)->sat_limited(options).first, SatStatus::UNKNOWN);
+
+    options.interrupt->reset();
+    EXPECT_EQ(pigeonhole(3)->sat_limited(options).first, SatStatus::UNSAT);
+}
+
+TEST_F(LimitsTest, Equiv) {
+    auto f = ~(xs[0] & xs[1]);
+    auto g = ~xs[0] | ~xs[1];
+    EXPECT_EQ(f->equiv_limited(g, options), boost::optional<bool>(true));
+    EXPECT_EQ(f->equiv_limited(xs[0], options), boost::optional<bool>(false));
+
+    options.conflict_limit = 10;
+    EXPECT_FALSE(pigeonhole(7)->equiv_limited(_zero, options));
+}
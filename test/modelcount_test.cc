@@ -0,0 +1,126 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+using boost::multiprecision::cpp_int;
+
+class ModelCountTest : public BoolExprTest {};
+
+TEST_F(ModelCountTest, Atoms) {
+    EXPECT_EQ(_zero->count_sat(), 0);
+    EXPECT_EQ(_one->count_sat(), 1);
+    EXPECT_EQ(_log->count_sat(), 0);
+    EXPECT_EQ(_ill->count_sat(), 0);
+    EXPECT_EQ(xs[0]->count_sat(), 1);
+    EXPECT_EQ((~xs[0])->count_sat(), 1);
+}
+
+TEST_F(ModelCountTest, Small) {
+    EXPECT_EQ((xs[0] | xs[1])->count_sat(), 3);
+    EXPECT_EQ((xs[0] & xs[1])->count_sat(), 1);
+    EXPECT_EQ((xs[0] ^ xs[1] ^ xs[2])->count_sat(), 4);
+    EXPECT_EQ(onehot({xs[0], xs[1], xs[2], xs[3]})->count_sat(), 4);
+    EXPECT_EQ(ite(xs[0], xs[1], xs[2])->count_sat(), 4);
+
+    // Simplification removes x1, which is still a don't-care input
+    EXPECT_EQ(or_({xs[0], xs[1] & ~xs[1]})->count_sat(), 2);
+
+    // Agrees with enumeration
+    auto f = or_s({and_s({xs[0], ~xs[1]}), xs[2] ^ xs[3], eq({xs[4], xs[5]})});
+    int n = 0;
+    for (auto it = sat_iter(f); it != sat_iter(); ++it) {
+        n += 1 << (6 - (*it).size());
+    }
+    EXPECT_EQ(f->count_sat(), n);
+}
+
+TEST_F(ModelCountTest, Large) {
+    vector<bx_t> ys(xs.begin(), xs.begin() + 128);
+
+    // 2^127 odd-parity points
+    EXPECT_EQ(xor_(ys)->count_sat(), cpp_int(1) << 127);
+
+    // All points but one
+    EXPECT_EQ(or_(ys)->count_sat(), (cpp_int(1) << 128) - 1);
+
+    // 64 independent pairs, each with three models
+    vector<bx_t> pairs;
+    for (size_t i = 0; i < 128; i += 2) {
+        pairs.push_back(ys[i] | ys[i + 1]);
+    }
+    cpp_int expected = 1;
+    for (int i = 0; i < 64; ++i) {
+        expected *= 3;
+    }
+    EXPECT_EQ(and_(pairs)->count_sat(), expected);
+
+    // An implication chain has n + 1 models
+    vector<bx_t> chain;
+    for (size_t i = 0; i + 1 < 128; ++i) {
+        chain.push_back(impl(ys[i], ys[i + 1]));
+    }
+    EXPECT_EQ(and_(chain)->count_sat(), 129);
+}
+
+TEST_F(ModelCountTest, Projection) {
+    vector<bx_t> ys(xs.begin(), xs.begin() + 6);
+
+    // 1 + 6 + 15 points, whatever the auxiliaries
+    for (auto encoding : {CardEncoding::SEQCOUNTER, CardEncoding::TOTALIZER,
+                          CardEncoding::SORTNET}) {
+        auto f = at_most_k(ctx, ys, 2, encoding);
+        EXPECT_EQ(f->count_sat(), 22);
+        EXPECT_EQ(f->approx_count_sat(), 22);
+    }
+
+    // Named inputs that simplify removed are still don't-cares
+    auto g = at_most_k(ctx, ys, 2, CardEncoding::SEQCOUNTER);
+    EXPECT_EQ(or_({g, xs[6] & ~xs[6]})->count_sat(), 44);
+}
+
+TEST_F(ModelCountTest, Cnf) {
+    auto cnf = Cnf();
+    auto a = cnf.new_var();
+    auto b = cnf.new_var();
+    auto c = cnf.new_var();
+    cnf.add_clause({a, b});
+    cnf.add_clause({-a, -a, c});
+    cnf.add_clause({c, -c});
+    // a | b, a -> c
+    EXPECT_EQ(count_sat(cnf), 4);
+    cnf.add_clause({});
+    EXPECT_EQ(count_sat(cnf), 0);
+}
+
+TEST_F(ModelCountTest, Approx) {
+    // Small counts are exact
+    EXPECT_EQ(_zero->approx_count_sat(), 0);
+    EXPECT_EQ(onehot({xs[0], xs[1], xs[2], xs[3]})->approx_count_sat(), 4);
+    EXPECT_EQ(or_({xs[0], xs[1] & ~xs[1]})->approx_count_sat(), 2);
+
+    // 2^10 - 1 points
+    vector<bx_t> ys(xs.begin(), xs.begin() + 10);
+    auto f = or_(ys);
+    auto exact = f->count_sat();
+    auto approx = f->approx_count_sat(2.0, 0.8);
+    EXPECT_LE(approx, exact * 3);
+    EXPECT_LE(exact, approx * 3);
+
+    // Don't-care inputs scale the estimate
+    auto g = or_({f, xs[10] & ~xs[10]});
+    EXPECT_EQ(g->approx_count_sat(2.0, 0.8), approx * 2);
+}
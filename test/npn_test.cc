@@ -0,0 +1,144 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class NpnTest : public BoolExprTest {
+protected:
+    uint64_t state = 1;
+
+    uint64_t random() {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        return state >> 11;
+    }
+
+    TruthTable random_table(uint32_t n) {
+        TruthTable tt(n);
+        for (uint64_t m = 0; m < (uint64_t(1) << n); ++m) {
+            tt.set(m, random() & 1);
+        }
+        return tt;
+    }
+
+    NpnTransform random_transform(uint32_t n) {
+        NpnTransform t{vector<uint32_t>(n), 0, bool(random() & 1)};
+        for (uint32_t i = 0; i < n; ++i) {
+            t.perm[i] = i;
+        }
+        for (uint32_t i = n; i > 1; --i) {
+            std::swap(t.perm[i - 1], t.perm[random() % i]);
+        }
+        t.negs = random() & ((1u << n) - 1);
+        return t;
+    }
+};
+
+TEST_F(NpnTest, FlipSwap) {
+    // Word, mixed, and block cases, checked minterm by minterm
+    auto n = 9u;
+    auto f = random_table(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        auto g = f.flip(i);
+        for (uint64_t m = 0; m < (uint64_t(1) << n); ++m) {
+            EXPECT_EQ(g.get(m), f.get(m ^ (uint64_t(1) << i)));
+        }
+        for (uint32_t j = 0; j < n; ++j) {
+            auto h = f.swap(i, j);
+            for (uint64_t m = 0; m < (uint64_t(1) << n); ++m) {
+                auto xi = (m >> i) & 1;
+                auto xj = (m >> j) & 1;
+                auto other = m;
+                if (xi != xj) {
+                    other ^= (uint64_t(1) << i) | (uint64_t(1) << j);
+                }
+                EXPECT_EQ(h.get(m), f.get(other));
+            }
+        }
+    }
+}
+
+TEST_F(NpnTest, ClassCounts) {
+    // There are 4 NPN classes of two inputs, and 14 of three
+    for (auto pair : {std::make_pair(2u, 4u), std::make_pair(3u, 14u)}) {
+        auto n = pair.first;
+        std::set<TruthTable> classes;
+        for (uint64_t bits = 0; bits < (uint64_t(1) << (1 << n)); ++bits) {
+            TruthTable tt(n);
+            for (uint64_t m = 0; m < (uint64_t(1) << n); ++m) {
+                tt.set(m, (bits >> m) & 1);
+            }
+            classes.insert(npn_canon(tt).first);
+        }
+        EXPECT_EQ(classes.size(), pair.second);
+    }
+}
+
+TEST_F(NpnTest, Exact) {
+    for (uint32_t n : {1, 4, 5, 6}) {
+        for (int trial = 0; trial < 4; ++trial) {
+            auto f = random_table(n);
+            auto canon = npn_canon(f);
+            EXPECT_EQ(npn_apply(f, canon.second), canon.first);
+            EXPECT_FALSE(f < canon.first);
+
+            auto g = npn_apply(f, random_transform(n));
+            EXPECT_EQ(npn_canon(g).first, canon.first);
+        }
+    }
+}
+
+TEST_F(NpnTest, Heuristic) {
+    for (uint32_t n : {7, 10}) {
+        auto f = random_table(n);
+        auto canon = npn_canon(f);
+        EXPECT_EQ(npn_apply(f, canon.second), canon.first);
+        EXPECT_LE(2 * canon.first.count(), uint64_t(1) << n);
+
+        // Symmetric functions land on the same form from any transform
+        auto sym = TruthTable(n);
+        for (uint32_t i = 0; i + 1 < n; i += 2) {
+            sym ^= TruthTable::var(n, i) & TruthTable::var(n, i + 1);
+        }
+        auto expected = npn_canon(sym).first;
+        auto moved = npn_apply(sym, random_transform(n));
+        EXPECT_EQ(npn_apply(moved, npn_canon(moved).second),
+                  npn_canon(moved).first);
+        EXPECT_EQ(expected.count(), npn_canon(moved).first.count());
+    }
+}
+
+TEST_F(NpnTest, Class) {
+    auto f = xs[0] & ~xs[1];
+    auto g = ~xs[5] | xs[2];
+    EXPECT_EQ(*f->npn_class(), *g->npn_class());
+    EXPECT_NE(*f->npn_class(), *(xs[0] ^ xs[1])->npn_class());
+
+    // Inputs the function ignores do not count
+    auto h = (xs[3] & xs[4]) | (xs[6] & ~xs[6]);
+    EXPECT_EQ(*h->npn_class(), *f->npn_class());
+    EXPECT_EQ(h->npn_class()->nvars(), 2u);
+
+    EXPECT_EQ(*_one->npn_class(), *_zero->npn_class());
+    EXPECT_EQ(*ite(xs[0], xs[1], xs[2])->npn_class(),
+              *ite(~xs[3], xs[4], ~xs[5])->npn_class());
+
+    // Too many variables, or an unknown constant
+    vector<bx_t> many(xs.begin(), xs.begin() + 17);
+    EXPECT_FALSE(or_(many)->npn_class());
+    EXPECT_FALSE((xs[0] | _log)->npn_class());
+}
@@ -0,0 +1,121 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cstdint>  // INT64_MAX, INT64_MIN
+#include <functional>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class PBTest : public BoolExprTest {
+protected:
+    // Check f against pred(sum) for every point of xs[0..n)
+    void check(bx_t const &f, vector<int64_t> const &ws,
+               std::function<bool(int64_t)> pred) {
+        EXPECT_TRUE(f->is_cnf() || IS_ATOM(f));
+        size_t n = ws.size();
+        for (size_t i = 0; i < (1u << n); ++i) {
+            point_t point;
+            int64_t sum = 0;
+            for (size_t j = 0; j < n; ++j) {
+                if ((i >> j) & 1u) {
+                    point.insert({xs[j], one()});
+                    sum += ws[j];
+                } else {
+                    point.insert({xs[j], zero()});
+                }
+            }
+            EXPECT_EQ(f->restrict_(point)->sat().first, pred(sum));
+        }
+    }
+};
+
+TEST_F(PBTest, Encodings) {
+    auto encodings = {PBEncoding::AUTO, PBEncoding::BDD, PBEncoding::ADDER,
+                      PBEncoding::GTE};
+
+    vector<int64_t> ws{3, -2, 5, 1, 4, 2};
+    vector<bx_t> args(xs.begin(), xs.begin() + ws.size());
+
+    for (auto encoding : encodings) {
+        for (int64_t k = -3; k <= 16; ++k) {
+            check(*pb_leq(ctx, args, ws, k, encoding), ws,
+                  [k](int64_t sum) { return sum <= k; });
+            check(*pb_geq(ctx, args, ws, k, encoding), ws,
+                  [k](int64_t sum) { return sum >= k; });
+            check(*pb_eq(ctx, args, ws, k, encoding), ws,
+                  [k](int64_t sum) { return sum == k; });
+        }
+    }
+}
+
+TEST_F(PBTest, Uniform) {
+    vector<int64_t> ws(5, 3);
+    vector<bx_t> args(xs.begin(), xs.begin() + ws.size());
+
+    check(*pb_leq(ctx, args, ws, 7), ws, [](int64_t sum) { return sum <= 7; });
+}
+
+TEST_F(PBTest, Large) {
+    size_t const n = 300;
+    vector<int64_t> ws;
+    vector<bx_t> args;
+    for (size_t i = 0; i < n; ++i) {
+        ws.push_back(1 + (i * 7919) % 1000);
+        args.push_back(xs[i]);
+    }
+
+    auto f = *pb_leq(ctx, args, ws, 12345);
+    EXPECT_TRUE(f->is_cnf());
+
+    auto soln = f->sat();
+    EXPECT_TRUE(soln.first);
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto search = soln.second->find(xs[i]);
+        if (search != soln.second->end() && IS_ONE(search->second)) {
+            sum += ws[i];
+        }
+    }
+    EXPECT_LE(sum, 12345);
+}
+
+TEST_F(PBTest, Extremes) {
+    vector<bx_t> args(xs.begin(), xs.begin() + 3);
+
+    // Bounds outside the range of the sum are decided up front
+    vector<int64_t> ws{3, -2, 5};
+    EXPECT_TRUE(IS_ONE(*pb_leq(ctx, args, ws, INT64_MAX)));
+    EXPECT_TRUE(IS_ZERO(*pb_leq(ctx, args, ws, INT64_MIN)));
+    EXPECT_TRUE(IS_ONE(*pb_geq(ctx, args, ws, INT64_MIN)));
+    EXPECT_TRUE(IS_ZERO(*pb_geq(ctx, args, ws, INT64_MAX)));
+
+    // Large weights are fine, up to a total of 2^61
+    int64_t big = int64_t(1) << 59;
+    vector<int64_t> bigs{big, -big, 2 * big};
+    check(*pb_leq(ctx, args, bigs, big, PBEncoding::ADDER), bigs,
+          [big](int64_t sum) { return sum <= big; });
+    check(*pb_geq(ctx, args, bigs, big, PBEncoding::GTE), bigs,
+          [big](int64_t sum) { return sum >= big; });
+
+    // Sums that might overflow are rejected
+    vector<int64_t> mins{INT64_MIN, 1, 1};
+    EXPECT_FALSE(pb_leq(ctx, args, mins, 0));
+    EXPECT_FALSE(pb_geq(ctx, args, mins, 0));
+    EXPECT_FALSE(pb_eq(ctx, args, mins, 0));
+    vector<int64_t> maxs{INT64_MAX / 2, INT64_MAX / 2, 1};
+    EXPECT_FALSE(pb_leq(ctx, args, maxs, 0));
+    EXPECT_FALSE(pb_geq(ctx, args, maxs, 0));
+}
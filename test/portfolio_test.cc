@@ -0,0 +1,80 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class PortfolioTest : public BoolExprTest {
+protected:
+    SatOptions options;
+
+    // Pigeons i in holes j, with one more pigeon than holes
+    bx_t pigeonhole(size_t nholes) {
+        vector<bx_t> clauses;
+        for (size_t i = 0; i <= nholes; ++i) {
+            vector<bx_t> holes;
+            for (size_t j = 0; j < nholes; ++j) {
+                holes.push_back(xs[i * nholes + j]);
+            }
+            clauses.push_back(or_(holes));
+        }
+        for (size_t j = 0; j < nholes; ++j) {
+            for (size_t i = 0; i <= nholes; ++i) {
+                for (size_t k = i + 1; k <= nholes; ++k) {
+                    clauses.push_back(~xs[i * nholes + j] |
+                                      ~xs[k * nholes + j]);
+                }
+            }
+        }
+        return and_(clauses);
+    }
+
+    virtual void SetUp() {
+        BoolExprTest::SetUp();
+        options.nthreads = 4;
+    }
+};
+
+TEST_F(PortfolioTest, Sat) {
+    auto f = onehot({xs[0], xs[1], xs[2], xs[3]}) & (xs[0] | xs[3]);
+    auto soln = f->sat(options);
+    EXPECT_TRUE(soln.first);
+    EXPECT_TRUE(f->restrict_(*soln.second)->simplify()->equiv(one()));
+
+    // Atoms do not need a solver
+    EXPECT_TRUE(xs[0]->sat(options).first);
+    EXPECT_FALSE(_zero->sat(options).first);
+}
+
+TEST_F(PortfolioTest, Unsat) {
+    EXPECT_FALSE(pigeonhole(4)->sat(options).first);
+    EXPECT_FALSE(pigeonhole(5)->sat(options).first);
+    EXPECT_FALSE(pigeonhole(7)->sat(options).first);
+}
+
+TEST_F(PortfolioTest, Session) {
+    auto s = SatSession(options);
+    s.add(onehot({xs[0], xs[1], xs[2]}));
+
+    auto soln1 = s.solve({xs[0]});
+    EXPECT_TRUE(soln1.first);
+    EXPECT_EQ((*soln1.second).at(xs[1]), zero());
+
+    EXPECT_FALSE(s.solve({xs[0], xs[1]}).first);
+    EXPECT_TRUE(s.solve().first);
+
+    s.add(~xs[0] & ~xs[1] & ~xs[2]);
+    EXPECT_FALSE(s.solve().first);
+}
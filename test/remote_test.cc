@@ -0,0 +1,189 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef _WIN32
+
+#include <algorithm>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class RemoteTest : public BoolExprTest {
+protected:
+    SatOptions options;
+    vector<int> fds;
+    vector<pid_t> pids;
+
+    // Fork worker processes, each connected by a socket pair
+    void fork_workers(size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            int sv[2];
+            ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+            auto pid = fork();
+            ASSERT_GE(pid, 0);
+            if (pid == 0) {
+                close(sv[0]);
+                _exit(serve_cubes(sv[1]) ? 0 : 1);
+            }
+            close(sv[1]);
+            fds.push_back(sv[0]);
+            pids.push_back(pid);
+        }
+    }
+
+    // Close the sockets, and return whether every worker ended cleanly
+    bool join_workers() {
+        for (auto fd : fds) {
+            close(fd);
+        }
+        bool ok = true;
+        for (auto pid : pids) {
+            int status;
+            waitpid(pid, &status, 0);
+            ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+        fds.clear();
+        pids.clear();
+        return ok;
+    }
+
+    virtual void SetUp() {
+        BoolExprTest::SetUp();
+        options.cube_depth = 3;
+    }
+};
+
+TEST_F(RemoteTest, BinaryCnf) {
+    CnfEncoder encoder;
+    encoder.add(onehot({xs[0], xs[1], xs[2]}) | xs[3]);
+
+    std::ostringstream oss;
+    write_binary_cnf(oss, encoder.cnf);
+    auto text = oss.str();
+    EXPECT_EQ(text.substr(0, 4), "BXC1");
+
+    Cnf cnf;
+    EXPECT_TRUE(read_binary_cnf(text.data(), text.data() + text.size(), cnf));
+    EXPECT_EQ(cnf.nvars, encoder.cnf.nvars);
+    EXPECT_EQ(cnf.lits, encoder.cnf.lits);
+    EXPECT_EQ(cnf.offsets, encoder.cnf.offsets);
+
+    // Truncated
+    Cnf bad;
+    EXPECT_FALSE(
+        read_binary_cnf(text.data(), text.data() + text.size() - 1, bad));
+
+    // A zero literal leaves the CNF as it was
+    auto zero_lit = text;
+    std::fill(zero_lit.end() - 4, zero_lit.end(), '\0');
+    EXPECT_FALSE(read_binary_cnf(zero_lit.data(),
+                                 zero_lit.data() + zero_lit.size(), cnf));
+    EXPECT_EQ(cnf.nvars, encoder.cnf.nvars);
+    EXPECT_EQ(cnf.lits, encoder.cnf.lits);
+    EXPECT_EQ(cnf.offsets, encoder.cnf.offsets);
+}
+
+TEST_F(RemoteTest, Sat) {
+    auto f = onehot({xs[0], xs[1], xs[2], xs[3], xs[4]}) & (xs[3] | xs[4]);
+
+    fork_workers(3);
+    vector<CubeStat> stats;
+    auto soln = remote_sat(f, fds, options, &stats);
+    EXPECT_TRUE(join_workers());
+
+    EXPECT_TRUE(soln.first);
+    EXPECT_TRUE(f->restrict_(*soln.second)->simplify()->equiv(one()));
+
+    size_t nsat = 0;
+    for (auto const &stat : stats) {
+        nsat += stat.status == CubeStat::SAT;
+    }
+    EXPECT_EQ(nsat, 1u);
+
+    // Auxiliary variables are projected away
+    auto g = f->tseytin(ctx);
+    fork_workers(2);
+    soln = remote_sat(g, fds, options, nullptr);
+    EXPECT_TRUE(join_workers());
+    ASSERT_TRUE(soln.first);
+    for (auto const &pair : *soln.second) {
+        EXPECT_FALSE(ctx.is_anon(pair.first->id));
+    }
+}
+
+TEST_F(RemoteTest, Unsat) {
+    auto f = xor_({xs[0], xs[1], xs[2], xs[3], xs[4], xs[5]}) &
+             ~xor_({xs[0], xs[1], xs[2]}) & ~xor_({xs[3], xs[4], xs[5]});
+
+    fork_workers(2);
+    vector<CubeStat> stats;
+    EXPECT_FALSE(remote_sat(f, fds, options, &stats).first);
+    EXPECT_TRUE(join_workers());
+
+    EXPECT_FALSE(stats.empty());
+    for (auto const &stat : stats) {
+        EXPECT_EQ(stat.status, CubeStat::UNSAT);
+        EXPECT_LT(stat.worker, 2u);
+    }
+}
+
+TEST_F(RemoteTest, LostWorker) {
+    auto f = xor_({xs[0], xs[1], xs[2], xs[3], xs[4], xs[5]}) &
+             ~xor_({xs[0], xs[1], xs[2]}) & ~xor_({xs[3], xs[4], xs[5]});
+
+    // The other end of this socket is already closed
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    close(sv[1]);
+
+    vector<CubeStat> stats;
+    EXPECT_FALSE(remote_sat(f, vector<int>{sv[0]}, options, &stats).first);
+    close(sv[0]);
+
+    // The coordinator solved every cube itself
+    EXPECT_FALSE(stats.empty());
+    for (auto const &stat : stats) {
+        EXPECT_EQ(stat.status, CubeStat::UNSAT);
+        EXPECT_EQ(stat.worker, 1u);
+    }
+}
+
+TEST_F(RemoteTest, Address) {
+    auto path = std::string("/tmp/boolexpr_remote_test.") +
+                std::to_string(getpid());
+
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        _exit(serve_cubes(path) ? 0 : 1);
+    }
+
+    auto f = onehot({xs[0], xs[1], xs[2], xs[3]}) & xs[2];
+    auto soln = remote_sat(f, vector<std::string>{path}, options);
+
+    int status;
+    waitpid(pid, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    EXPECT_TRUE(soln.first);
+    EXPECT_EQ((*soln.second).at(xs[2]), one());
+}
+
+#endif  // _WIN32
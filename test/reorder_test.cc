@@ -0,0 +1,217 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class ReorderTest : public BoolExprTest {
+protected:
+    // x[0] & y[0] | ... | x[n-1] & y[n-1], where x[i] = xs[i] and
+    // y[i] = xs[n+i]. Its BDD is linear when each x[i] is next to y[i],
+    // and exponential when every x is above every y.
+    bx_t pairs(size_t n) {
+        vector<bx_t> terms;
+        for (size_t i = 0; i < n; ++i) {
+            terms.push_back(and_({xs[i], xs[n + i]}));
+        }
+        return or_(terms);
+    }
+};
+
+TEST_F(ReorderTest, SetOrder) {
+    BddManager mgr(ctx);
+
+    vector<bx_t> fs = {
+        pairs(4),
+        xor_({xs[0], xs[3], xs[5]}),
+        ite(xs[7], xs[1], ~xs[6]),
+        eq({xs[2], xs[4], xs[6]}),
+    };
+    vector<Bdd> bdds;
+    for (auto const &f : fs) {
+        bdds.push_back(mgr.to_bdd(f));
+    }
+
+    vector<var_t> order(xs.begin(), xs.begin() + 8);
+    std::reverse(order.begin(), order.end());
+    mgr.set_order(order);
+    EXPECT_EQ(mgr.order(), order);
+
+    // Handles keep their functions
+    for (size_t i = 0; i < fs.size(); ++i) {
+        EXPECT_EQ(bdds[i], mgr.to_bdd(fs[i]));
+        EXPECT_TRUE(mgr.from_bdd(bdds[i])->equiv(fs[i]));
+        EXPECT_EQ(mgr.sat_count(bdds[i]), fs[i]->count_sat());
+    }
+
+    // Only the nodes of the handles are left
+    bdds.clear();
+    mgr.gc();
+    EXPECT_EQ(mgr.nodes(), 0u);
+}
+
+TEST_F(ReorderTest, Sift) {
+    BddManager mgr(ctx);
+
+    auto f = pairs(8);
+    auto bdd = mgr.to_bdd(f);
+    EXPECT_EQ(mgr.size(bdd), 511u);
+
+    mgr.reorder(BddReorder::SIFT);
+    EXPECT_EQ(mgr.size(bdd), 17u);
+    EXPECT_EQ(bdd, mgr.to_bdd(f));
+    EXPECT_EQ(mgr.sat_count(bdd), f->count_sat());
+}
+
+TEST_F(ReorderTest, Group) {
+    BddManager mgr(ctx);
+
+    auto f = pairs(6);
+    auto bdd = mgr.to_bdd(f);
+
+    // Groups of x's and y's keep the bad order
+    mgr.group({xs[0], xs[1], xs[2], xs[3], xs[4], xs[5]});
+    mgr.group({xs[6], xs[7], xs[8], xs[9], xs[10], xs[11]});
+    auto size = mgr.size(bdd);
+    mgr.reorder(BddReorder::SIFT);
+    EXPECT_EQ(mgr.size(bdd), size);
+
+    // Pairs as groups
+    vector<var_t> order;
+    for (size_t i = 0; i < 6; ++i) {
+        order.push_back(xs[5 - i]);
+        order.push_back(xs[6 + i]);
+    }
+    mgr.set_order(order);
+    for (size_t i = 0; i < 6; ++i) {
+        mgr.group({xs[i], xs[6 + i]});
+    }
+    mgr.reorder(BddReorder::SIFT);
+    auto levels = mgr.order();
+    for (size_t i = 0; i < 12; i += 2) {
+        auto lo = std::min(levels[i]->id, levels[i + 1]->id);
+        auto hi = std::max(levels[i]->id, levels[i + 1]->id);
+        EXPECT_EQ(hi, lo + 12);
+    }
+    EXPECT_EQ(mgr.size(bdd), 13u);
+    EXPECT_EQ(bdd, mgr.to_bdd(f));
+}
+
+TEST_F(ReorderTest, GroupSift) {
+    BddManager mgr(ctx);
+
+    // x[i] and y[i] are symmetric, once they are next to each other
+    auto f = pairs(8);
+    auto g = xor_({xs[16], xs[17], xs[18]});
+    auto bdd = mgr.to_bdd(and_({f, g}));
+
+    // Sixteen nodes for f, over three for g, and the terminal
+    mgr.reorder(BddReorder::GROUP_SIFT);
+    EXPECT_EQ(mgr.size(bdd), 20u);
+    EXPECT_EQ(bdd, mgr.to_bdd(and_({f, g})));
+}
+
+TEST_F(ReorderTest, AutoReorder) {
+    BddManager mgr(ctx);
+    mgr.set_auto_reorder(BddReorder::SIFT);
+
+    // Build the bad order one term at a time
+    size_t n = 14;
+    for (size_t i = 0; i < 2 * n; ++i) {
+        mgr.var(xs[i]);
+    }
+    auto bdd = mgr.zero();
+    for (size_t i = 0; i < n; ++i) {
+        bdd = bdd | (mgr.var(xs[i]) & mgr.var(xs[n + i]));
+    }
+
+    EXPECT_LT(mgr.size(bdd), 1000u);
+    EXPECT_EQ(bdd, mgr.to_bdd(pairs(n)));
+    EXPECT_EQ(mgr.sat_count(bdd), pairs(n)->count_sat());
+}
+
+TEST_F(ReorderTest, StaticOrders) {
+    auto f = pairs(8);
+
+    auto dfs = dfs_order({f});
+    ASSERT_EQ(dfs.size(), 16u);
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(dfs[2 * i], xs[i]);
+        EXPECT_EQ(dfs[2 * i + 1], xs[8 + i]);
+    }
+
+    // Shuffle the arguments, so depth-first order is poor
+    vector<bx_t> terms;
+    for (size_t i = 0; i < 8; ++i) {
+        terms.push_back(and_({xs[i], xs[8 + (i * 3) % 8]}));
+    }
+    auto g = or_(terms);
+
+    auto force = force_order({g});
+    ASSERT_EQ(force.size(), 16u);
+
+    BddManager mgr(ctx);
+    mgr.set_order(force);
+    EXPECT_EQ(mgr.size(mgr.to_bdd(g)), 17u);
+}
+
+TEST_F(ReorderTest, IterSat) {
+    BddManager mgr(ctx);
+
+    // x0 & x5 | x1 & x4 | x2 & x3
+    vector<bx_t> terms;
+    for (size_t i = 0; i < 3; ++i) {
+        terms.push_back(and_({xs[i], xs[5 - i]}));
+    }
+    auto f = or_(terms);
+    auto bdd = mgr.to_bdd(f);
+
+    vector<var_t> order(xs.begin(), xs.begin() + 6);
+    std::reverse(order.begin(), order.end());
+
+    // Change the order in the middle of the iteration
+    std::set<vector<bool>> points;
+    size_t n = 0;
+    for (auto it = bdd_sat_iter(bdd); it != bdd_sat_iter(); ++it, ++n) {
+        EXPECT_TRUE(IS_ONE(f->restrict_(*it)));
+        vector<bool> point;
+        for (size_t i = 0; i < 6; ++i) {
+            point.push_back(IS_ONE((*it).at(xs[i])));
+        }
+        points.insert(point);
+
+        if (n == 3) {
+            mgr.set_order(order);
+        } else if (n == 10) {
+            mgr.reorder(BddReorder::SIFT);
+        } else if (n == 20) {
+            // Grow past the limit, so the next operation reorders
+            mgr.set_auto_reorder(BddReorder::SIFT);
+            for (size_t i = 8; i < 36; ++i) {
+                mgr.var(xs[i]);
+            }
+            auto before = mgr.order();
+            auto g = mgr.zero();
+            for (size_t i = 0; i < 14; ++i) {
+                g = g | (mgr.var(xs[8 + i]) & mgr.var(xs[22 + i]));
+            }
+            EXPECT_NE(mgr.order(), before);
+        }
+    }
+    EXPECT_EQ(n, 37u);
+    EXPECT_EQ(points.size(), 37u);
+}
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>  // min
+
 #include "boolexpr/boolexpr.h"
 #include "boolexprtest.h"
 
@@ -134,3 +136,160 @@ TEST_F(SATTest, Iter) {
     ++it6;
     EXPECT_EQ(it6, sat_iter());
 }
+
+TEST_F(SATTest, ProjectedIter) {
+    // Inputs x3 ... x11 are projected, but outside the support
+    auto y0 = or_s({and_s({xs[0], xs[1]}), xs[2]});
+    vector<var_t> vars0(xs.begin(), xs.begin() + 12);
+
+    int count = 0;
+    for (auto it = sat_iter(y0, vars0); it != sat_iter(); ++it, ++count) {
+        EXPECT_LE((*it).size(), 2u);
+        EXPECT_TRUE(y0->restrict_(*it)->simplify()->equiv(one()));
+    }
+    // Cubes cover all 2^12 - 3 * 2^9 points
+    EXPECT_LE(count, 3);
+    EXPECT_GE(count, 2);
+
+    // x1 is existentially quantified
+    auto y1 = and_s({xs[0], or_s({xs[1], xs[2]})});
+    vector<var_t> vars1{xs[0], xs[2]};
+
+    count = 0;
+    for (auto it = sat_iter(y1, vars1); it != sat_iter(); ++it, ++count) {
+        EXPECT_EQ((*it).at(xs[0]), _one);
+        EXPECT_EQ((*it).count(xs[1]), 0u);
+    }
+    EXPECT_GE(count, 1);
+    EXPECT_LE(count, 2);
+
+    // Constants
+    count = 0;
+    for (auto it = sat_iter(zero(), vars1); it != sat_iter(); ++it, ++count)
+        ;
+    EXPECT_EQ(count, 0);
+
+    count = 0;
+    for (auto it = sat_iter(one(), vars1); it != sat_iter(); ++it, ++count) {
+        EXPECT_EQ((*it).size(), 0u);
+    }
+    EXPECT_EQ(count, 1);
+
+    // Auxiliary variables do not keep every input in the cube
+    auto y2 = or_s({and_s({xs[0], xs[1]}), and_s({xs[2], xs[3]})});
+    auto t2 = y2->tseytin(ctx);
+    vector<var_t> vars2(xs.begin(), xs.begin() + 6);
+
+    size_t smallest = vars2.size();
+    for (auto it = sat_iter(t2, vars2); it != sat_iter(); ++it) {
+        EXPECT_TRUE(y2->restrict_(*it)->simplify()->equiv(one()));
+        smallest = std::min(smallest, (*it).size());
+    }
+    EXPECT_LE(smallest, 3u);
+}
+
+TEST_F(SATTest, Assuming) {
+    // f = onehot(x0, x1, x2)
+    auto f = onehot({xs[0], xs[1], xs[2]});
+
+    auto soln0 = f->sat(point_t{{xs[0], _one}});
+    EXPECT_TRUE(soln0.first);
+    auto p0 = *soln0.second;
+    EXPECT_EQ(p0.size(), 2u);
+    EXPECT_EQ(p0[xs[1]], _zero);
+    EXPECT_EQ(p0[xs[2]], _zero);
+
+    auto soln1 = f->sat(point_t{{xs[0], _one}, {xs[1], _one}});
+    EXPECT_FALSE(soln1.first);
+
+    // Sweep every cofactor against one cached encoding
+    AssumptionCache cache(f);
+    for (int i = 0; i < 8; ++i) {
+        auto point = point_t();
+        for (int j = 0; j < 3; ++j) {
+            if ((i >> j) & 1) {
+                point.insert({xs[j], _one});
+            } else {
+                point.insert({xs[j], _zero});
+            }
+        }
+        auto r = f->restrict_(point)->sat();
+        auto s = cache.sat(point);
+        EXPECT_EQ(s.first, r.first);
+        if (s.first) {
+            EXPECT_EQ(*s.second, point_t{});
+        }
+    }
+
+    // Variables outside the support are not returned
+    auto soln2 = f->sat(point_t{{xs[3], _zero}});
+    EXPECT_TRUE(soln2.first);
+    EXPECT_EQ((*soln2.second).count(xs[3]), 0u);
+
+    // Unknown values fall back to restrict_
+    auto soln3 = f->sat(point_t{{xs[0], _log}});
+    EXPECT_FALSE(soln3.first);
+
+    // Atoms
+    EXPECT_TRUE(xs[0]->sat(point_t{{xs[1], _zero}}).first);
+    EXPECT_FALSE(xs[0]->sat(point_t{{xs[0], _zero}}).first);
+}
+
+TEST_F(SATTest, EquivAssuming) {
+    auto f = or_s({and_s({xs[0], xs[1]}), xs[2]});
+    auto g = xs[2];
+
+    EXPECT_FALSE(f->equiv(g));
+    EXPECT_TRUE(f->equiv(g, point_t{{xs[0], _zero}}));
+    EXPECT_TRUE(f->equiv(g, point_t{{xs[1], _zero}}));
+    EXPECT_FALSE(f->equiv(g, point_t{{xs[0], _one}}));
+    EXPECT_TRUE(f->equiv(_one, point_t{{xs[0], _one}, {xs[1], _one}}));
+
+    // Both sides are operators
+    auto h = or_s({xs[2], and_s({xs[1], xs[0]})});
+    EXPECT_TRUE(f->equiv(h, point_t{{xs[3], _one}}));
+
+    // The atom side defers to the operator side
+    EXPECT_TRUE(g->equiv(f, point_t{{xs[1], _zero}}));
+    EXPECT_FALSE(g->equiv(f, point_t{{xs[1], _one}}));
+
+    // The cache starts over after many other sides
+    AssumptionCache cache(f);
+    for (size_t i = 0; i < 2000; ++i) {
+        auto h = or_s({xs[2], and_s({xs[0], xs[1], xs[3 + i % 500]})});
+        auto point = point_t{{xs[3 + i % 500], _one}};
+        EXPECT_TRUE(cache.equiv(h, point));
+    }
+    EXPECT_FALSE(cache.equiv(g, point_t{{xs[0], _one}}));
+}
+
+TEST_F(SATTest, EquivMany) {
+    // Ripple-carry and majority-form carries of a 4-bit adder
+    vector<bx_t> c1 = {_zero}, c2 = {_zero};
+    vector<std::pair<bx_t, bx_t>> pairs;
+    for (size_t i = 0; i < 4; ++i) {
+        auto a = xs[i], b = xs[4 + i];
+        c1.push_back((a & b) | (c1[i] & (a ^ b)));
+        c2.push_back((a & b) | (a & c2[i]) | (b & c2[i]));
+        pairs.push_back({c1[i + 1], c2[i + 1]});
+    }
+
+    // Not equivalent, equivalent literals, constants, and unknowns
+    pairs.push_back({c1[4], c2[3]});
+    pairs.push_back({xs[0], xs[0]});
+    pairs.push_back({xs[0], ~xs[0]});
+    pairs.push_back({xs[0] | ~xs[0], _one});
+    pairs.push_back({_log, _log});
+
+    auto results = equiv_many(pairs);
+    ASSERT_EQ(results.size(), pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        EXPECT_EQ(results[i], pairs[i].first->equiv(pairs[i].second));
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(results[i]);
+    }
+    EXPECT_FALSE(results[4]);
+
+    EXPECT_TRUE(equiv_many({}).empty());
+}
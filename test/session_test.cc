@@ -0,0 +1,78 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class SatSessionTest : public BoolExprTest {};
+
+TEST_F(SatSessionTest, Empty) {
+    auto s = SatSession();
+    auto soln = s.solve();
+    EXPECT_TRUE(soln.first);
+    EXPECT_EQ(*soln.second, point_t{});
+}
+
+TEST_F(SatSessionTest, Incremental) {
+    auto s = SatSession();
+
+    s.add(or_s({xs[0], xs[1], xs[2]}));
+    auto soln1 = s.solve();
+    EXPECT_TRUE(soln1.first);
+
+    s.add(~xs[0]);
+    s.add(~xs[1]);
+    auto soln2 = s.solve();
+    EXPECT_TRUE(soln2.first);
+    EXPECT_EQ((*soln2.second).at(xs[0]), zero());
+    EXPECT_EQ((*soln2.second).at(xs[1]), zero());
+    EXPECT_EQ((*soln2.second).at(xs[2]), one());
+
+    s.add(~xs[2]);
+    EXPECT_FALSE(s.solve().first);
+}
+
+TEST_F(SatSessionTest, Assumptions) {
+    auto s = SatSession();
+    s.add(onehot({xs[0], xs[1], xs[2]}));
+
+    auto soln1 = s.solve({xs[0]});
+    EXPECT_TRUE(soln1.first);
+    EXPECT_EQ((*soln1.second).at(xs[1]), zero());
+    EXPECT_EQ((*soln1.second).at(xs[2]), zero());
+
+    auto soln2 = s.solve({xs[0], xs[1]});
+    EXPECT_FALSE(soln2.first);
+
+    // Assumptions do not persist after an UNSAT result
+    auto xn0 = std::static_pointer_cast<Literal const>(~xs[0]);
+    auto xn2 = std::static_pointer_cast<Literal const>(~xs[2]);
+    auto soln3 = s.solve({xn0, xn2});
+    EXPECT_TRUE(soln3.first);
+    EXPECT_EQ((*soln3.second).at(xs[1]), one());
+
+    // An assumption on a variable the session has never seen
+    auto soln4 = s.solve({xs[3]});
+    EXPECT_TRUE(soln4.first);
+    EXPECT_EQ((*soln4.second).at(xs[3]), one());
+}
+
+TEST_F(SatSessionTest, Constant) {
+    auto s = SatSession();
+    s.add(one());
+    EXPECT_TRUE(s.solve().first);
+    s.add(zero());
+    EXPECT_FALSE(s.solve().first);
+}
@@ -0,0 +1,141 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class SimulateTest : public BoolExprTest {
+protected:
+    // Every point over the first nvars variables, one per bit
+    var2words_t all_points(size_t nvars, size_t nwords) {
+        var2words_t patterns;
+        for (size_t i = 0; i < nvars; ++i) {
+            vector<uint64_t> words(nwords);
+            for (size_t j = 0; j < 64 * nwords; ++j) {
+                words[j / 64] |= uint64_t((j >> i) & 1) << (j % 64);
+            }
+            patterns.insert({xs[i], words});
+        }
+        return patterns;
+    }
+
+    void check(bx_t const& f, var2words_t const& patterns) {
+        auto words = *simulate(f, patterns);
+        for (size_t j = 0; j < 64 * words.size(); ++j) {
+            point_t point;
+            for (auto const& pair : patterns) {
+                auto bit = (pair.second[j / 64] >> (j % 64)) & 1;
+                if (bit) {
+                    point.insert({pair.first, _one});
+                } else {
+                    point.insert({pair.first, _zero});
+                }
+            }
+            auto val = f->restrict_(point)->simplify();
+            EXPECT_EQ((words[j / 64] >> (j % 64)) & 1, IS_ONE(val));
+        }
+    }
+};
+
+TEST_F(SimulateTest, Operators) {
+    auto patterns = all_points(6, 1);
+    auto a = xs[0], b = xs[1], c = xs[2], d = xs[3], e = xs[4], f = xs[5];
+
+    vector<bx_t> fs = {
+        _zero,
+        _one,
+        a,
+        ~a,
+        or_({a, ~b, c}),
+        nor({a, ~b, c}),
+        and_({~a, b, c}),
+        nand({~a, b, c}),
+        xor_({a, b, ~c}),
+        xnor({a, b, ~c}),
+        eq({a, ~b, c}),
+        neq({a, ~b, c}),
+        impl(a, b & c),
+        nimpl(a, b & c),
+        ite(a, b | d, c ^ e),
+        nite(a, b | d, c ^ e),
+        ite(or_({a, f}), eq({b, c, d}), nimpl(e, ~a)),
+    };
+    for (auto const& g : fs) {
+        check(g, patterns);
+    }
+}
+
+TEST_F(SimulateTest, Words) {
+    // More words than one pass holds, with a partial last pass
+    auto f = onehot({xs[0], xs[1], xs[2], xs[3], xs[4], xs[5], xs[6], xs[7],
+                     xs[8]});
+    check(f, all_points(9, 8));
+    check(f, all_points(9, 5));
+    EXPECT_EQ(simulate(f, all_points(9, 0))->size(), 0u);
+}
+
+TEST_F(SimulateTest, BadInputs) {
+    auto f = xs[0] & xs[1];
+
+    // A missing pattern
+    auto patterns = all_points(1, 1);
+    EXPECT_FALSE(simulate(f, patterns));
+
+    // Patterns of different lengths
+    patterns.insert({xs[1], vector<uint64_t>(2)});
+    EXPECT_FALSE(simulate(f, patterns));
+
+    // An unknown constant
+    EXPECT_FALSE(simulate(f | _log, all_points(2, 1)));
+}
+
+TEST_F(SimulateTest, SharedNodes) {
+    auto g = xs[0] ^ xs[1];
+    auto f = (g & xs[2]) | (g & ~xs[2]);
+    auto words = *simulate(f, all_points(3, 1));
+    EXPECT_EQ(words[0], (*simulate(g, all_points(3, 1)))[0]);
+    EXPECT_EQ(words[0], 0x6666666666666666u);
+}
+
+TEST_F(SimulateTest, FastPath) {
+    // Simulation finds points for easy functions, and SAT does the rest
+    vector<bx_t> fs = {
+        or_({xs[0], xs[1], xs[2]}),
+        and_({xs[0], ~xs[1], xs[2], ~xs[3], xs[4], ~xs[5], xs[6], ~xs[7]}),
+        and_({xs[0] ^ xs[1], xs[0], xs[1]}),
+    };
+    for (auto const& f : fs) {
+        auto soln = f->sat();
+        if (soln.first) {
+            EXPECT_TRUE(IS_ONE(f->restrict_(*soln.second)->simplify()));
+        } else {
+            EXPECT_FALSE(f->sat(SatOptions()).first);
+        }
+        auto limited = f->sat_limited(SatOptions());
+        EXPECT_EQ(limited.first == SatStatus::SAT, soln.first);
+    }
+
+    // Auxiliary variables are projected away
+    auto g = or_({and_({xs[0], xs[1]}), and_({xs[2], xs[3]})})->tseytin(ctx);
+    auto soln = g->sat();
+    ASSERT_TRUE(soln.first);
+    for (auto const& pair : *soln.second) {
+        EXPECT_FALSE(ctx.is_anon(pair.first->id));
+    }
+
+    EXPECT_FALSE((xs[0] | xs[1])->equiv(xs[0] ^ xs[1]));
+    EXPECT_TRUE((xs[0] | xs[1])->equiv(~(~xs[0] & ~xs[1])));
+    EXPECT_FALSE(*(xs[0] & xs[1])->equiv_limited(xs[0], SatOptions()));
+}
@@ -0,0 +1,147 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+class TruthTableTest : public BoolExprTest {
+protected:
+    vector<var_t> vars(size_t n) {
+        return vector<var_t>(xs.begin(), xs.begin() + n);
+    }
+
+    // Check a table against restrict_ at every minterm
+    void check(TruthTable const& tt, bx_t const& f,
+               vector<var_t> const& vs) {
+        for (uint64_t m = 0; m < (uint64_t(1) << vs.size()); ++m) {
+            point_t point;
+            for (size_t i = 0; i < vs.size(); ++i) {
+                if ((m >> i) & 1) {
+                    point.insert({vs[i], _one});
+                } else {
+                    point.insert({vs[i], _zero});
+                }
+            }
+            EXPECT_EQ(tt.get(m), IS_ONE(f->restrict_(point)->simplify()));
+        }
+    }
+};
+
+TEST_F(TruthTableTest, Basic) {
+    for (uint32_t n : {0, 1, 3, 6, 7, 10}) {
+        TruthTable zero(n), one(n, true);
+        EXPECT_TRUE(zero.is_zero());
+        EXPECT_TRUE(one.is_one());
+        EXPECT_EQ(zero.count(), 0u);
+        EXPECT_EQ(one.count(), uint64_t(1) << n);
+        EXPECT_EQ(~zero, one);
+        EXPECT_TRUE(zero < one);
+
+        for (uint32_t i = 0; i < n; ++i) {
+            auto x = TruthTable::var(n, i);
+            EXPECT_EQ(x.count(), uint64_t(1) << (n - 1));
+            EXPECT_EQ(x.support(), vector<uint32_t>{i});
+            EXPECT_TRUE(x.cofactor(i, true).is_one());
+            EXPECT_TRUE(x.cofactor(i, false).is_zero());
+            EXPECT_TRUE((x & ~x).is_zero());
+            EXPECT_TRUE((x | ~x).is_one());
+            EXPECT_TRUE((x ^ x).is_zero());
+        }
+
+        auto tt = zero;
+        tt.set(n ? 1 : 0, true);
+        EXPECT_EQ(tt.count(), 1u);
+        EXPECT_TRUE(tt.get(n ? 1 : 0));
+        tt.set(n ? 1 : 0, false);
+        EXPECT_TRUE(tt.is_zero());
+    }
+}
+
+TEST_F(TruthTableTest, FromExpr) {
+    auto vs = vars(8);
+    vector<bx_t> fs = {
+        _zero,
+        _one,
+        xs[7],
+        ~xs[0],
+        onehot({xs[0], xs[1], xs[2]}),
+        ite(xs[7], xs[0] ^ xs[6], eq({xs[1], xs[2], ~xs[3]})),
+        nimpl(xs[4] | xs[5], xs[6] & ~xs[7]),
+    };
+    for (auto const& f : fs) {
+        check(TruthTable(f, vs), f, vs);
+        check(TruthTable(f, vs).cofactor(0, true),
+              f->restrict_({{xs[0], _one}}), vs);
+        check(TruthTable(f, vs).cofactor(7, false),
+              f->restrict_({{xs[7], _zero}}), vs);
+    }
+}
+
+TEST_F(TruthTableTest, Quantify) {
+    auto vs = vars(8);
+    auto f = ite(xs[7], xs[0] ^ xs[6], eq({xs[1], xs[2], ~xs[3]}));
+    TruthTable tt(f, vs);
+
+    for (uint32_t i : {0, 6, 7}) {
+        vector<var_t> x{xs[i]};
+        auto f0 = f->restrict_({{xs[i], _zero}});
+        auto f1 = f->restrict_({{xs[i], _one}});
+        check(tt.exists(i), f0 | f1, vs);
+        check(tt.forall(i), f0 & f1, vs);
+        check(tt.difference(i), f0 ^ f1, vs);
+        EXPECT_TRUE(tt.depends_on(i));
+    }
+    EXPECT_FALSE(tt.depends_on(4));
+    EXPECT_EQ(tt.support(), (vector<uint32_t>{0, 1, 2, 3, 6, 7}));
+}
+
+TEST_F(TruthTableTest, ToExpr) {
+    auto vs = vars(8);
+    vector<bx_t> fs = {
+        _zero,
+        _one,
+        xs[3],
+        onehot({xs[0], xs[1], xs[2], xs[3]}),
+        xor_({xs[0], xs[1], xs[7]}),
+        ite(xs[7], xs[0] ^ xs[6], eq({xs[1], xs[2], ~xs[3]})),
+    };
+    for (auto const& f : fs) {
+        TruthTable tt(f, vs);
+        auto g = tt.to_bx(vs);
+        EXPECT_TRUE(g->is_dnf() || IS_CONST(g) || IS_LIT(g));
+        EXPECT_EQ(TruthTable(g, vs), tt);
+    }
+}
+
+TEST_F(TruthTableTest, Reductions) {
+    auto f = ite(xs[0], xs[1] ^ xs[2], xs[3] & xs[1]);
+    vector<var_t> x{xs[0], xs[2]};
+
+    auto sm = or_s(vector<bx_t>(cf_iter(f, x), cf_iter()));
+    auto co = and_s(vector<bx_t>(cf_iter(f, x), cf_iter()));
+    auto de = xor_s(vector<bx_t>(cf_iter(f, x), cf_iter()));
+
+    auto vs = vars(4);
+    EXPECT_EQ(TruthTable(f->smoothing(x), vs), TruthTable(sm, vs));
+    EXPECT_EQ(TruthTable(f->consensus(x), vs), TruthTable(co, vs));
+    EXPECT_EQ(TruthTable(f->derivative(x), vs), TruthTable(de, vs));
+
+    // A variable outside the support
+    EXPECT_TRUE(IS_ZERO(f->derivative({xs[5]})));
+    EXPECT_TRUE(f->smoothing({xs[5]})->equiv(f));
+
+    EXPECT_TRUE((xs[0] | xs[1])->equiv(~(~xs[0] & ~xs[1])));
+    EXPECT_FALSE((xs[0] | xs[1])->equiv(xs[0] ^ xs[1]));
+}
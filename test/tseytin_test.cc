@@ -72,3 +72,29 @@ TEST_F(TseytinTest, CNF) {
     EXPECT_TRUE(y0->is_cnf());
     EXPECT_EQ(y0->size(), y1->size());
 }
+
+TEST_F(TseytinTest, AnonVars) {
+    auto ctx = Context();
+
+    auto y0 = xor_s({and_s({xs[0], xs[1]}), or_s({xs[2], xs[3]})});
+    auto y1 = y0->tseytin(ctx);
+
+    // Auxiliary variables are not registered by name
+    for (auto const &x : y1->support()) {
+        if (x->ctx == &ctx) {
+            EXPECT_TRUE(ctx.is_anon(x->id));
+            EXPECT_EQ(x->to_string().substr(0, 2), "a_");
+        }
+    }
+
+    auto a0 = ctx.get_var("a_0");
+    EXPECT_FALSE(ctx.is_anon(a0->id));
+    EXPECT_EQ(y1->support().count(a0), 0u);
+
+    // Numbering continues across calls with the same prefix
+    auto y2 = y0->tseytin(ctx);
+    EXPECT_EQ(y1->support().size(), y2->support().size());
+    EXPECT_EQ(ctx.get_anon_var()->to_string(), "a_6");
+    EXPECT_EQ(ctx.get_anon_var("b")->to_string(), "b_0");
+    EXPECT_EQ(ctx.get_anon_var()->to_string(), "a_7");
+}
@@ -0,0 +1,153 @@
+// Copyright 2016 Chris Drake
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include "boolexpr/boolexpr.h"
+#include "boolexprtest.h"
+
+using boost::multiprecision::cpp_int;
+
+class ZddTest : public BoolExprTest {};
+
+TEST_F(ZddTest, SetOperations) {
+    ZddManager mgr(ctx);
+
+    auto a = mgr.cube({xs[0], xs[1]});
+    auto b = mgr.cube({xs[1], ~xs[2]});
+    auto c = mgr.cube({xs[2]});
+
+    EXPECT_TRUE(mgr.empty().is_empty());
+    EXPECT_TRUE(mgr.base().is_base());
+    EXPECT_TRUE(mgr.cube({}).is_base());
+    EXPECT_TRUE(mgr.cube({xs[0], ~xs[0]}).is_empty());
+    EXPECT_EQ(mgr.cube({xs[1], xs[0], xs[1]}), a);
+
+    auto ab = a | b;
+    EXPECT_EQ(mgr.count(ab), 2);
+    EXPECT_EQ(ab | a, ab);
+    EXPECT_EQ(ab & b, b);
+    EXPECT_EQ(ab - a, b);
+    EXPECT_TRUE((a & b).is_empty());
+    EXPECT_EQ(ab | mgr.empty(), ab);
+    EXPECT_EQ(mgr.count(ab | mgr.base()), 3);
+
+    // (x0 x1 + x1 ~x2) * x2 = x0 x1 x2
+    EXPECT_EQ(ab * c, mgr.cube({xs[0], xs[1], xs[2]}));
+    EXPECT_EQ(ab * mgr.base(), ab);
+    EXPECT_TRUE((ab * mgr.empty()).is_empty());
+    EXPECT_EQ(mgr.size(a), 2u);
+}
+
+TEST_F(ZddTest, Minimal) {
+    ZddManager mgr(ctx);
+
+    auto f = mgr.cube({xs[0]}) | mgr.cube({xs[0], xs[1]}) |
+             mgr.cube({xs[1], ~xs[2]}) | mgr.cube({xs[1], ~xs[2], xs[3]}) |
+             mgr.cube({~xs[0], xs[3]});
+    auto g = mgr.cube({xs[0]}) | mgr.cube({xs[1], ~xs[2]}) |
+             mgr.cube({~xs[0], xs[3]});
+    EXPECT_EQ(mgr.minimal(f), g);
+    EXPECT_EQ(mgr.minimal(f | mgr.base()), mgr.base());
+}
+
+TEST_F(ZddTest, TwoLevel) {
+    ZddManager zdd(ctx);
+    BddManager bdd(ctx);
+
+    vector<bx_t> fs = {
+        _zero,
+        _one,
+        ~xs[3],
+        or_({xs[0], and_({xs[1], ~xs[2]}), xor_({xs[3], xs[4]})}),
+        xnor({xs[0], xs[1], xs[2], xs[3]}),
+        eq({xs[0], xs[1], xs[2]}),
+        impl(xs[0], xs[1]),
+        ite(xs[0], and_({xs[1], xs[2]}), or_({xs[3], xs[4]})),
+    };
+
+    for (auto const &f : fs) {
+        auto d = zdd.dnf(f);
+        auto c = zdd.cnf(f);
+        EXPECT_TRUE(zdd.to_dnf(d)->equiv(f));
+        EXPECT_TRUE(zdd.to_cnf(c)->equiv(f));
+        EXPECT_EQ(zdd.to_bdd(d, bdd), bdd.to_bdd(f));
+        EXPECT_EQ(zdd.minimal(d), d);
+    }
+
+    // The DNF of (x0 | x1) & (x2 | x3) & ... & (x78 | x79) has 2^40 cubes
+    vector<bx_t> clauses;
+    for (size_t i = 0; i < 40; ++i) {
+        clauses.push_back(or_({xs[2 * i], xs[2 * i + 1]}));
+    }
+    auto d = zdd.dnf(and_(clauses));
+    EXPECT_EQ(zdd.count(d), cpp_int(1) << 40);
+    EXPECT_EQ(zdd.size(d), 80u);
+    EXPECT_EQ(zdd.count(zdd.cnf(and_(clauses))), 40);
+}
+
+TEST_F(ZddTest, Isop) {
+    ZddManager zdd(ctx);
+    BddManager bdd(ctx);
+
+    vector<bx_t> fs = {
+        or_({xs[0], and_({xs[1], ~xs[2]}), xor_({xs[3], xs[4]})}),
+        xnor({xs[0], xs[1], xs[2], xs[3]}),
+        ite(xs[0], and_({xs[1], xs[2]}), or_({xs[3], xs[4]})),
+        or_({and_({xs[0], xs[1]}), and_({~xs[0], xs[2]}),
+             and_({xs[1], xs[2]})}),
+    };
+
+    for (auto const &f : fs) {
+        auto b = bdd.to_bdd(f);
+        auto cover = zdd.isop(b);
+        EXPECT_EQ(zdd.to_bdd(cover, bdd), b);
+
+        // Irredundant: every cube is needed
+        auto dnf = zdd.to_dnf(cover);
+        auto op = std::static_pointer_cast<Operator const>(dnf);
+        for (size_t i = 0; i < op->args.size(); ++i) {
+            vector<bx_t> rest;
+            for (size_t j = 0; j < op->args.size(); ++j) {
+                if (j != i) {
+                    rest.push_back(op->args[j]);
+                }
+            }
+            EXPECT_FALSE(or_(rest)->equiv(f));
+        }
+    }
+
+    // The consensus term x1 x2 is redundant
+    EXPECT_EQ(zdd.count(zdd.isop(bdd.to_bdd(fs[3]))), 2);
+
+    // Anything from x0 x1 to x0 | x1 may come back
+    auto lower = bdd.to_bdd(and_({xs[0], xs[1]}));
+    auto upper = bdd.to_bdd(or_({xs[0], xs[1]}));
+    auto g = zdd.to_bdd(zdd.isop(lower, upper), bdd);
+    EXPECT_TRUE((lower & ~g).is_zero());
+    EXPECT_TRUE((g & ~upper).is_zero());
+    EXPECT_EQ(zdd.count(zdd.isop(lower, upper)), 1);
+}
+
+TEST_F(ZddTest, GarbageCollection) {
+    ZddManager mgr(ctx);
+
+    auto f = mgr.cube({xs[0], xs[1]}) | mgr.cube({xs[2]});
+    auto n = mgr.nodes();
+    mgr.cube({xs[3], xs[4], xs[5]});
+    EXPECT_GT(mgr.nodes(), n);
+
+    mgr.gc();
+    EXPECT_EQ(mgr.nodes(), mgr.size(f));
+    EXPECT_EQ(mgr.count(f), 2);
+}